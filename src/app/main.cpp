@@ -113,6 +113,14 @@ backend::CliArgs handle_cli_args(QGuiApplication& app)
         QStringLiteral("silent"),
         CMDMSG("Do not print log messages to the terminal"));
 
+    const QCommandLineOption arg_log_level(
+        QStringLiteral("log-level"),
+        CMDMSG("Only log messages of at least this level (info, warning or error). "
+               "Can be a comma separated list, where entries of the form `tag=level` "
+               "set the level of a single category, eg. `warning,Pegasus=info`."),
+        QStringLiteral("rules"));
+    argparser.addOption(arg_log_level);
+
     const QCommandLineOption arg_menu_reboot = add_cli_option(argparser,
         QStringLiteral("disable-menu-reboot"),
         CMDMSG("Hides the system reboot entry in the main menu"));
@@ -145,6 +153,12 @@ backend::CliArgs handle_cli_args(QGuiApplication& app)
                "to work perfectly with some platforms and devices (eg. arcades), in which case "
                "you can disable this feature here."));
 
+    const QCommandLineOption arg_input_latency = add_cli_option(argparser,
+        QStringLiteral("measure-input-latency"),
+        CMDMSG("Periodically logs the time it takes for gamepad events to reach the UI thread, "
+               "counted from when SDL has received them, with millisecond precision "
+               "(SDL2 gamepad support only)"));
+
     argparser.addHelpOption();
     argparser.addVersionOption();
     argparser.process(app); // may quit!
@@ -152,9 +166,11 @@ backend::CliArgs handle_cli_args(QGuiApplication& app)
     backend::CliArgs args;
     args.portable = argparser.isSet(arg_portable);
     args.silent = argparser.isSet(arg_silent);
+    args.log_filter = argparser.value(arg_log_level);
     args.enable_menu_appclose = !(argparser.isSet(arg_menu_kiosk) || argparser.isSet(arg_menu_appclose));
     args.enable_menu_settings = !(argparser.isSet(arg_menu_kiosk) || argparser.isSet(arg_menu_settings));
     args.enable_gamepad_autoconfig = !argparser.isSet(arg_gamepad_autoconfig);
+    args.measure_input_latency = argparser.isSet(arg_input_latency);
 #ifdef Q_OS_ANDROID
     args.enable_menu_shutdown = false;
     args.enable_menu_reboot = false;
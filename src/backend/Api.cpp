@@ -18,6 +18,7 @@
 #include "Api.h"
 
 #include "Log.h"
+#include "model/gaming/GameEvents.h"
 #include "model/gaming/GameFile.h"
 
 
@@ -25,9 +26,11 @@ ApiObject::ApiObject(const backend::CliArgs& args, QObject* parent)
     : QObject(parent)
     , m_internal(args)
     , m_collections(new QQmlObjectListModel<model::Collection>(this))
-    , m_allGames(new QQmlObjectListModel<model::Game>(this))
+    , m_allGames(new model::GameListModel(this))
     , m_launch_game_file(nullptr)
     , m_providerman(this)
+    , m_blurhash_gen(this)
+    , m_rom_prewarmer(this)
 {
     connect(&m_memory, &model::Memory::dataChanged,
             this, &ApiObject::memoryChanged);
@@ -48,6 +51,14 @@ ApiObject::ApiObject(const backend::CliArgs& args, QObject* parent)
     connect(&m_providerman, &ProviderManager::finished,
             this, &ApiObject::onSearchFinished);
 
+    const model::GameEvents& game_events = model::GameEvents::instance();
+    connect(&game_events, &model::GameEvents::fileSelectorRequested,
+            this, &ApiObject::onGameFileSelectorRequested);
+    connect(&game_events, &model::GameEvents::launchRequested,
+            this, &ApiObject::onGameFileLaunchRequested);
+    connect(&game_events, &model::GameEvents::favoriteChanged,
+            this, &ApiObject::onGameFavoriteChanged);
+
     onThemeChanged();
 }
 
@@ -56,29 +67,34 @@ void ApiObject::startScanning()
     m_internal.meta().startLoading();
     emit eventLoadingStarted();
 
+    m_blurhash_gen.cancel();
+    m_rom_prewarmer.cancel();
     m_collections->clear();
     m_allGames->clear();
 
     m_providerman.run(m_providerman_collections, m_providerman_games);
 }
 
+model::GameSearchModel* ApiObject::searchGames(const QString& query) const
+{
+    auto* const results = new model::GameSearchModel();
+    results->setSourceModel(m_allGames);
+    results->setQuery(query);
+    return results;
+}
+
+void ApiObject::prewarmGame(model::Game* game)
+{
+    m_rom_prewarmer.focus(game);
+}
+
 void ApiObject::onSearchFinished()
 {
-    for (model::Game* const game : qAsConst(m_providerman_games)) {
-        connect(game, &model::Game::launchFileSelectorRequested,
-                this, &ApiObject::onGameFileSelectorRequested);
-        connect(game, &model::Game::favoriteChanged,
-                this, &ApiObject::onGameFavoriteChanged);
-
-        for (model::GameFile* const gamefile : game->filesConst()) {
-            connect(gamefile, &model::GameFile::launchRequested,
-                    this, &ApiObject::onGameFileLaunchRequested);
-        }
-    }
-
-    QVector<model::Game*> game_vec;
-    std::swap(m_providerman_games, game_vec);
-    m_allGames->append(std::move(game_vec));
+    std::shared_ptr<model::GameStore> game_store;
+    std::swap(m_providerman_games, game_store);
+    if (game_store)
+        m_allGames->append(game_store, m_providerman.searchIndex(), m_providerman.facetIndex());
+    m_blurhash_gen.start(m_allGames->rowRefs());
 
     QVector<model::Collection*> coll_vec;
     std::swap(m_providerman_collections, coll_vec);
@@ -88,18 +104,18 @@ void ApiObject::onSearchFinished()
     Log::info(LOGMSG("%1 games found").arg(m_allGames->count()));
 }
 
-void ApiObject::onGameFileSelectorRequested()
+void ApiObject::onGameFileSelectorRequested(model::Game* game)
 {
-    auto game = static_cast<model::Game*>(QObject::sender());
     emit eventSelectGameFile(game);
 }
 
-void ApiObject::onGameFileLaunchRequested()
+void ApiObject::onGameFileLaunchRequested(model::GameFile* gamefile)
 {
     if (m_launch_game_file)
         return;
 
-    m_launch_game_file = static_cast<model::GameFile*>(QObject::sender());
+    m_launch_game_file = gamefile;
+    m_rom_prewarmer.onLaunchRequested(m_launch_game_file);
     emit launchGameFile(m_launch_game_file);
 }
 
@@ -125,9 +141,9 @@ void ApiObject::onGameFinished()
     m_launch_game_file = nullptr;
 }
 
-void ApiObject::onGameFavoriteChanged()
+void ApiObject::onGameFavoriteChanged(model::Game* game)
 {
-    m_providerman.onGameFavoriteChanged(m_allGames->asList());
+    m_providerman.onGameFavoriteChanged(game);
 }
 
 void ApiObject::onThemeChanged()
@@ -18,8 +18,12 @@
 #pragma once
 
 #include "CliArgs.h"
+#include "RomPrewarmer.h"
+#include "imggen/BlurhashGenerator.h"
 #include "model/gaming/Collection.h"
 #include "model/gaming/Game.h"
+#include "model/gaming/GameListModel.h"
+#include "model/gaming/GameSearchModel.h"
 #include "model/internal/Internal.h"
 #include "model/keys/Keys.h"
 #include "model/memory/Memory.h"
@@ -41,7 +45,9 @@ class ApiObject : public QObject {
     QML_CONST_PROPERTY(model::Keys, keys)
     QML_READONLY_PROPERTY(model::Memory, memory)
     QML_OBJMODEL_PROPERTY(model::Collection, collections)
-    QML_OBJMODEL_PROPERTY(model::Game, allGames)
+    Q_PROPERTY(model::GameListModel* allGames READ allGames CONSTANT)
+    model::GameListModel* const m_allGames;
+    model::GameListModel* allGames() const { return m_allGames; }
 
     // retranslate on locale change
     Q_PROPERTY(QString tr READ emptyString NOTIFY localeChanged)
@@ -52,6 +58,12 @@ public:
     // scanning
     void startScanning();
 
+    // full text search in all games; the returned model is owned by the caller
+    Q_INVOKABLE model::GameSearchModel* searchGames(const QString& query) const;
+
+    // reads ahead the files of the focused game, if enabled in the settings; null cancels it
+    Q_INVOKABLE void prewarmGame(model::Game* game);
+
 signals:
     void launchGameFile(const model::GameFile*);
     void launchFailed(QString);
@@ -74,9 +86,9 @@ public slots:
 private slots:
     // internal communication
     void onSearchFinished();
-    void onGameFavoriteChanged();
-    void onGameFileSelectorRequested();
-    void onGameFileLaunchRequested();
+    void onGameFavoriteChanged(model::Game*);
+    void onGameFileSelectorRequested(model::Game*);
+    void onGameFileLaunchRequested(model::GameFile*);
     void onThemeChanged();
 
 private:
@@ -85,8 +97,10 @@ private:
 
     // initialization
     QVector<model::Collection*> m_providerman_collections; // TODO: std::vector
-    QVector<model::Game*> m_providerman_games;
+    std::shared_ptr<model::GameStore> m_providerman_games;
     ProviderManager m_providerman;
+    BlurhashGenerator m_blurhash_gen;
+    RomPrewarmer m_rom_prewarmer;
 
     // used to trigger re-rendering of texts on locale change
     QString emptyString() const { return QString(); }
@@ -142,6 +142,11 @@ General::General()
     , portable(false)
     , fullscreen(true)
     , mouse_support(true)
+    , lazy_assets(false)
+    , keep_frontend_loaded(false)
+    , parallel_scripts(false)
+    , script_timeout_secs(30)
+    , rom_prewarm_mb(0)
     , locale() // intentionally blank
     , theme(DEFAULT_THEME)
 {}
@@ -199,8 +204,9 @@ void AppSettings::save_config()
 {
     appsettings::SaveContext().save();
 
-    ScriptRunner::run(ScriptEvent::CONFIG_CHANGED);
-    ScriptRunner::run(ScriptEvent::SETTINGS_CHANGED);
+    // in the background; the events are run in order
+    ScriptRunner::runAsync(ScriptEvent::CONFIG_CHANGED);
+    ScriptRunner::runAsync(ScriptEvent::SETTINGS_CHANGED);
 }
 
 void AppSettings::load_providers()
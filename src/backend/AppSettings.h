@@ -41,6 +41,11 @@ struct General {
     bool portable;
     bool fullscreen;
     bool mouse_support;
+    bool lazy_assets;
+    bool keep_frontend_loaded;
+    bool parallel_scripts;
+    int script_timeout_secs;
+    int rom_prewarm_mb;
     QString locale;
     QString theme;
 
@@ -25,11 +25,17 @@
 #include "ScriptRunner.h"
 #include "platform/PowerCommands.h"
 #include "types/AppCloseType.h"
+#include "utils/MemoryUsage.h"
 
 // For type registration
 #include "model/keys/Key.h"
+#include "model/gaming/AssetPrefetcher.h"
 #include "model/gaming/Assets.h"
+#include "model/gaming/GameFacetModel.h"
 #include "model/gaming/GameFile.h"
+#include "model/gaming/GameFilterModel.h"
+#include "model/gaming/GameListModel.h"
+#include "model/gaming/GameSearchModel.h"
 #include "utils/FolderListModel.h"
 #include "QtQmlTricks/QQmlObjectListModel.h"
 #include "SortFilterProxyModel/qqmlsortfilterproxymodel.h"
@@ -68,6 +74,11 @@ void register_api_classes()
     qmlRegisterUncreatableType<model::Collection>(API_URI, 0, 7, "Collection", error_msg);
     qmlRegisterUncreatableType<model::Game>(API_URI, 0, 2, "Game", error_msg);
     qmlRegisterUncreatableType<model::Assets>(API_URI, 0, 2, "GameAssets", error_msg);
+    qmlRegisterUncreatableType<model::GameListModel>(API_URI, 0, 12, "GameListModel", error_msg);
+    qmlRegisterType<model::AssetPrefetcher>(API_URI, 0, 12, "AssetPrefetcher");
+    qmlRegisterType<model::GameFacetModel>(API_URI, 0, 12, "GameFacetModel");
+    qmlRegisterType<model::GameFilterModel>(API_URI, 0, 12, "GameFilterModel");
+    qmlRegisterType<model::GameSearchModel>(API_URI, 0, 12, "GameSearchModel");
     qmlRegisterUncreatableType<model::Locales>(API_URI, 0, 11, "Locales", error_msg);
     qmlRegisterUncreatableType<model::Themes>(API_URI, 0, 11, "Themes", error_msg);
     qmlRegisterUncreatableType<model::Providers>(API_URI, 0, 11, "Providers", error_msg);
@@ -87,6 +98,21 @@ void register_api_classes()
     qqsfpm::registerQQmlSortFilterProxyModelTypes();
 }
 
+void release_memory(FrontendLayer& frontend)
+{
+    const qint64 rss_before = utils::resident_memory_size();
+
+    frontend.releaseCaches();
+    utils::trim_heap();
+
+    const qint64 rss_after = utils::resident_memory_size();
+    if (rss_before >= 0 && rss_after >= 0) {
+        Log::info(LOGMSG("Released %1 MiB of memory before running the game (%2 MiB in use)")
+            .arg(QString::number((rss_before - rss_after) / (1024.0 * 1024.0), 'f', 1),
+                 QString::number(rss_after / (1024 * 1024))));
+    }
+}
+
 void on_app_close(AppCloseType type)
 {
     ScriptRunner::run(ScriptEvent::QUIT);
@@ -136,6 +162,7 @@ Backend::Backend(const CliArgs& args)
     AppSettings::general.portable = args.portable;
 
     Log::init(args.silent);
+    Log::setFilter(args.log_filter);
     print_metainfo();
     register_api_classes();
 
@@ -165,6 +192,14 @@ Backend::Backend(const CliArgs& args)
     QObject::connect(m_launcher, &ProcessLauncher::processLaunchOk,
                      m_frontend, &FrontendLayer::teardown);
 
+    // the theme settings changed during the teardown are saved before the game starts
+    QObject::connect(m_frontend, &FrontendLayer::teardownComplete,
+                     m_api, [this]{ m_api->memory().flush(); });
+
+    // the caches are not needed while the game is running
+    QObject::connect(m_frontend, &FrontendLayer::teardownComplete,
+                     m_frontend, [this]{ release_memory(*m_frontend); });
+
     QObject::connect(m_frontend, &FrontendLayer::teardownComplete,
                      m_launcher, &ProcessLauncher::onTeardownComplete);
 
@@ -181,6 +216,8 @@ Backend::Backend(const CliArgs& args)
                      m_frontend, &FrontendLayer::clearCache);
 
     // quit/reboot/shutdown request
+    QObject::connect(&m_api->internal().system(), &model::System::appCloseRequested,
+                     m_api, [this]{ m_api->memory().flush(); });
     QObject::connect(&m_api->internal().system(), &model::System::appCloseRequested, on_app_close);
 }
 
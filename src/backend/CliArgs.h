@@ -17,14 +17,18 @@
 
 #pragma once
 
+#include <QString>
+
 namespace backend {
 struct CliArgs {
     bool portable = false;
     bool silent = false;
+    QString log_filter;
     bool enable_menu_appclose = true;
     bool enable_menu_shutdown = true;
     bool enable_menu_reboot = true;
     bool enable_menu_settings = true;
     bool enable_gamepad_autoconfig = true;
+    bool measure_input_latency = false;
 };
 } // namespace backend
@@ -17,19 +17,28 @@
 
 #include "FrontendLayer.h"
 
+#include "AppSettings.h"
+#include "Log.h"
 #include "Paths.h"
 #include "imggen/BlurhashProvider.h"
+#include "imggen/ThumbnailCache.h"
+#include "imggen/ThumbnailProvider.h"
 #include "utils/DiskCachedNAM.h"
 
 #ifdef Q_OS_ANDROID
 #include "platform/AndroidAppIconProvider.h"
 #endif
 
+#include <QNetworkAccessManager>
+#include <QPixmapCache>
 #include <QQmlContext>
 #include <QQmlNetworkAccessManagerFactory>
+#include <QQuickWindow>
+#include <QtConcurrent/QtConcurrent>
 
 
 namespace {
+constexpr qint64 THUMBNAIL_DISK_CACHE_MAX_BYTES = 512 * 1024 * 1024;
 
 class DiskCachedNAMFactory : public QQmlNetworkAccessManagerFactory {
 public:
@@ -48,12 +57,27 @@ FrontendLayer::FrontendLayer(QObject* const api, QObject* parent)
     : QObject(parent)
     , m_api(api)
     , m_engine(nullptr)
+    , m_suspended(false)
+    , m_thumbnails(std::make_shared<ThumbnailCache>(paths::writableCacheDir() + QLatin1String("/thumbnails")))
 {
     // Note: the pointer to the Api is non-owning and constant during the runtime
+
+    const std::shared_ptr<ThumbnailCache> thumbnails = m_thumbnails;
+    m_prune_future = QtConcurrent::run([thumbnails]{ thumbnails->prune_disk(THUMBNAIL_DISK_CACHE_MAX_BYTES); });
+}
+
+FrontendLayer::~FrontendLayer()
+{
+    m_prune_future.waitForFinished();
 }
 
 void FrontendLayer::rebuild()
 {
+    if (m_suspended) {
+        resume();
+        return;
+    }
+
     Q_ASSERT(!m_engine);
 
     m_engine = new QQmlApplicationEngine(this);
@@ -62,6 +86,7 @@ void FrontendLayer::rebuild()
     m_engine->setNetworkAccessManagerFactory(new DiskCachedNAMFactory);
 
     m_engine->addImageProvider(QStringLiteral("blurhash"), new BlurhashProvider);
+    m_engine->addImageProvider(QStringLiteral("thumb"), new ThumbnailProvider(m_thumbnails));
 #ifdef Q_OS_ANDROID
     m_engine->addImageProvider(QStringLiteral("androidicons"), new AndroidAppIconProvider);
 #endif
@@ -75,6 +100,12 @@ void FrontendLayer::rebuild()
 void FrontendLayer::teardown()
 {
     Q_ASSERT(m_engine);
+    Q_ASSERT(!m_suspended);
+
+    if (AppSettings::general.keep_frontend_loaded) {
+        suspend();
+        return;
+    }
 
     // signal forwarding
     connect(m_engine, &QQmlApplicationEngine::destroyed,
@@ -84,8 +115,73 @@ void FrontendLayer::teardown()
     m_engine = nullptr;
 }
 
+void FrontendLayer::suspend()
+{
+    Q_ASSERT(m_engine);
+    Q_ASSERT(m_hidden_windows.isEmpty());
+
+    for (QObject* const root : m_engine->rootObjects()) {
+        QQuickWindow* const window = qobject_cast<QQuickWindow*>(root);
+        if (!window)
+            continue;
+
+        // allow the scene graph and the graphics context to go away while hidden
+        window->setPersistentSceneGraph(false);
+        window->setPersistentOpenGLContext(false);
+
+        m_hidden_windows.append({ window, window->visibility() });
+        window->hide();
+        window->releaseResources();
+    }
+
+    m_engine->collectGarbage();
+    m_suspended = true;
+    Log::info(LOGMSG("Frontend suspended"));
+
+    // like the destruction of the engine, this completes asynchronously
+    QMetaObject::invokeMethod(this, [this]{ emit teardownComplete(); }, Qt::QueuedConnection);
+}
+
+void FrontendLayer::resume()
+{
+    Q_ASSERT(m_engine);
+
+    for (const HiddenWindow& entry : m_hidden_windows) {
+        if (!entry.window)
+            continue;
+
+        entry.window->setPersistentSceneGraph(true);
+        entry.window->setPersistentOpenGLContext(true);
+        entry.window->setVisibility(entry.visibility);
+        entry.window->requestActivate();
+    }
+
+    m_hidden_windows.clear();
+    m_suspended = false;
+    Log::info(LOGMSG("Frontend resumed"));
+
+    emit rebuildComplete();
+}
+
 void FrontendLayer::clearCache()
 {
     Q_ASSERT(m_engine);
     m_engine->clearComponentCache();
 }
+
+void FrontendLayer::releaseCaches()
+{
+    m_thumbnails->clear_memory();
+    QPixmapCache::clear();
+
+    // when the engine is suspended, its providers and connections are still around
+    if (m_engine) {
+        QQmlImageProviderBase* const blurhash = m_engine->imageProvider(QStringLiteral("blurhash"));
+        if (blurhash)
+            static_cast<BlurhashProvider*>(blurhash)->clearCache();
+
+        QNetworkAccessManager* const nam = m_engine->networkAccessManager();
+        if (nam)
+            nam->clearAccessCache();
+    }
+}
@@ -17,8 +17,16 @@
 
 #pragma once
 
+#include <QFuture>
 #include <QObject>
+#include <QPointer>
 #include <QQmlApplicationEngine>
+#include <QVector>
+#include <QWindow>
+#include <memory>
+
+class QQuickWindow;
+class ThumbnailCache;
 
 
 /// Manages the dynamic reload of the frontend layer
@@ -28,6 +36,11 @@
 /// When it's done, the relevant signal will be triggered. After the actual
 /// execution is finished, the frontend layer can be rebuilt again.
 ///
+/// Alternatively, if `keep-frontend-loaded` is set, the engine is kept alive
+/// during the game: the windows are hidden and their graphics resources are
+/// released, but the QML components, the theme state and the models remain,
+/// so returning from the game is quick.
+///
 /// Some funtions require a pointer to the API object, to connect and make
 /// it accessible to the frontend.
 class FrontendLayer : public QObject {
@@ -35,17 +48,34 @@ class FrontendLayer : public QObject {
 
 public:
     explicit FrontendLayer(QObject* const api, QObject* parent = nullptr);
+    ~FrontendLayer();
 
     void rebuild();
     void teardown();
 
     void clearCache();
+    /// Drops the image caches and idle network connections, eg. while a game is running
+    void releaseCaches();
 
 signals:
     void rebuildComplete();
     void teardownComplete();
 
 private:
+    struct HiddenWindow {
+        QPointer<QQuickWindow> window;
+        QWindow::Visibility visibility;
+    };
+
     QObject* const m_api;
     QQmlApplicationEngine* m_engine;
+    QVector<HiddenWindow> m_hidden_windows;
+    bool m_suspended;
+
+    // shared by the image providers of the engines, so it survives the rebuilds
+    const std::shared_ptr<ThumbnailCache> m_thumbnails;
+    QFuture<void> m_prune_future;
+
+    void suspend();
+    void resume();
 };
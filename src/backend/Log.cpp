@@ -19,11 +19,22 @@
 
 #include "AppSettings.h"
 #include "Paths.h"
+#include "utils/HashMap.h"
+#include "utils/MpscRingBuffer.h"
 
 #include <QDateTime>
 #include <QDebug>
 #include <QFile>
+#include <QStringList>
 #include <QTextStream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #if defined(Q_OS_ANDROID) && defined(QT_DEBUG)
 #include <android/log.h>
@@ -38,13 +49,13 @@ namespace logsinks {
 
 class QtLog : public LogSink {
 public:
-    void info(const QString& msg) override {
+    void info(qint64, const QString& msg) override {
         qInfo().noquote().nospace() << msg;
     }
-    void warning(const QString& msg) override {
+    void warning(qint64, const QString& msg) override {
         qWarning().noquote().nospace() << msg;
     }
-    void error(const QString& msg) override {
+    void error(qint64, const QString& msg) override {
         qWarning().noquote().nospace() << msg;
     }
 };
@@ -56,15 +67,18 @@ public:
         : m_stream(stdout)
     {}
 
-    void info(const QString& msg) override {
+    void info(qint64, const QString& msg) override {
         colorlog(m_pre_info, msg);
     }
-    void warning(const QString& msg) override {
+    void warning(qint64, const QString& msg) override {
         colorlog(m_pre_warning, msg);
     }
-    void error(const QString& msg) override {
+    void error(qint64, const QString& msg) override {
         colorlog(m_pre_error, msg);
     }
+    void flush() override {
+        m_stream.flush();
+    }
 
 private:
     QTextStream m_stream;
@@ -82,7 +96,7 @@ private:
 #endif
 
     void colorlog(const char* const prefix, const QString& msg) {
-        m_stream << prefix << QChar(' ') << msg << m_fmt_reset << endl;
+        m_stream << prefix << QChar(' ') << msg << m_fmt_reset << QChar('\n');
     }
 };
 
@@ -101,25 +115,27 @@ public:
         m_stream.setDevice(&m_file);
     }
 
-    void info(const QString& msg) override {
+    void info(qint64 time, const QString& msg) override {
         if (Q_UNLIKELY(!m_file.isOpen()))
             return;
 
-        datelog(m_marker_info, msg);
+        datelog(time, m_marker_info, msg);
     }
-    void warning(const QString& msg) override {
+    void warning(qint64 time, const QString& msg) override {
         if (Q_UNLIKELY(!m_file.isOpen()))
             return;
 
-        datelog(m_marker_warning, msg);
-        m_stream.flush();
+        datelog(time, m_marker_warning, msg);
     }
-    void error(const QString& msg) override {
+    void error(qint64 time, const QString& msg) override {
         if (Q_UNLIKELY(!m_file.isOpen()))
             return;
 
-        datelog(m_marker_error, msg);
-        m_stream.flush();
+        datelog(time, m_marker_error, msg);
+    }
+    void flush() override {
+        if (Q_LIKELY(m_file.isOpen()))
+            m_stream.flush();
     }
 
 private:
@@ -134,8 +150,8 @@ private:
         return paths::writableConfigDir() + QLatin1String("/lastrun.log");
     }
 
-    void datelog(const char* const marker, const QString& msg) {
-        m_stream << QDateTime::currentDateTime().toString(Qt::ISODate) << QChar(' ')
+    void datelog(qint64 time, const char* const marker, const QString& msg) {
+        m_stream << QDateTime::fromMSecsSinceEpoch(time).toString(Qt::ISODate) << QChar(' ')
                  << marker << QChar(' ')
                  << msg << QChar('\n');
     }
@@ -146,13 +162,13 @@ class AndroidLogcat : public LogSink {
 public:
     AndroidLogcat() {}
 
-    void info(const QString& msg) override {
+    void info(qint64, const QString& msg) override {
         write_log(ANDROID_LOG_DEBUG, m_marker_info, msg);
     }
-    void warning(const QString& msg) override {
+    void warning(qint64, const QString& msg) override {
         write_log(ANDROID_LOG_WARN, m_marker_warning, msg);
     }
-    void error(const QString& msg) override {
+    void error(qint64, const QString& msg) override {
         write_log(ANDROID_LOG_ERROR, m_marker_error, msg);
     }
 
@@ -172,6 +188,288 @@ private:
 
 
 namespace {
+struct LogEntry {
+    LogLevel level;
+    qint64 time;
+    QString message;
+};
+
+std::vector<std::unique_ptr<LogSink>> g_sinks;
+
+void write_to_sinks(const LogEntry& entry)
+{
+    for (const auto& sink : g_sinks) {
+        switch (entry.level) {
+            case LogLevel::INFO:
+                sink->info(entry.time, entry.message);
+                break;
+            case LogLevel::WARNING:
+                sink->warning(entry.time, entry.message);
+                break;
+            case LogLevel::ERR:
+                sink->error(entry.time, entry.message);
+                break;
+        }
+    }
+}
+
+void flush_sinks()
+{
+    for (const auto& sink : g_sinks)
+        sink->flush();
+}
+
+
+// Lets through the first few warnings of the same kind, then counts the
+// rest, and reports them in one line when they stop coming
+class RepeatedWarningFilter {
+public:
+    void write(const LogEntry& entry)
+    {
+        if (entry.level != LogLevel::WARNING) {
+            write_to_sinks(entry);
+            return;
+        }
+
+        Repeats& repeats = m_repeats[warning_kind(entry.message)];
+        repeats.last_time = entry.time;
+        repeats.count++;
+        if (repeats.count <= MAX_REPEATS) {
+            write_to_sinks(entry);
+            return;
+        }
+
+        repeats.last_message = entry.message;
+    }
+
+    /// Reports the warnings that haven't repeated for a while, or all of them if forced
+    void report_finished(qint64 now, bool force)
+    {
+        for (auto it = m_repeats.begin(); it != m_repeats.end(); ) {
+            const Repeats& repeats = it->second;
+            if (!force && now - repeats.last_time < QUIET_PERIOD_MS) {
+                ++it;
+                continue;
+            }
+
+            const int suppressed = repeats.count - MAX_REPEATS;
+            if (suppressed > 0) {
+                write_to_sinks({
+                    LogLevel::WARNING,
+                    repeats.last_time,
+                    LOGMSG("...and %L1 more similar warnings, the last one was: %2")
+                        .arg(suppressed)
+                        .arg(repeats.last_message),
+                });
+            }
+            it = m_repeats.erase(it);
+        }
+    }
+
+private:
+    static constexpr int MAX_REPEATS = 20;
+    static constexpr qint64 QUIET_PERIOD_MS = 2000;
+
+    struct Repeats {
+        int count = 0;
+        qint64 last_time = 0;
+        QString last_message;
+    };
+    HashMap<QString, Repeats> m_repeats;
+
+    // The message without the parts that usually change between the warnings
+    // of the same kind, ie. quoted strings (paths, names) and numbers
+    static QString warning_kind(const QString& message)
+    {
+        QString out;
+        out.reserve(message.length());
+
+        bool in_quotes = false;
+        for (const QChar ch : message) {
+            if (ch == QChar('`')) {
+                in_quotes = !in_quotes;
+                out.append(ch);
+                continue;
+            }
+            if (!in_quotes && !ch.isDigit())
+                out.append(ch);
+        }
+        return out;
+    }
+};
+
+
+// Passes the messages to the sinks on a background thread
+class AsyncWriter {
+public:
+    AsyncWriter()
+        : m_queue(QUEUE_CAPACITY)
+        , m_running(true)
+        , m_sleeping(false)
+        , m_sync_requested(0)
+        , m_sync_done(0)
+        , m_thread(&AsyncWriter::run, this)
+    {}
+
+    ~AsyncWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_guard);
+            m_running = false;
+        }
+        m_wakeup.notify_one();
+        m_thread.join();
+    }
+
+    void push(LogEntry& entry)
+    {
+        // if the queue is full, wait for the writer to catch up
+        while (!m_queue.try_push(entry)) {
+            wake_up();
+            std::this_thread::yield();
+        }
+
+        if (m_sleeping.load(std::memory_order_acquire))
+            wake_up();
+    }
+
+    /// Waits until the messages pushed so far are written to the sinks and flushed
+    void sync()
+    {
+        // the writer would wait for itself
+        if (std::this_thread::get_id() == m_thread.get_id())
+            return;
+
+        std::unique_lock<std::mutex> lock(m_sleep_guard);
+        const quint64 ticket = ++m_sync_requested;
+        m_wakeup.notify_one();
+        m_synced.wait(lock, [this, ticket]{ return m_sync_done >= ticket; });
+    }
+
+private:
+    static constexpr size_t QUEUE_CAPACITY = 4096;
+    static constexpr std::chrono::milliseconds IDLE_CHECK_INTERVAL { 250 };
+
+    utils::MpscRingBuffer<LogEntry> m_queue;
+    RepeatedWarningFilter m_filter;
+
+    std::mutex m_sleep_guard;
+    std::condition_variable m_wakeup;
+    std::condition_variable m_synced;
+    bool m_running;
+    std::atomic<bool> m_sleeping;
+    quint64 m_sync_requested;
+    quint64 m_sync_done;
+
+    std::thread m_thread;
+
+    void wake_up()
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_guard);
+        m_wakeup.notify_one();
+    }
+
+    quint64 sync_requested()
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_guard);
+        return m_sync_requested;
+    }
+
+    void run()
+    {
+        while (true) {
+            // the messages pushed before this sync request are in the queue already
+            const quint64 sync_ticket = sync_requested();
+
+            LogEntry entry;
+            bool written = false;
+            while (m_queue.try_pop(entry)) {
+                m_filter.write(entry);
+                written = true;
+            }
+
+            m_filter.report_finished(QDateTime::currentMSecsSinceEpoch(), false);
+            if (written || sync_ticket != m_sync_done)
+                flush_sinks();
+
+            std::unique_lock<std::mutex> lock(m_sleep_guard);
+            if (sync_ticket != m_sync_done) {
+                m_sync_done = sync_ticket;
+                m_synced.notify_all();
+            }
+            if (!m_running && m_queue.empty())
+                break;
+
+            m_sleeping.store(true, std::memory_order_release);
+            m_wakeup.wait_for(lock, IDLE_CHECK_INTERVAL,
+                [this]{ return !m_running || !m_queue.empty() || m_sync_requested != m_sync_done; });
+            m_sleeping.store(false, std::memory_order_release);
+        }
+
+        m_filter.report_finished(QDateTime::currentMSecsSinceEpoch(), true);
+        flush_sinks();
+    }
+};
+constexpr std::chrono::milliseconds AsyncWriter::IDLE_CHECK_INTERVAL;
+
+// NOTE: The writer can be used by any thread, while Log::close() destroys it
+//       on the main thread. To avoid using it after that, the threads count
+//       themselves while they use the writer, and close() waits for them.
+std::atomic<AsyncWriter*> g_writer { nullptr };
+std::atomic<int> g_writer_users { 0 };
+std::atomic<bool> g_closed { false };
+
+void log_message(LogLevel level, QString message)
+{
+    LogEntry entry { level, QDateTime::currentMSecsSinceEpoch(), std::move(message) };
+
+    g_writer_users.fetch_add(1);
+    AsyncWriter* const writer = g_writer.load();
+    if (writer) {
+        writer->push(entry);
+        // errors may come right before a crash (eg. the Qt fatal messages),
+        // so these are not kept in the queue
+        if (level == LogLevel::ERR)
+            writer->sync();
+    }
+    g_writer_users.fetch_sub(1);
+
+    // after closing, the sinks may be gone already
+    if (writer || g_closed.load())
+        return;
+
+    write_to_sinks(entry);
+    flush_sinks();
+}
+
+
+struct TagFilter {
+    QString tag;
+    LogLevel level;
+};
+
+LogLevel g_default_level = LogLevel::INFO;
+LogLevel g_lowest_level = LogLevel::INFO;
+std::vector<TagFilter> g_tag_filters;
+
+bool parse_level(const QStringRef& str, LogLevel& out)
+{
+    const QStringRef name = str.trimmed();
+    if (name.compare(QLatin1String("info"), Qt::CaseInsensitive) == 0) {
+        out = LogLevel::INFO;
+        return true;
+    }
+    if (name.compare(QLatin1String("warning"), Qt::CaseInsensitive) == 0) {
+        out = LogLevel::WARNING;
+        return true;
+    }
+    if (name.compare(QLatin1String("error"), Qt::CaseInsensitive) == 0) {
+        out = LogLevel::ERR;
+        return true;
+    }
+    return false;
+}
+
 
 void on_qt_message(QtMsgType type, const QMessageLogContext& context, const QString& msg)
 {
@@ -197,18 +495,19 @@ void on_qt_message(QtMsgType type, const QMessageLogContext& context, const QStr
 } // namespace
 
 
-std::vector<std::unique_ptr<LogSink>> Log::m_sinks {};
-
 void Log::init(bool silent)
 {
     if (!silent) {
-        m_sinks.emplace_back(new logsinks::Terminal());
+        g_sinks.emplace_back(new logsinks::Terminal());
         #if defined(Q_OS_ANDROID) && defined(QT_DEBUG)
-        m_sinks.emplace_back(new logsinks::AndroidLogcat);
+        g_sinks.emplace_back(new logsinks::AndroidLogcat);
         #endif // defined(Q_OS_ANDROID) && defined(QT_DEBUG)
     }
 
-    m_sinks.emplace_back(new logsinks::LogFile());
+    g_sinks.emplace_back(new logsinks::LogFile());
+
+    g_closed.store(false);
+    g_writer.store(new AsyncWriter());
 
     // redirect Qt messages to the Log too
     qInstallMessageHandler(on_qt_message);
@@ -216,26 +515,98 @@ void Log::init(bool silent)
 
 void Log::init_qttest()
 {
-    // QtTests only notice messages made through QDebug
-    m_sinks.emplace_back(new logsinks::QtLog());
+    // QtTests only notice messages made through QDebug, and only during
+    // the test function, so these are written immediately
+    g_sinks.emplace_back(new logsinks::QtLog());
+}
+
+void Log::add_sink(std::unique_ptr<LogSink> sink)
+{
+    Q_ASSERT(sink);
+    g_sinks.push_back(std::move(sink));
 }
 
 void Log::close()
 {
-    m_sinks.clear();
+    // the messages logged from now on are dropped; wait for the threads
+    // still pushing to the writer, then write the remaining messages
+    g_closed.store(true);
+    AsyncWriter* const writer = g_writer.exchange(nullptr);
+    while (g_writer_users.load() > 0)
+        std::this_thread::yield();
+
+    delete writer;
+    g_sinks.clear();
+}
+
+bool Log::setFilter(const QString& rules)
+{
+    LogLevel default_level = LogLevel::INFO;
+    std::vector<TagFilter> tag_filters;
+    QStringList invalid_rules;
+
+    const auto rule_strs = rules.splitRef(QLatin1Char(','), QString::SkipEmptyParts);
+    for (const QStringRef& rule : rule_strs) {
+        LogLevel level = LogLevel::INFO;
+
+        const int sep_idx = rule.indexOf(QLatin1Char('='));
+        if (sep_idx < 0) {
+            if (parse_level(rule, level))
+                default_level = level;
+            else
+                invalid_rules.append(rule.trimmed().toString());
+            continue;
+        }
+
+        const QStringRef tag = rule.left(sep_idx).trimmed();
+        if (tag.isEmpty() || !parse_level(rule.mid(sep_idx + 1), level)) {
+            invalid_rules.append(rule.trimmed().toString());
+            continue;
+        }
+        tag_filters.push_back({ tag.toString(), level });
+    }
+
+    // reported before the new filter is applied, as that
+    // could hide the warnings about its own mistakes
+    for (const QString& rule : qAsConst(invalid_rules))
+        Log::warning(LOGMSG("Invalid log filter rule `%1`, ignored").arg(rule));
+
+    LogLevel lowest_level = default_level;
+    for (const TagFilter& filter : tag_filters)
+        lowest_level = std::min(lowest_level, filter.level);
+
+    g_default_level = default_level;
+    g_lowest_level = lowest_level;
+    g_tag_filters = std::move(tag_filters);
+
+    return invalid_rules.isEmpty();
+}
+
+bool Log::isEnabled(LogLevel level, const QString& tag)
+{
+    if (level < g_lowest_level)
+        return false;
+
+    // there are only a few of these, set by hand
+    for (const TagFilter& filter : g_tag_filters) {
+        if (filter.tag.compare(tag, Qt::CaseInsensitive) == 0)
+            return level >= filter.level;
+    }
+    return level >= g_default_level;
 }
 
-#define FORALLSINK_CALLER(method) \
+#define LOG_CALLER(method, level) \
     void Log::method(const QString& message) \
     { \
-        for (const auto& sink : m_sinks) \
-            sink->method(message); \
+        if (isEnabled(level)) \
+            log_message(level, message); \
     } \
     void Log::method(const QString& tag, const QString& message) \
     { \
-        const QString combi_msg = QStringLiteral("%1: %2").arg(tag, message); \
-        Log::method(combi_msg); \
+        if (isEnabled(level, tag)) \
+            log_message(level, QStringLiteral("%1: %2").arg(tag, message)); \
     }
-FORALLSINK_CALLER(info)
-FORALLSINK_CALLER(warning)
-FORALLSINK_CALLER(error)
+LOG_CALLER(info, LogLevel::INFO)
+LOG_CALLER(warning, LogLevel::WARNING)
+LOG_CALLER(error, LogLevel::ERR)
+#undef LOG_CALLER
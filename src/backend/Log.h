@@ -21,10 +21,34 @@
 
 #include <QString>
 #include <memory>
-#include <vector>
 
 #define LOGMSG(str) QStringLiteral(str)
 
+// Messages below this level are removed at compile time when logged through
+// the LOG_* macros; 0 is info, 1 is warning, 2 is error
+#ifndef PEGASUS_LOG_MIN_LEVEL
+#define PEGASUS_LOG_MIN_LEVEL 0
+#endif
+
+// Logs the message only if its level is enabled for the tag. The message
+// expression is not evaluated otherwise, so formatting in loops costs nothing
+// when the message would be dropped anyway.
+#define LOG_IF_ENABLED(level, method, tag, message) \
+    do { \
+        if (static_cast<int>(level) >= PEGASUS_LOG_MIN_LEVEL && Log::isEnabled(level, tag)) \
+            Log::method(tag, message); \
+    } while (false)
+#define LOG_INFO(tag, message) LOG_IF_ENABLED(LogLevel::INFO, info, tag, message)
+#define LOG_WARNING(tag, message) LOG_IF_ENABLED(LogLevel::WARNING, warning, tag, message)
+#define LOG_ERROR(tag, message) LOG_IF_ENABLED(LogLevel::ERR, error, tag, message)
+
+
+enum class LogLevel : unsigned char {
+    INFO,
+    WARNING,
+    ERR,
+};
+
 
 class LogSink {
 public:
@@ -32,12 +56,25 @@ public:
     virtual ~LogSink();
     NO_COPY_NO_MOVE(LogSink)
 
-    virtual void info(const QString&) = 0;
-    virtual void warning(const QString&) = 0;
-    virtual void error(const QString&) = 0;
+    // the time is when the message was logged, in msecs since epoch
+    virtual void info(qint64 time, const QString&) = 0;
+    virtual void warning(qint64 time, const QString&) = 0;
+    virtual void error(qint64 time, const QString&) = 0;
+    // called after a batch of messages was written
+    virtual void flush() {}
 };
 
 
+/// The application log
+///
+/// After init(), the messages are passed to the sinks on a background thread,
+/// so logging doesn't wait for I/O; errors are an exception, these return
+/// only after they and the earlier messages are written. Repeated warnings
+/// of the same kind are limited, and reported together. close() writes all
+/// pending messages, and the messages logged after it are dropped.
+///
+/// Messages can be filtered by level, both globally and per tag. The filter
+/// should be set before other threads start logging.
 class Log {
 public:
     Log() = delete;
@@ -45,8 +82,17 @@ public:
 
     static void init(bool silent = false);
     static void init_qttest();
+    /// Adds a sink in addition to the ones created by init(),
+    /// eg. for tests; should be called before other threads start logging
+    static void add_sink(std::unique_ptr<LogSink>);
     static void close();
 
+    /// Sets the filter from a comma separated list of rules, each either a level
+    /// (`info`, `warning` or `error`) to use by default, or `tag=level`.
+    /// Returns false if some of the rules were invalid; the rest are still applied.
+    static bool setFilter(const QString& rules);
+    static bool isEnabled(LogLevel level, const QString& tag = QString());
+
     static void info(const QString& message);
     static void warning(const QString& message);
     static void error(const QString& message);
@@ -54,7 +100,4 @@ public:
     static void info(const QString& tag, const QString& message);
     static void warning(const QString& tag, const QString& message);
     static void error(const QString& tag, const QString& message);
-
-private:
-    static std::vector<std::unique_ptr<LogSink>> m_sinks;
 };
@@ -138,4 +138,13 @@ const QStringList& allowed_asset_exts(AssetType type)
     }
 }
 
+AssetType detect_media_type(const QString& basename, const QString& ext)
+{
+    const AssetType type = str_to_type(basename);
+    if (allowed_asset_exts(type).contains(ext))
+        return type;
+
+    return AssetType::UNKNOWN;
+}
+
 } // namespace pegasus_assets
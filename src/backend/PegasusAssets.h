@@ -28,4 +28,8 @@ AssetType str_to_type(const QString&);
 AssetType ext_to_type(const QString&);
 const QStringList& allowed_asset_exts(AssetType);
 
+/// Returns the type of a media file by its base name and extension,
+/// or AssetType::UNKNOWN if it's not a recognized asset
+AssetType detect_media_type(const QString& basename, const QString& ext);
+
 } // namespace pegasus_assets
@@ -68,6 +68,18 @@ QString serialize_command(const QString& cmd, const QStringList& args)
     return (QStringList(QDir::toNativeSeparators(cmd)) + args).join(QLatin1String("`,`"));
 }
 
+QString launchstate_to_string(int state)
+{
+    static constexpr const char* NAMES[] = {
+        "idle",
+        "preparing",
+        "starting",
+        "running",
+        "finishing",
+    };
+    return QLatin1String(NAMES[state]);
+}
+
 QString processerror_to_string(QProcess::ProcessError error)
 {
     switch (error) {
@@ -113,13 +125,43 @@ QString abs_workdir(const QString& workdir, const QString& base_dir, const QStri
 
 ProcessLauncher::ProcessLauncher(QObject* parent)
     : QObject(parent)
+    , m_state(LaunchState::IDLE)
     , m_process(nullptr)
-{}
+    , m_launch_ok(false)
+    , m_teardown_done(false)
+{
+    connect(&m_script_watcher, &QFutureWatcher<void>::finished, this, [this]{
+        switch (m_state) {
+            case LaunchState::PREPARING:
+                runProcess();
+                break;
+            case LaunchState::FINISHING:
+                tryFinish();
+                break;
+            default:
+                Q_UNREACHABLE();
+                break;
+        }
+    });
+}
+
+ProcessLauncher::~ProcessLauncher()
+{
+    // the scripts can't be interrupted, but at least they should not outlive the app
+    m_script_watcher.waitForFinished();
+}
 
 void ProcessLauncher::onLaunchRequested(const model::GameFile* q_gamefile)
 {
     Q_ASSERT(q_gamefile);
 
+    if (m_state != LaunchState::IDLE) {
+        const QString message = LOGMSG("Cannot launch a game while another one is running");
+        Log::warning(message);
+        emit processLaunchError(message);
+        return;
+    }
+
     const model::GameFile& gamefile = *q_gamefile;
     const model::Game& game = *gamefile.parentGame();
 
@@ -168,17 +210,31 @@ void ProcessLauncher::onLaunchRequested(const model::GameFile* q_gamefile)
     workdir = helpers::abs_workdir(workdir, game.launchCmdBasedir(), default_workdir);
 
 
+    m_command = std::move(command);
+    m_args = std::move(args);
+    m_workdir = std::move(workdir);
+
+    m_phase_timer.start();
     beforeRun(gamefile.fileinfo().absoluteFilePath());
-    runProcess(command, args, workdir);
 }
 
-void ProcessLauncher::runProcess(const QString& command, const QStringList& args, const QString& workdir)
+void ProcessLauncher::setState(LaunchState state)
 {
-    Log::info(LOGMSG("Executing command: [`%1`]").arg(serialize_command(command, args)));
-    Log::info(LOGMSG("Working directory: `%3`").arg(QDir::toNativeSeparators(workdir)));
+    Log::info(LOGMSG("Launch phase `%1` took %2 ms")
+        .arg(launchstate_to_string(static_cast<int>(m_state)))
+        .arg(m_phase_timer.restart()));
+
+    m_state = state;
+}
+
+void ProcessLauncher::runProcess()
+{
+    Log::info(LOGMSG("Executing command: [`%1`]").arg(serialize_command(m_command, m_args)));
+    Log::info(LOGMSG("Working directory: `%3`").arg(QDir::toNativeSeparators(m_workdir)));
 
     Q_ASSERT(!m_process);
     m_process = new QProcess(this);
+    setState(LaunchState::STARTING);
 
     // set up signals and slots
     connect(m_process, &QProcess::started, this, &ProcessLauncher::onProcessStarted);
@@ -186,27 +242,29 @@ void ProcessLauncher::runProcess(const QString& command, const QStringList& args
     connect(m_process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
             this, &ProcessLauncher::onProcessFinished);
 
-    // run the command
+    // run the command; the result is reported by the signals above
     m_process->setProcessChannelMode(QProcess::ForwardedChannels);
     m_process->setInputChannelMode(QProcess::ForwardedInputChannel);
-    m_process->setWorkingDirectory(workdir);
-    m_process->start(command, args, QProcess::ReadOnly);
-    m_process->waitForStarted(-1);
+    m_process->setWorkingDirectory(m_workdir);
+    m_process->start(m_command, m_args, QProcess::ReadOnly);
 }
 
 void ProcessLauncher::onTeardownComplete()
 {
-    Q_ASSERT(m_process);
+    Q_ASSERT(m_launch_ok);
 
-    m_process->waitForFinished(-1);
-    emit processFinished();
+    m_teardown_done = true;
+    tryFinish();
 }
 
 void ProcessLauncher::onProcessStarted()
 {
     Q_ASSERT(m_process);
     Log::info(LOGMSG("Process %1 started").arg(m_process->processId()));
+    setState(LaunchState::RUNNING);
     Log::info(SEPARATOR);
+
+    m_launch_ok = true;
     emit processLaunchOk();
 }
 
@@ -252,8 +310,10 @@ void ProcessLauncher::onProcessFinished(int exitcode, QProcess::ExitStatus exits
 
 void ProcessLauncher::beforeRun(const QString& game_path)
 {
+    m_state = LaunchState::PREPARING;
+
     TerminalKbd::enable();
-    ScriptRunner::run(ScriptEvent::PROCESS_STARTED, { game_path });
+    m_script_watcher.setFuture(ScriptRunner::runAsync(ScriptEvent::PROCESS_STARTED, { game_path }));
 }
 
 void ProcessLauncher::afterRun()
@@ -262,6 +322,28 @@ void ProcessLauncher::afterRun()
     m_process->deleteLater();
     m_process = nullptr;
 
-    ScriptRunner::run(ScriptEvent::PROCESS_FINISHED);
+    setState(LaunchState::FINISHING);
+    m_script_watcher.setFuture(ScriptRunner::runAsync(ScriptEvent::PROCESS_FINISHED));
+}
+
+void ProcessLauncher::tryFinish()
+{
+    Q_ASSERT(m_state == LaunchState::FINISHING || m_state == LaunchState::RUNNING);
+
+    // the frontend can only be rebuilt after it was fully torn down
+    // and the game end scripts are done
+    const bool scripts_done = m_state == LaunchState::FINISHING && m_script_watcher.isFinished();
+    const bool frontend_done = !m_launch_ok || m_teardown_done;
+    if (!scripts_done || !frontend_done)
+        return;
+
     TerminalKbd::disable();
+    setState(LaunchState::IDLE);
+
+    const bool launch_ok = m_launch_ok;
+    m_launch_ok = false;
+    m_teardown_done = false;
+
+    if (launch_ok)
+        emit processFinished();
 }
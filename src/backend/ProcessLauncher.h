@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 #include <QObject>
 #include <QProcess>
 
@@ -32,11 +34,16 @@ QString abs_workdir(const QString& workdir, const QString& base_dir, const QStri
 /// Launches and manages external processes
 ///
 /// Launches external processes and detects their success or failure.
+/// The launch is asynchronous and never blocks the event loop: it goes
+/// through the preparation (game start scripts), starting, running and
+/// finishing (game end scripts) phases, driven by the signals of the
+/// process. The time spent in each phase is logged.
 class ProcessLauncher : public QObject {
     Q_OBJECT
 
 public:
     explicit ProcessLauncher(QObject* parent = nullptr);
+    ~ProcessLauncher();
 
 signals:
     void processLaunchOk();
@@ -54,10 +61,30 @@ private slots:
     void onProcessFinished(int, QProcess::ExitStatus);
 
 private:
+    enum class LaunchState : unsigned char {
+        IDLE,
+        PREPARING,
+        STARTING,
+        RUNNING,
+        FINISHING,
+    };
+
+    LaunchState m_state;
+    QElapsedTimer m_phase_timer;
     QProcess* m_process;
+    QFutureWatcher<void> m_script_watcher;
+
+    QString m_command;
+    QStringList m_args;
+    QString m_workdir;
+
+    bool m_launch_ok;
+    bool m_teardown_done;
 
-    void runProcess(const QString&, const QStringList&, const QString&);
+    void setState(LaunchState);
+    void runProcess();
 
     void beforeRun(const QString&);
     void afterRun();
+    void tryFinish();
 };
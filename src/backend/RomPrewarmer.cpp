@@ -0,0 +1,210 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "RomPrewarmer.h"
+
+#include "AppSettings.h"
+#include "Log.h"
+#include "model/gaming/Game.h"
+#include "model/gaming/GameFile.h"
+#include "utils/IoHints.h"
+#include "utils/MemoryUsage.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <limits>
+
+
+namespace {
+constexpr int DWELL_TIME_MS = 500;
+constexpr qint64 CHUNK_SIZE = 4 * 1024 * 1024;
+constexpr double BYTES_PER_MIB = 1024.0 * 1024.0;
+
+const QString& log_tag()
+{
+    static const QString TAG(QStringLiteral("ROM prewarm"));
+    return TAG;
+}
+
+QString as_mib(qint64 bytes)
+{
+    return QString::number(bytes / BYTES_PER_MIB, 'f', 1);
+}
+} // namespace
+
+
+RomPrewarmer::RomPrewarmer(QObject* parent)
+    : QObject(parent)
+    , m_pending_bytes_per_file(0)
+    , m_generation(std::make_shared<std::atomic<unsigned>>(0))
+    , m_budget_left(std::make_shared<std::atomic<qint64>>(0))
+    , m_budget_set(false)
+    , m_launch_cnt(0)
+    , m_hit_cnt(0)
+{
+    // one file at a time is enough to keep the disk busy
+    m_pool.setMaxThreadCount(1);
+
+    m_dwell_timer.setSingleShot(true);
+    m_dwell_timer.setInterval(DWELL_TIME_MS);
+    connect(&m_dwell_timer, &QTimer::timeout, this, &RomPrewarmer::start);
+}
+
+RomPrewarmer::~RomPrewarmer()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+void RomPrewarmer::focus(const model::Game* game)
+{
+    const int prewarm_mb = AppSettings::general.rom_prewarm_mb;
+    if (!game || prewarm_mb <= 0 || (m_budget_set && *m_budget_left <= 0)) {
+        cancel();
+        return;
+    }
+
+    // files read ahead earlier are still counted against the budget
+    QStringList paths;
+    for (const model::GameFile* const gamefile : game->filesConst()) {
+        QString path = gamefile->fileinfo().absoluteFilePath();
+        if (!m_prewarmed.count(path))
+            paths.append(std::move(path));
+    }
+
+    // the same game may be reported multiple times
+    if (paths.isEmpty() || paths == m_pending_paths)
+        return;
+
+    cancel();
+    m_pending_paths = std::move(paths);
+    m_pending_bytes_per_file = static_cast<qint64>(prewarm_mb) * 1024 * 1024;
+    m_dwell_timer.start();
+}
+
+void RomPrewarmer::cancel()
+{
+    m_dwell_timer.stop();
+    m_pending_paths.clear();
+
+    // the running task stops at the next chunk, the queued ones don't start;
+    // the kernel readahead already requested on Linux can't be stopped
+    ++*m_generation;
+    m_pool.clear();
+}
+
+void RomPrewarmer::start()
+{
+    Q_ASSERT(!m_pending_paths.isEmpty());
+
+    // don't push out more from the page cache than what's reasonable
+    if (!m_budget_set) {
+        const qint64 available = utils::available_memory_size();
+        *m_budget_left = available >= 0
+            ? available / 2
+            : std::numeric_limits<qint64>::max();
+        m_budget_set = true;
+    }
+
+    const QStringList paths = m_pending_paths;
+    const qint64 bytes_per_file = m_pending_bytes_per_file;
+    const std::shared_ptr<std::atomic<unsigned>> generation_ptr = m_generation;
+    const std::shared_ptr<std::atomic<qint64>> budget_ptr = m_budget_left;
+    const unsigned generation = *m_generation;
+
+    QtConcurrent::run(&m_pool, [this, paths, bytes_per_file, generation_ptr, budget_ptr, generation]{
+        utils::lower_thread_priority();
+
+        for (const QString& path : paths) {
+            if (*generation_ptr != generation)
+                return;
+
+            const qint64 budget_left = *budget_ptr;
+            if (budget_left <= 0)
+                return;
+
+            QFile file(path);
+            if (!file.open(QIODevice::ReadOnly))
+                continue;
+
+            const qint64 length = std::min({ file.size(), bytes_per_file, budget_left });
+            QElapsedTimer timer;
+            timer.start();
+
+            qint64 done = 0;
+            bool was_read = true;
+            while (done < length && *generation_ptr == generation) {
+                const qint64 chunk = std::min(CHUNK_SIZE, length - done);
+                was_read &= utils::prefetch_range(file, done, chunk);
+                done += chunk;
+            }
+            if (done == 0)
+                return;
+
+            const qint64 elapsed_ms = timer.elapsed();
+            *budget_ptr -= done;
+
+            QMetaObject::invokeMethod(this, [this, path, done, was_read, elapsed_ms]{
+                if (was_read) {
+                    LOG_INFO(log_tag(), LOGMSG("Read ahead %1 MiB of `%2` in %3 ms")
+                        .arg(as_mib(done), path, QString::number(elapsed_ms)));
+                }
+                else {
+                    LOG_INFO(log_tag(), LOGMSG("Requested the read-ahead of %1 MiB of `%2`")
+                        .arg(as_mib(done), path));
+                }
+                onFileDone(path, done);
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+void RomPrewarmer::onFileDone(const QString& path, qint64 bytes)
+{
+    m_prewarmed[path] += bytes;
+
+    if (*m_budget_left <= 0) {
+        Log::info(log_tag(), LOGMSG("The read-ahead budget is used up, no more files will be prewarmed"));
+        cancel();
+    }
+}
+
+void RomPrewarmer::onLaunchRequested(const model::GameFile* gamefile)
+{
+    Q_ASSERT(gamefile);
+
+    const QString path = gamefile->fileinfo().absoluteFilePath();
+    const auto it = m_prewarmed.find(path);
+    const bool hit = it != m_prewarmed.cend();
+    m_launch_cnt++;
+    if (hit)
+        m_hit_cnt++;
+
+    if (AppSettings::general.rom_prewarm_mb > 0) {
+        const QString status = hit
+            ? LOGMSG("prewarmed (%1 MiB)").arg(as_mib(it->second))
+            : LOGMSG("not prewarmed");
+        Log::info(log_tag(), LOGMSG("Launching `%1`, %2; hit rate: %3/%4")
+            .arg(path, status, QString::number(m_hit_cnt), QString::number(m_launch_cnt)));
+    }
+
+    // a request that didn't start yet is not useful anymore
+    m_dwell_timer.stop();
+}
@@ -0,0 +1,75 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include "utils/HashMap.h"
+
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+
+namespace model { class Game; }
+namespace model { class GameFile; }
+
+
+/// Reads the beginning of the focused game's files into the OS page cache
+///
+/// When the frontend reports the focused game, and the focus stays there for
+/// a short time, the first `rom-prewarm-mb` megabytes of each of its files
+/// are read ahead on a low priority thread. All read-aheads share a single
+/// budget, half of the memory available when the first one starts, which
+/// shrinks with every file read ahead; once it is used up, prewarming stops.
+/// Focusing another game cancels the previous request.
+///
+/// On Linux, the read-ahead is only a hint to the kernel: the request returns
+/// right away, and the reads already queued by it can't be cancelled.
+/// On launch, whether the file was prewarmed and the hit rate is logged.
+class RomPrewarmer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RomPrewarmer(QObject* parent = nullptr);
+    ~RomPrewarmer();
+
+    /// Schedules the prewarming of the game's files; null cancels the current request
+    void focus(const model::Game*);
+    void cancel();
+
+    void onLaunchRequested(const model::GameFile*);
+
+private:
+    QTimer m_dwell_timer;
+    QStringList m_pending_paths;
+    qint64 m_pending_bytes_per_file;
+
+    QThreadPool m_pool;
+    const std::shared_ptr<std::atomic<unsigned>> m_generation;
+    const std::shared_ptr<std::atomic<qint64>> m_budget_left;
+    bool m_budget_set;
+    HashMap<QString, qint64> m_prewarmed;
+
+    unsigned m_launch_cnt;
+    unsigned m_hit_cnt;
+
+    void start();
+    void onFileDone(const QString& path, qint64 bytes);
+};
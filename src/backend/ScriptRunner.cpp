@@ -15,51 +15,227 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 
+
 #include "ScriptRunner.h"
 
+#include "AppSettings.h"
 #include "Log.h"
 #include "Paths.h"
 #include "utils/HashMap.h"
 
+#include <QCoreApplication>
 #include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QMutex>
+#include <QPointer>
 #include <QProcess>
 #include <QString>
 #include <QStringBuilder>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <vector>
 
 
 namespace {
-std::vector<QString> find_scripts_in(const QString& dirname)
+struct RunOptions {
+    bool parallel;
+    int timeout_ms; // -1 means no limit
+};
+
+struct ScanResult {
+    std::vector<QString> scripts;
+    QStringList watched_dirs;
+};
+
+
+// The found scripts of the events. The cache is cleared when anything changes
+// in one of the directories the scripts were searched in, including the
+// permissions of the files; the generation tells if that happened during a scan.
+QMutex g_cache_guard;
+HashMap<ScriptEvent, std::vector<QString>, EnumHash> g_cache;
+quint64 g_cache_generation = 0;
+
+void clear_cache()
 {
-    constexpr auto filters = QDir::Files | QDir::Readable | QDir::Executable | QDir::NoDotAndDotDot;
-    constexpr auto flags = QDirIterator::Subdirectories | QDirIterator::FollowSymlinks;
+    QMutexLocker lock(&g_cache_guard);
+    g_cache.clear();
+    g_cache_generation++;
+}
+
+
+const QString& script_dirname(ScriptEvent event)
+{
+    static const HashMap<ScriptEvent, QString, EnumHash> SCRIPT_DIRS {
+        { ScriptEvent::QUIT, QStringLiteral("quit") },
+        { ScriptEvent::REBOOT, QStringLiteral("reboot") },
+        { ScriptEvent::SHUTDOWN, QStringLiteral("shutdown") },
+        { ScriptEvent::CONFIG_CHANGED, QStringLiteral("config-changed") },
+        { ScriptEvent::SETTINGS_CHANGED, QStringLiteral("settings-changed") },
+        { ScriptEvent::CONTROLS_CHANGED, QStringLiteral("controls-changed") },
+        { ScriptEvent::PROCESS_STARTED, QStringLiteral("game-start") },
+        { ScriptEvent::PROCESS_FINISHED, QStringLiteral("game-end") },
+    };
+    Q_ASSERT(SCRIPT_DIRS.count(event));
 
-    Q_ASSERT(!dirname.isEmpty());
+    return SCRIPT_DIRS.at(event);
+}
 
-    std::vector<QString> all_scripts;
+RunOptions current_options()
+{
+    const qint64 timeout_secs = AppSettings::general.script_timeout_secs;
+    const qint64 timeout_ms = std::min<qint64>(timeout_secs * 1000, std::numeric_limits<int>::max());
+    return {
+        AppSettings::general.parallel_scripts,
+        timeout_secs > 0 ? static_cast<int>(timeout_ms) : -1,
+    };
+}
+
+std::vector<QString> script_dirs_of(const QString& dirname)
+{
+    std::vector<QString> out;
 
     const QStringList configdirs = paths::configDirs();
-    for (const QString& configdir : configdirs) {
-        const QString scriptdir = configdir % QStringLiteral("/scripts/") % dirname;
+    for (const QString& configdir : configdirs)
+        out.emplace_back(configdir % QStringLiteral("/scripts/") % dirname);
+
+    return out;
+}
+
+// The directory that should be watched for the appearance of `dir`
+QString closest_existing_dir(const QString& dir)
+{
+    QFileInfo current(dir);
+    while (!current.exists()) {
+        const QString parent = current.absolutePath();
+        if (parent == current.absoluteFilePath())
+            return QString();
+        current.setFile(parent);
+    }
+    return current.absoluteFilePath();
+}
+
+ScanResult find_scripts_in(const std::vector<QString>& scriptdirs)
+{
+    constexpr auto filters = QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot;
+    constexpr auto flags = QDirIterator::Subdirectories | QDirIterator::FollowSymlinks;
+
+    ScanResult result;
+
+    for (const QString& scriptdir : scriptdirs) {
+        const QString watched_root = closest_existing_dir(scriptdir);
+        if (!watched_root.isEmpty())
+            result.watched_dirs.append(watched_root);
 
         std::vector<QString> local_scripts;
         QDirIterator scripdir_it(scriptdir, filters, flags);
-        while (scripdir_it.hasNext())
-            local_scripts.emplace_back(scripdir_it.next());
+        while (scripdir_it.hasNext()) {
+            scripdir_it.next();
+            const QFileInfo finfo = scripdir_it.fileInfo();
+
+            // changes in subdirectories and permissions are only seen
+            // by watching the directories that contain them
+            if (finfo.isDir())
+                result.watched_dirs.append(finfo.absoluteFilePath());
+            else if (finfo.isReadable() && finfo.isExecutable())
+                local_scripts.emplace_back(finfo.filePath());
+        }
 
         std::sort(local_scripts.begin(), local_scripts.end());
-        all_scripts.insert(all_scripts.end(),
-                           std::make_move_iterator(local_scripts.begin()),
-                           std::make_move_iterator(local_scripts.end()));
+        result.scripts.insert(result.scripts.end(),
+                              std::make_move_iterator(local_scripts.begin()),
+                              std::make_move_iterator(local_scripts.end()));
     }
 
-    return all_scripts;
+    return result;
+}
+
+// Stores the scan result once its directories are watched
+void cache_and_watch(ScriptEvent event, const ScanResult& found, quint64 generation)
+{
+    // QFileSystemWatcher needs an event loop, so it lives on the main thread;
+    // without an application there is nothing to clear the cache, so it is not used
+    QCoreApplication* const app = QCoreApplication::instance();
+    if (!app)
+        return;
+
+    QMetaObject::invokeMethod(app, [app, event, found, generation]{
+        static QPointer<QFileSystemWatcher> watcher;
+        if (!watcher) {
+            watcher = new QFileSystemWatcher(app);
+            QObject::connect(watcher.data(), &QFileSystemWatcher::directoryChanged,
+                             [](const QString&){ clear_cache(); });
+        }
+
+        QStringList new_dirs = found.watched_dirs;
+        new_dirs.removeDuplicates();
+        const QStringList watched_dirs = watcher->directories();
+        new_dirs.erase(std::remove_if(new_dirs.begin(), new_dirs.end(),
+            [&watched_dirs](const QString& dir){ return watched_dirs.contains(dir); }),
+            new_dirs.end());
+        if (!new_dirs.isEmpty())
+            watcher->addPaths(new_dirs);
+
+        // if something has changed during the scan, the result might be outdated
+        QMutexLocker lock(&g_cache_guard);
+        if (generation == g_cache_generation)
+            g_cache[event] = found.scripts;
+    });
+}
+
+std::vector<QString> cached_scripts_of(ScriptEvent event)
+{
+    quint64 generation = 0;
+    {
+        QMutexLocker lock(&g_cache_guard);
+        const auto it = g_cache.find(event);
+        if (it != g_cache.cend())
+            return it->second;
+
+        generation = g_cache_generation;
+    }
+
+    ScanResult found = find_scripts_in(script_dirs_of(script_dirname(event)));
+    cache_and_watch(event, found, generation);
+    return std::move(found.scripts);
+}
+
+void report_result(const QString& path, QProcess& process, bool finished, qint64 elapsed_ms)
+{
+    if (!finished) {
+        Log::warning(LOGMSG("`%1` did not finish in time, killed after %2 ms").arg(path).arg(elapsed_ms));
+        process.kill();
+        process.waitForFinished();
+        return;
+    }
+    if (process.exitStatus() == QProcess::CrashExit) {
+        Log::warning(LOGMSG("`%1` has crashed after %2 ms").arg(path).arg(elapsed_ms));
+        return;
+    }
+    if (process.exitCode() != 0) {
+        Log::warning(LOGMSG("`%1` has finished with error code %2 after %3 ms")
+            .arg(path, QString::number(process.exitCode()), QString::number(elapsed_ms)));
+        return;
+    }
+    Log::info(LOGMSG("`%1` has finished in %2 ms").arg(path).arg(elapsed_ms));
 }
 
-void execute_all(const std::vector<QString>& paths, const QStringList& args)
+bool start_script(const QString& path, const QStringList& args, QProcess& process)
 {
-    Q_ASSERT(!paths.empty());
+    process.setProcessChannelMode(QProcess::ForwardedChannels);
+    process.start(path, args, QProcess::ReadOnly);
+    if (process.waitForStarted())
+        return true;
+
+    Log::warning(LOGMSG("`%1` could not be started: %2").arg(path, process.errorString()));
+    return false;
+}
 
+void execute_serial(const std::vector<QString>& paths, const QStringList& args, int timeout_ms)
+{
     const int num_field_width = QString::number(paths.size()).length();
 
     for (size_t i = 0; i < paths.size(); i++) {
@@ -67,9 +243,77 @@ void execute_all(const std::vector<QString>& paths, const QStringList& args)
             .arg(i + 1, num_field_width)
             .arg(paths.size())
             .arg(paths[i]));
-        QProcess::execute(paths[i], args);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QProcess process;
+        if (!start_script(paths[i], args, process))
+            continue;
+
+        const bool finished = process.waitForFinished(timeout_ms);
+        report_result(paths[i], process, finished, timer.elapsed());
+    }
+}
+
+void execute_parallel(const std::vector<QString>& paths, const QStringList& args, int timeout_ms)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // QProcess can't be moved, so they are kept on the heap
+    std::vector<std::unique_ptr<QProcess>> processes;
+    processes.reserve(paths.size());
+    for (const QString& path : paths) {
+        Log::info(LOGMSG("Running `%1`").arg(path));
+        processes.emplace_back(new QProcess);
+        if (!start_script(path, args, *processes.back()))
+            processes.back().reset();
+    }
+
+    // the timeout is counted from the common start time
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (!processes[i])
+            continue;
+
+        const int remaining_ms = timeout_ms < 0
+            ? -1
+            : static_cast<int>(std::max<qint64>(0, timeout_ms - timer.elapsed()));
+        const bool finished = processes[i]->waitForFinished(remaining_ms);
+        report_result(paths[i], *processes[i], finished, timer.elapsed());
     }
 }
+
+// The events run one at a time, in the order they were reported
+struct EventQueue : public QThreadPool {
+    EventQueue() { setMaxThreadCount(1); }
+};
+
+QThreadPool& event_queue()
+{
+    static EventQueue queue;
+    return queue;
+}
+
+void run_scripts(ScriptEvent event, const QStringList& args, const RunOptions& options)
+{
+    const std::vector<QString> scripts = cached_scripts_of(event);
+    if (scripts.empty())
+        return;
+
+    const QString& dirname = script_dirname(event);
+    Log::info(LOGMSG("Running `%1` scripts...").arg(dirname));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (options.parallel)
+        execute_parallel(scripts, args, options.timeout_ms);
+    else
+        execute_serial(scripts, args, options.timeout_ms);
+
+    Log::info(LOGMSG("`%1` scripts finished in %2 ms").arg(dirname).arg(timer.elapsed()));
+}
 } // namespace
 
 
@@ -80,25 +324,18 @@ void ScriptRunner::run(ScriptEvent event)
 
 void ScriptRunner::run(ScriptEvent event, const QStringList& args)
 {
-    static const HashMap<ScriptEvent, QString, EnumHash> SCRIPT_DIRS {
-        { ScriptEvent::QUIT, QStringLiteral("quit") },
-        { ScriptEvent::REBOOT, QStringLiteral("reboot") },
-        { ScriptEvent::SHUTDOWN, QStringLiteral("shutdown") },
-        { ScriptEvent::CONFIG_CHANGED, QStringLiteral("config-changed") },
-        { ScriptEvent::SETTINGS_CHANGED, QStringLiteral("settings-changed") },
-        { ScriptEvent::CONTROLS_CHANGED, QStringLiteral("controls-changed") },
-        { ScriptEvent::PROCESS_STARTED, QStringLiteral("game-start") },
-        { ScriptEvent::PROCESS_FINISHED, QStringLiteral("game-end") },
-    };
-    Q_ASSERT(SCRIPT_DIRS.count(event));
-
-
-    const QString& dirname = SCRIPT_DIRS.at(event);
-    const std::vector<QString> scripts = find_scripts_in(dirname);
+    event_queue().waitForDone();
+    run_scripts(event, args, current_options());
+}
 
-    if (scripts.empty())
-        return;
+QFuture<void> ScriptRunner::runAsync(ScriptEvent event)
+{
+    return runAsync(event, {});
+}
 
-    Log::info(LOGMSG("Running `%1` scripts...").arg(dirname));
-    execute_all(scripts, args);
+QFuture<void> ScriptRunner::runAsync(ScriptEvent event, const QStringList& args)
+{
+    // the settings are read on the calling thread
+    const RunOptions options = current_options();
+    return QtConcurrent::run(&event_queue(), [event, args, options]{ run_scripts(event, args, options); });
 }
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <QFuture>
+
 class QStringList;
 
 
@@ -33,8 +35,19 @@ enum class ScriptEvent : unsigned char {
 
 
 /// A utility class for finding and running external scripts
+///
+/// The list of scripts is cached, and refreshed when anything changes in the
+/// script directories or their subdirectories, including permission changes
+/// on platforms that report them for the containing directory (eg. Linux).
+/// The scripts run in alphabetical order, or all at once if `parallel-scripts`
+/// is set; those that don't finish within the `script-timeout` are killed.
 class ScriptRunner {
 public:
+    /// Runs the scripts on the calling thread, after the queued events finished
     static void run(ScriptEvent);
     static void run(ScriptEvent, const QStringList&);
+    /// Queues the event on a single worker thread, so the events run in order.
+    /// The settings are read on the calling thread.
+    static QFuture<void> runAsync(ScriptEvent);
+    static QFuture<void> runAsync(ScriptEvent, const QStringList&);
 };
@@ -9,6 +9,7 @@ else: QT += gamepad
 
 !isEmpty(INSIDE_FLATPAK): DEFINES *= PEGASUS_INSIDE_FLATPAK
 msvc: DEFINES *= _USE_MATH_DEFINES
+!isEmpty(LOG_MIN_LEVEL): DEFINES *= PEGASUS_LOG_MIN_LEVEL=$${LOG_MIN_LEVEL}
 
 
 SOURCES += \
@@ -18,6 +19,7 @@ SOURCES += \
     GamepadAxisNavigation.cpp \
     PegasusAssets.cpp \
     ProcessLauncher.cpp \
+    RomPrewarmer.cpp \
     ScriptRunner.cpp \
     Paths.cpp \
     AppSettings.cpp \
@@ -32,6 +34,7 @@ HEADERS += \
     GamepadAxisNavigation.h \
     PegasusAssets.h \
     ProcessLauncher.h \
+    RomPrewarmer.h \
     ScriptRunner.h \
     Paths.h \
     AppSettings.h \
@@ -0,0 +1,167 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "BlurhashEncoder.h"
+
+#include "Srgb.h"
+
+#include <QImage>
+#include <cmath>
+#include <vector>
+
+
+namespace {
+constexpr char BASE83[] =
+    "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz#$%*+,-.:;=?@[]^_{|}~";
+
+struct FpColor {
+    float r;
+    float g;
+    float b;
+};
+
+
+void append_base83(QString& out, unsigned value, int length)
+{
+    for (int i = length - 1; i >= 0; i--) {
+        unsigned divisor = 1;
+        for (int j = 0; j < i; j++)
+            divisor *= 83;
+
+        out.append(QLatin1Char(BASE83[(value / divisor) % 83]));
+    }
+}
+
+
+float sign_pow(float value, float exp)
+{
+    return std::copysign(std::pow(std::abs(value), exp), value);
+}
+
+
+unsigned encode_dc(const FpColor& color)
+{
+    const unsigned r = imggen::linear_to_srgb(color.r);
+    const unsigned g = imggen::linear_to_srgb(color.g);
+    const unsigned b = imggen::linear_to_srgb(color.b);
+    return (r << 16) + (g << 8) + b;
+}
+
+
+unsigned quant_ac_component(float value, float max_ac)
+{
+    const float quant = std::floor(sign_pow(value / max_ac, 0.5f) * 9.f + 9.5f);
+    return static_cast<unsigned>(std::max(0.f, std::min(quant, 18.f)));
+}
+
+
+unsigned encode_ac(const FpColor& color, float max_ac)
+{
+    return quant_ac_component(color.r, max_ac) * 19 * 19
+        + quant_ac_component(color.g, max_ac) * 19
+        + quant_ac_component(color.b, max_ac);
+}
+
+
+// The basis values of a row or column, in pixel-major order
+std::vector<float> create_cos_table(int components, int image_dim)
+{
+    std::vector<float> out(components * image_dim);
+    for (int pixel = 0; pixel < image_dim; pixel++) {
+        for (int comp = 0; comp < components; comp++)
+            out[pixel * components + comp] = std::cos(M_PI * pixel * comp / image_dim);
+    }
+    return out;
+}
+} // namespace
+
+
+namespace imggen {
+
+QString encode_blurhash(const QImage& input, int components_x, int components_y)
+{
+    if (input.isNull() || components_x < 1 || components_x > 9 || components_y < 1 || components_y > 9)
+        return {};
+
+    const QImage image = input.convertToFormat(QImage::Format_RGB888);
+    const int width = image.width();
+    const int height = image.height();
+
+    const std::vector<float> cos_x_table = create_cos_table(components_x, width);
+    const std::vector<float> cos_y_table = create_cos_table(components_y, height);
+
+    std::vector<FpColor> factors(components_x * components_y, FpColor { 0.f, 0.f, 0.f });
+    for (int img_y = 0; img_y < height; img_y++) {
+        const uchar* const line = image.constScanLine(img_y);
+        const float* const basis_y = cos_y_table.data() + img_y * components_y;
+
+        for (int img_x = 0; img_x < width; img_x++) {
+            const float r = srgb_to_linear(line[img_x * 3 + 0]);
+            const float g = srgb_to_linear(line[img_x * 3 + 1]);
+            const float b = srgb_to_linear(line[img_x * 3 + 2]);
+            const float* const basis_x = cos_x_table.data() + img_x * components_x;
+
+            for (int cy = 0; cy < components_y; cy++) {
+                for (int cx = 0; cx < components_x; cx++) {
+                    const float basis = basis_x[cx] * basis_y[cy];
+                    FpColor& factor = factors[cy * components_x + cx];
+                    factor.r += basis * r;
+                    factor.g += basis * g;
+                    factor.b += basis * b;
+                }
+            }
+        }
+    }
+
+    const float pixel_cnt = static_cast<float>(width) * height;
+    for (size_t i = 0; i < factors.size(); i++) {
+        const float scale = (i == 0 ? 1.f : 2.f) / pixel_cnt;
+        factors[i].r *= scale;
+        factors[i].g *= scale;
+        factors[i].b *= scale;
+    }
+
+    QString out;
+    out.reserve(4 + 2 * static_cast<int>(factors.size()));
+    append_base83(out, (components_x - 1) + (components_y - 1) * 9, 1);
+
+    float max_ac = 1.f;
+    if (factors.size() > 1) {
+        float actual_max = 0.f;
+        for (size_t i = 1; i < factors.size(); i++) {
+            actual_max = std::max(actual_max, std::abs(factors[i].r));
+            actual_max = std::max(actual_max, std::abs(factors[i].g));
+            actual_max = std::max(actual_max, std::abs(factors[i].b));
+        }
+
+        const int quant_max = std::max(0, std::min(82, static_cast<int>(std::floor(actual_max * 166.f - 0.5f))));
+        max_ac = (quant_max + 1) / 166.f;
+        append_base83(out, quant_max, 1);
+    }
+    else {
+        append_base83(out, 0, 1);
+    }
+
+    append_base83(out, encode_dc(factors.front()), 4);
+    for (size_t i = 1; i < factors.size(); i++)
+        append_base83(out, encode_ac(factors[i], max_ac), 2);
+
+    return out;
+}
+
+} // namespace imggen
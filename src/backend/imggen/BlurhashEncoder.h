@@ -0,0 +1,33 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QString>
+
+class QImage;
+
+
+namespace imggen {
+
+/// Creates the blurhash of an image, using the given number of components
+/// in each direction (1-9). Small images are faster to encode, and give
+/// practically the same result. Returns an empty string on failure.
+QString encode_blurhash(const QImage&, int components_x, int components_y);
+
+} // namespace imggen
@@ -0,0 +1,470 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "BlurhashGenerator.h"
+
+#include "BlurhashEncoder.h"
+#include "Log.h"
+#include "Paths.h"
+#include "model/gaming/Assets.h"
+#include "model/gaming/GameStore.h"
+#include "types/AssetType.h"
+#include "utils/IoHints.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutex>
+#include <QSaveFile>
+#include <QSet>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <atomic>
+
+
+namespace {
+constexpr quint32 CACHE_VERSION = 1;
+// the images are encoded at this size; the hash is practically the same
+constexpr int ENCODE_MAX_SIZE = 32;
+// the number of results delivered to the main thread at once
+constexpr size_t RESULT_BATCH_SIZE = 64;
+// the results of the lazily resolved games are saved together after this delay
+constexpr int LATE_SAVE_DELAY_MS = 5000;
+
+QString cache_file_path()
+{
+    return paths::writableCacheDir() + QLatin1String("/blurhash.dat");
+}
+
+// the directory part of a path, in the same form as the lazy directories
+QString dir_of(const QString& path)
+{
+    return QDir::cleanPath(QFileInfo(path).path());
+}
+
+QString hash_image_file(const QString& path)
+{
+    // most formats can be decoded at a smaller size directly,
+    // which is much faster than decoding the full image
+    QImageReader reader(path);
+    const QSize full_size = reader.size();
+    if (full_size.isValid()) {
+        const QSize scaled_size = full_size
+            .scaled(ENCODE_MAX_SIZE, ENCODE_MAX_SIZE, Qt::KeepAspectRatio)
+            .expandedTo(QSize(1, 1));
+        reader.setScaledSize(scaled_size);
+    }
+
+    const QImage image = reader.read();
+    if (image.isNull()) {
+        LOG_WARNING(LOGMSG("Blurhash"), LOGMSG("Could not read `%1`: %2")
+            .arg(QDir::toNativeSeparators(path), reader.errorString()));
+        return QString();
+    }
+
+    const bool is_portrait = image.height() > image.width();
+    return imggen::encode_blurhash(image, is_portrait ? 3 : 4, is_portrait ? 4 : 3);
+}
+} // namespace
+
+
+struct BlurhashGenerator::Job {
+    size_t target_idx;
+    QString path;
+};
+
+struct BlurhashGenerator::Result {
+    size_t target_idx;
+    QString path;
+    CacheEntry entry;
+    bool from_cache;
+};
+
+struct BlurhashGenerator::Run {
+    std::vector<Job> jobs;
+    // the directories of the games whose box front is not known yet;
+    // their cache entries are kept, so they can be reused when resolved
+    QSet<QString> lazy_dirs;
+    std::atomic<bool> canceled;
+    std::atomic<int> remaining_tasks;
+
+    // loaded by the first task, if there was no cache yet
+    QMutex cache_guard;
+    std::shared_ptr<const Cache> cache;
+
+    // used on the main thread only
+    QElapsedTimer timer;
+    int generated_cnt;
+
+    Run()
+        : canceled(false)
+        , remaining_tasks(0)
+        , generated_cnt(0)
+    {}
+};
+
+
+BlurhashGenerator::BlurhashGenerator(QObject* parent)
+    : QObject(parent)
+{
+    // leave some cores for the UI and the other background tasks
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+
+    m_late_save_timer.setSingleShot(true);
+    m_late_save_timer.setInterval(LATE_SAVE_DELAY_MS);
+    connect(&m_late_save_timer, &QTimer::timeout, this, &BlurhashGenerator::save_late_results);
+}
+
+BlurhashGenerator::~BlurhashGenerator()
+{
+    cancel();
+    m_pool.waitForDone();
+    save_late_results();
+    m_save_future.waitForFinished();
+}
+
+void BlurhashGenerator::start(const std::vector<model::GameRowRef>& games)
+{
+    cancel();
+
+    auto run = std::make_shared<Run>();
+    for (const model::GameRowRef& ref : games) {
+        // games without assets don't have a box front either
+        model::Assets* const assets_ptr = ref.store->assets[ref.row];
+        if (!assets_ptr)
+            continue;
+
+        model::Assets& assets = *assets_ptr;
+        QString path = assets.first_file_path(AssetType::BOX_FRONT);
+        if (path.isEmpty()) {
+            // listing the media directories of every game here would undo the lazy
+            // loading, so these are hashed when something else has resolved them
+            if (!assets.lazy_dirs().isEmpty())
+                wait_for_lazy_dirs(assets, *run);
+            continue;
+        }
+
+        run->jobs.push_back(Job { m_targets.size(), std::move(path) });
+        m_targets.emplace_back(&assets);
+    }
+
+    run->cache = m_cache;
+    run->timer.start();
+
+    // there's at least one task, to load the cache for the games resolved later
+    const size_t task_cnt = std::max<size_t>(1,
+        std::min(static_cast<size_t>(m_pool.maxThreadCount()), run->jobs.size()));
+    run->remaining_tasks = static_cast<int>(task_cnt);
+    m_run = run;
+
+    for (size_t i = 0; i < task_cnt; i++)
+        QtConcurrent::run(&m_pool, &BlurhashGenerator::run_task, this, run, i, task_cnt);
+}
+
+void BlurhashGenerator::cancel()
+{
+    if (m_run) {
+        m_run->canceled = true;
+        m_run.reset();
+    }
+
+    m_targets.clear();
+    m_new_cache.clear();
+
+    for (const QPointer<model::Assets>& assets : m_lazy_targets) {
+        if (assets)
+            disconnect(assets, nullptr, this, nullptr);
+    }
+    m_lazy_targets.clear();
+    m_late_targets.clear();
+}
+
+void BlurhashGenerator::wait_for_lazy_dirs(model::Assets& assets, Run& run)
+{
+    for (const QString& dir : assets.lazy_dirs())
+        run.lazy_dirs.insert(QDir::cleanPath(dir));
+
+    model::Assets* const assets_ptr = &assets;
+    connect(assets_ptr, &model::Assets::assetsChanged, this, [this, assets_ptr]{
+        if (!assets_ptr->lazy_dirs().isEmpty())
+            return;
+
+        disconnect(assets_ptr, nullptr, this, nullptr);
+        on_lazy_dirs_resolved(assets_ptr);
+    });
+    m_lazy_targets.emplace_back(assets_ptr);
+}
+
+void BlurhashGenerator::on_lazy_dirs_resolved(model::Assets* assets)
+{
+    // during a run, the cache is not complete yet
+    if (m_run) {
+        m_late_targets.emplace_back(assets);
+        return;
+    }
+    start_late_job(assets);
+}
+
+void BlurhashGenerator::start_late_job(model::Assets* assets)
+{
+    // the cache is loaded by the runs
+    if (!m_cache)
+        return;
+
+    QString path = assets->first_file_path(AssetType::BOX_FRONT);
+    if (path.isEmpty())
+        return;
+
+    const QPointer<model::Assets> target(assets);
+    const std::shared_ptr<const Cache> cache = m_cache;
+    const Job job { 0, std::move(path) };
+    QtConcurrent::run(&m_pool, [this, target, cache, job]{
+        utils::lower_thread_priority();
+        const Result result = process_job(job, *cache);
+        if (result.path.isEmpty())
+            return;
+
+        QMetaObject::invokeMethod(this, [this, target, result]{ apply_late_result(target, result); },
+            Qt::QueuedConnection);
+    });
+}
+
+void BlurhashGenerator::apply_late_result(const QPointer<model::Assets>& target, const Result& result)
+{
+    if (target && !result.entry.hash.isEmpty())
+        target->set_box_front_blurhash(result.entry.hash);
+
+    if (!result.from_cache) {
+        m_late_cache[result.path] = result.entry;
+        m_late_save_timer.start();
+    }
+}
+
+void BlurhashGenerator::save_late_results()
+{
+    m_late_save_timer.stop();
+    if (m_late_cache.empty() || !m_cache)
+        return;
+
+    auto merged = std::make_shared<Cache>(*m_cache);
+    for (auto& pair : m_late_cache)
+        (*merged)[pair.first] = std::move(pair.second);
+    m_late_cache.clear();
+
+    m_cache = std::move(merged);
+    save_in_background();
+}
+
+void BlurhashGenerator::save_in_background()
+{
+    m_save_future.waitForFinished();
+
+    const std::shared_ptr<const Cache> cache = m_cache;
+    m_save_future = QtConcurrent::run([cache]{ save_cache(*cache); });
+}
+
+void BlurhashGenerator::run_task(BlurhashGenerator* self, std::shared_ptr<Run> run, size_t task_idx, size_t task_cnt)
+{
+    utils::lower_thread_priority();
+
+    std::shared_ptr<const Cache> cache;
+    {
+        QMutexLocker lock(&run->cache_guard);
+        if (!run->cache)
+            run->cache = load_cache();
+        cache = run->cache;
+    }
+
+    // the results are delivered only if the generator still exists,
+    // and applied only if the run wasn't cancelled in the meantime
+    const auto deliver = [self, &run](const std::vector<Result>& results){
+        QMetaObject::invokeMethod(self, [self, run, results]{ self->apply_results(run, results); },
+            Qt::QueuedConnection);
+    };
+
+    std::vector<Result> results;
+    for (size_t i = task_idx; i < run->jobs.size(); i += task_cnt) {
+        if (run->canceled)
+            break;
+
+        Result result = process_job(run->jobs[i], *cache);
+        if (result.path.isEmpty())
+            continue;
+
+        results.push_back(std::move(result));
+        if (results.size() >= RESULT_BATCH_SIZE) {
+            deliver(results);
+            results.clear();
+        }
+    }
+    if (!results.empty())
+        deliver(results);
+
+    if (--run->remaining_tasks == 0) {
+        QMetaObject::invokeMethod(self, [self, run]{ self->finish_run(run); },
+            Qt::QueuedConnection);
+    }
+}
+
+BlurhashGenerator::Result BlurhashGenerator::process_job(const Job& job, const Cache& cache)
+{
+    const QString& path = job.path;
+    const QFileInfo fileinfo(path);
+    if (!fileinfo.isFile())
+        return {};
+
+    const qint64 mtime = fileinfo.lastModified().toMSecsSinceEpoch();
+    const qint64 size = fileinfo.size();
+
+    const auto it = cache.find(path);
+    if (it != cache.cend() && it->second.mtime == mtime && it->second.size == size)
+        return Result { job.target_idx, path, it->second, true };
+
+    // unreadable images are stored with an empty hash too, so they aren't retried every time
+    return Result { job.target_idx, path, CacheEntry { mtime, size, hash_image_file(path) }, false };
+}
+
+void BlurhashGenerator::apply_results(const std::shared_ptr<Run>& run, const std::vector<Result>& results)
+{
+    if (run != m_run)
+        return;
+
+    for (const Result& result : results) {
+        m_new_cache[result.path] = result.entry;
+        if (!result.from_cache)
+            run->generated_cnt++;
+
+        const QPointer<model::Assets>& target = m_targets[result.target_idx];
+        if (target && !result.entry.hash.isEmpty())
+            target->set_box_front_blurhash(result.entry.hash);
+    }
+}
+
+void BlurhashGenerator::finish_run(const std::shared_ptr<Run>& run)
+{
+    if (run != m_run)
+        return;
+
+    std::shared_ptr<const Cache> prev_cache;
+    {
+        QMutexLocker lock(&run->cache_guard);
+        prev_cache = run->cache;
+    }
+    const size_t reused_cnt = m_new_cache.size() - run->generated_cnt;
+
+    // the entries of the games not resolved yet are kept,
+    // but those of files no longer used are dropped
+    if (prev_cache && !run->lazy_dirs.isEmpty()) {
+        for (const auto& pair : *prev_cache) {
+            if (run->lazy_dirs.contains(dir_of(pair.first)))
+                m_new_cache.emplace(pair.first, pair.second);
+        }
+    }
+    for (auto& pair : m_late_cache)
+        m_new_cache[pair.first] = std::move(pair.second);
+    m_late_cache.clear();
+    m_late_save_timer.stop();
+
+    const size_t prev_cache_size = prev_cache ? prev_cache->size() : 0;
+    const bool cache_changed = run->generated_cnt > 0 || m_new_cache.size() != prev_cache_size;
+    m_cache = std::make_shared<const Cache>(std::move(m_new_cache));
+    m_new_cache.clear();
+
+    if (cache_changed)
+        save_in_background();
+
+    Log::info(LOGMSG("Blurhash placeholders: %1 created, %2 reused in %3ms")
+        .arg(QString::number(run->generated_cnt), QString::number(reused_cnt), QString::number(run->timer.elapsed())));
+
+    m_run.reset();
+    m_targets.clear();
+
+    std::vector<QPointer<model::Assets>> late_targets;
+    std::swap(late_targets, m_late_targets);
+    for (const QPointer<model::Assets>& assets : late_targets) {
+        if (assets)
+            start_late_job(assets);
+    }
+
+    emit finished();
+}
+
+std::shared_ptr<const BlurhashGenerator::Cache> BlurhashGenerator::load_cache()
+{
+    auto cache = std::make_shared<Cache>();
+
+    QFile file(cache_file_path());
+    if (!file.open(QIODevice::ReadOnly))
+        return cache;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 version = 0;
+    quint32 entry_cnt = 0;
+    stream >> version >> entry_cnt;
+    if (version != CACHE_VERSION || stream.status() != QDataStream::Ok)
+        return cache;
+
+    for (quint32 i = 0; i < entry_cnt; i++) {
+        QString path;
+        CacheEntry entry { 0, 0, QString() };
+        stream >> path >> entry.mtime >> entry.size >> entry.hash;
+        if (stream.status() != QDataStream::Ok) {
+            Log::warning(LOGMSG("The blurhash cache file `%1` seems to be corrupted, ignored")
+                .arg(QDir::toNativeSeparators(file.fileName())));
+            cache->clear();
+            break;
+        }
+        cache->emplace(std::move(path), std::move(entry));
+    }
+    return cache;
+}
+
+void BlurhashGenerator::save_cache(const Cache& cache)
+{
+    const QString cache_path = cache_file_path();
+
+    // NOTE: mkpath() returns true if the dir already exists
+    if (!QDir(paths::writableCacheDir()).mkpath(QStringLiteral("."))) {
+        Log::warning(LOGMSG("Could not create cache directory `%1`").arg(paths::writableCacheDir()));
+        return;
+    }
+
+    QSaveFile file(cache_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        Log::warning(LOGMSG("Could not save the blurhash cache file `%1`: %2")
+            .arg(QDir::toNativeSeparators(cache_path), file.errorString()));
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << CACHE_VERSION << static_cast<quint32>(cache.size());
+    for (const auto& pair : cache)
+        stream << pair.first << pair.second.mtime << pair.second.size << pair.second.hash;
+
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        Log::warning(LOGMSG("Failed to write the blurhash cache file `%1`: %2")
+            .arg(QDir::toNativeSeparators(cache_path), file.errorString()));
+    }
+}
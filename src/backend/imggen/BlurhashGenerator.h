@@ -0,0 +1,98 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include "utils/HashMap.h"
+
+#include <QFuture>
+#include <QObject>
+#include <QPointer>
+#include <QThreadPool>
+#include <QTimer>
+#include <memory>
+#include <vector>
+
+namespace model { class Assets; }
+namespace model { struct GameRowRef; }
+
+
+/// Creates the blurhash placeholders of the games' box front images
+///
+/// The images are read and encoded on a pool of low priority threads, and
+/// the results are set on the Assets objects as they arrive. The hashes are
+/// stored in a cache file, and reused as long as the file's modification
+/// time and size doesn't change. Games whose box front is in a lazily read
+/// media directory are only hashed after the Assets object has read it.
+class BlurhashGenerator : public QObject {
+    Q_OBJECT
+
+public:
+    explicit BlurhashGenerator(QObject* parent = nullptr);
+    ~BlurhashGenerator();
+
+    /// Starts generating the hashes of the games, cancelling the previous run
+    void start(const std::vector<model::GameRowRef>&);
+    /// Stops the current run; the results already set are kept
+    void cancel();
+
+signals:
+    void finished();
+
+private:
+    struct CacheEntry {
+        qint64 mtime;
+        qint64 size;
+        QString hash;
+    };
+    using Cache = HashMap<QString, CacheEntry>;
+
+    struct Job;
+    struct Result;
+    struct Run;
+
+    QThreadPool m_pool;
+    std::shared_ptr<Run> m_run;
+    std::vector<QPointer<model::Assets>> m_targets;
+
+    std::shared_ptr<const Cache> m_cache;
+    Cache m_new_cache;
+    QFuture<void> m_save_future;
+
+    // the games waiting for their lazy directories, and those resolved
+    // during a run; the new hashes of these are saved in batches
+    std::vector<QPointer<model::Assets>> m_lazy_targets;
+    std::vector<QPointer<model::Assets>> m_late_targets;
+    Cache m_late_cache;
+    QTimer m_late_save_timer;
+
+    static void run_task(BlurhashGenerator*, std::shared_ptr<Run>, size_t task_idx, size_t task_cnt);
+    static Result process_job(const Job&, const Cache&);
+    static std::shared_ptr<const Cache> load_cache();
+    static void save_cache(const Cache&);
+
+    void apply_results(const std::shared_ptr<Run>&, const std::vector<Result>&);
+    void finish_run(const std::shared_ptr<Run>&);
+    void save_in_background();
+
+    void wait_for_lazy_dirs(model::Assets&, Run&);
+    void on_lazy_dirs_resolved(model::Assets*);
+    void start_late_job(model::Assets*);
+    void apply_late_result(const QPointer<model::Assets>&, const Result&);
+    void save_late_results();
+};
@@ -17,8 +17,11 @@
 
 #include "BlurhashProvider.h"
 
+#include "Srgb.h"
+
 #include <QHash>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 
@@ -63,27 +66,6 @@ unsigned decode_base83(QStringView str)
 }
 
 
-float srgb_to_linear(uint8_t srgb_val)
-{
-    // NOTE: See "sRGB reverse transformation"
-    const float u = srgb_val / 255.f;
-    return u <= 0.4045f
-        ? u / 12.92f
-        : std::pow((u + 0.055f) / 1.055f, 2.4f);
-}
-
-
-uint8_t linear_to_srgb(float linear_val)
-{
-    // NOTE: See "sRGB forward transformation"
-    const float u = std::max(0.f, std::min(linear_val, 1.f));
-    const float g = u <= 0.0031308f
-        ? u * 12.92
-        : 1.055 * std::pow(u, 1.f / 2.4f) - 0.055f;
-    return std::round(g * 255.f + 0.5f);
-}
-
-
 float unquant_ac_component(float quant, float max_ac)
 {
     const float base = quant - 9.f;
@@ -93,11 +75,11 @@ float unquant_ac_component(float quant, float max_ac)
 
 FpColor decode_dc(unsigned raw_val)
 {
-    const float b = srgb_to_linear(raw_val & 0xFF);
+    const float b = imggen::srgb_to_linear(raw_val & 0xFF);
     raw_val >>= 8;
-    const float g = srgb_to_linear(raw_val & 0xFF);
+    const float g = imggen::srgb_to_linear(raw_val & 0xFF);
     raw_val >>= 8;
-    const float r = srgb_to_linear(raw_val & 0xFF);
+    const float r = imggen::srgb_to_linear(raw_val & 0xFF);
     return { r, g, b };
 }
 
@@ -115,31 +97,41 @@ FpColor decode_ac(unsigned raw_val, float max_ac)
 }
 
 
-std::vector<float> create_cos_table(unsigned components, unsigned image_dim)
+// The basis values of a row or column, in pixel-major order
+std::vector<float> create_cos_table(unsigned components, int image_dim)
 {
     std::vector<float> out(components * image_dim);
-    for (size_t i = 0; i < out.size(); i++)
-        out[i] = std::cos(M_PI * i / image_dim);
+    for (int pixel = 0; pixel < image_dim; pixel++) {
+        for (unsigned comp = 0; comp < components; comp++)
+            out[pixel * components + comp] = std::cos(M_PI * pixel * comp / image_dim);
+    }
     return out;
 }
-} // namespace
 
 
-BlurhashProvider::BlurhashProvider()
-    : QQuickImageProvider(QQuickImageProvider::Image)
-{}
+std::vector<FpColor> decode_colors(const QString& hash, size_t color_cnt, float max_ac)
+{
+    std::vector<FpColor> out;
+    out.reserve(color_cnt);
 
+    const unsigned avg_color_raw = decode_base83(hash.midRef(2, 4));
+    out.emplace_back(decode_dc(avg_color_raw));
 
-QImage BlurhashProvider::requestImage(const QString& hash_url, QSize* out_size, const QSize& requested_size)
+    for (size_t i = 1; i < color_cnt; i++) {
+        const int str_start = 4 + i * 2;
+        const unsigned color_raw = decode_base83(hash.midRef(str_start, 2));
+        out.emplace_back(decode_ac(color_raw, max_ac));
+    }
+
+    return out;
+}
+
+
+QImage decode(const QString& hash, const QSize& img_size)
 {
-    const QString hash = QUrl::fromPercentEncoding(hash_url.toLatin1());
     if (hash.length() < BLURHASH_MIN_LEN)
         return {};
 
-    const QSize img_size = requested_size.isEmpty()
-        ? QSize(24, 24)
-        : requested_size;
-
     const unsigned components_raw = decode_base83(hash.leftRef(1));
     const unsigned components_x = (components_raw % 9) + 1;
     const unsigned components_y = (components_raw / 9) + 1;
@@ -150,52 +142,105 @@ QImage BlurhashProvider::requestImage(const QString& hash_url, QSize* out_size,
     const unsigned max_ac_raw = decode_base83(hash.midRef(1, 1));
     const float max_ac = (max_ac_raw + 1) / 166.f;
 
-    const std::vector<FpColor> colors = [color_cnt, max_ac, &hash](){
-        std::vector<FpColor> out;
-        out.reserve(color_cnt);
+    const std::vector<FpColor> colors = decode_colors(hash, color_cnt, max_ac);
+    const std::vector<float> cos_x_table = create_cos_table(components_x, img_size.width());
+    const std::vector<float> cos_y_table = create_cos_table(components_y, img_size.height());
 
-        const unsigned avg_color_raw = decode_base83(hash.midRef(2, 4));
-        out.emplace_back(decode_dc(avg_color_raw));
+    // The basis functions are separable, so first the horizontal sums are
+    // calculated for every row of components, then the rows are combined
+    // for every line of the image. The line buffers store the channels
+    // interleaved, so the inner loops read the memory sequentially. These
+    // are plain scalar loops: no SIMD is used, and at the default -O2 the
+    // compilers we build with don't vectorize them either.
+    const size_t line_len = img_size.width() * 3;
 
-        for (size_t i = 1; i < color_cnt; i++) {
-            const int str_start = 4 + i * 2;
-            const unsigned color_raw = decode_base83(hash.midRef(str_start, 2));
-            out.emplace_back(decode_ac(color_raw, max_ac));
-        }
+    std::vector<float> component_rows(components_y * line_len);
+    for (unsigned cy = 0; cy < components_y; cy++) {
+        float* const row = component_rows.data() + cy * line_len;
+        const FpColor* const row_colors = colors.data() + cy * components_x;
 
-        return out;
-    }();
+        for (int img_x = 0; img_x < img_size.width(); img_x++) {
+            const float* const basis = cos_x_table.data() + img_x * components_x;
 
-    const std::vector<float> cos_x_table = create_cos_table(components_x, img_size.width());
-    const std::vector<float> cos_y_table = create_cos_table(components_y, img_size.height());
+            FpColor sum { 0.f, 0.f, 0.f };
+            for (unsigned cx = 0; cx < components_x; cx++) {
+                sum.r += row_colors[cx].r * basis[cx];
+                sum.g += row_colors[cx].g * basis[cx];
+                sum.b += row_colors[cx].b * basis[cx];
+            }
+            row[img_x * 3 + 0] = sum.r;
+            row[img_x * 3 + 1] = sum.g;
+            row[img_x * 3 + 2] = sum.b;
+        }
+    }
+
+    const auto& srgb_table = imggen::linear_to_srgb_table();
 
     QImage out_img(img_size, QImage::Format_RGB888);
-    uchar* const out_img_data = out_img.bits();
+    std::vector<float> line(line_len);
 
     for (int img_y = 0; img_y < img_size.height(); img_y++) {
-        for (int img_x = 0; img_x < img_size.width(); img_x++) {
-            FpColor out_color { 0, 0, 0 };
-
-            for (unsigned cy = 0; cy < components_y; cy++) {
-                for (unsigned cx = 0; cx < components_x; cx++) {
-                    const float basis = cos_x_table[img_x * cx] * cos_y_table[img_y * cy];
-                    const size_t color_idx = cy * components_x + cx;
-                    const FpColor color = colors[color_idx];
-
-                    out_color.r += color.r * basis;
-                    out_color.g += color.g * basis;
-                    out_color.b += color.b * basis;
-                }
-            }
-
-            const size_t pixeldata_idx = (img_y * img_size.width() + img_x) * 3;
-            out_img_data[pixeldata_idx + 0] = linear_to_srgb(out_color.r);
-            out_img_data[pixeldata_idx + 1] = linear_to_srgb(out_color.g);
-            out_img_data[pixeldata_idx + 2] = linear_to_srgb(out_color.b);
+        const float* const basis = cos_y_table.data() + img_y * components_y;
+
+        std::fill(line.begin(), line.end(), 0.f);
+        for (unsigned cy = 0; cy < components_y; cy++) {
+            const float weight = basis[cy];
+            const float* const row = component_rows.data() + cy * line_len;
+            for (size_t i = 0; i < line_len; i++)
+                line[i] += weight * row[i];
         }
+
+        uchar* const out_line = out_img.scanLine(img_y);
+        for (size_t i = 0; i < line_len; i++)
+            out_line[i] = imggen::linear_to_srgb(srgb_table, line[i]);
+    }
+
+    return out_img;
+}
+} // namespace
+
+
+BlurhashProvider::BlurhashProvider(int cache_max_kb)
+    : QQuickImageProvider(QQuickImageProvider::Image)
+    , m_cache(cache_max_kb)
+{}
+
+
+QImage BlurhashProvider::requestImage(const QString& hash_url, QSize* out_size, const QSize& requested_size)
+{
+    const QString hash = QUrl::fromPercentEncoding(hash_url.toLatin1());
+    const QSize img_size = requested_size.isEmpty()
+        ? QSize(24, 24)
+        : requested_size;
+
+    const QString cache_key = QStringLiteral("%1@%2x%3")
+        .arg(hash, QString::number(img_size.width()), QString::number(img_size.height()));
+
+    QImage out_img;
+    {
+        QMutexLocker lock(&m_cache_guard);
+        const QImage* const cached = m_cache.object(cache_key);
+        if (cached)
+            out_img = *cached;
+    }
+
+    if (out_img.isNull()) {
+        out_img = decode(hash, img_size);
+        if (out_img.isNull())
+            return {};
+
+        const int cost_kb = std::max(1, static_cast<int>(out_img.sizeInBytes() / 1024));
+        QMutexLocker lock(&m_cache_guard);
+        m_cache.insert(cache_key, new QImage(out_img), cost_kb);
     }
 
     if (out_size)
         *out_size = img_size;
     return out_img;
 }
+
+void BlurhashProvider::clearCache()
+{
+    QMutexLocker lock(&m_cache_guard);
+    m_cache.clear();
+}
@@ -17,12 +17,21 @@
 
 #pragma once
 
+#include <QCache>
+#include <QMutex>
 #include <QQuickImageProvider>
 
 
 class BlurhashProvider : public QQuickImageProvider {
 public:
-    BlurhashProvider();
+    /// The decoded images are kept in a least recently used cache of the given size
+    explicit BlurhashProvider(int cache_max_kb = 8192);
 
     QImage requestImage(const QString&, QSize*, const QSize&) override;
+    void clearCache();
+
+private:
+    // images may be requested from multiple threads
+    QMutex m_cache_guard;
+    QCache<QString, QImage> m_cache;
 };
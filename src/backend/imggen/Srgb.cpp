@@ -0,0 +1,59 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "Srgb.h"
+
+#include <cmath>
+
+
+namespace imggen {
+
+const std::array<float, 256>& srgb_to_linear_table()
+{
+    static const std::array<float, 256> table = [](){
+        std::array<float, 256> out;
+        for (size_t i = 0; i < out.size(); i++) {
+            // NOTE: See "sRGB reverse transformation"
+            const float u = i / 255.f;
+            out[i] = u <= 0.04045f
+                ? u / 12.92f
+                : std::pow((u + 0.055f) / 1.055f, 2.4f);
+        }
+        return out;
+    }();
+    return table;
+}
+
+const std::array<uint8_t, LINEAR_TO_SRGB_STEPS + 1>& linear_to_srgb_table()
+{
+    static const std::array<uint8_t, LINEAR_TO_SRGB_STEPS + 1> table = [](){
+        std::array<uint8_t, LINEAR_TO_SRGB_STEPS + 1> out;
+        for (size_t i = 0; i < out.size(); i++) {
+            // NOTE: See "sRGB forward transformation"
+            const float u = static_cast<float>(i) / LINEAR_TO_SRGB_STEPS;
+            const float g = u <= 0.0031308f
+                ? u * 12.92f
+                : 1.055f * std::pow(u, 1.f / 2.4f) - 0.055f;
+            out[i] = static_cast<uint8_t>(std::min(255L, std::lround(g * 255.f)));
+        }
+        return out;
+    }();
+    return table;
+}
+
+} // namespace imggen
@@ -0,0 +1,52 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace imggen {
+
+// The resolution of the linear to sRGB table; the steps are below one sRGB level
+constexpr int LINEAR_TO_SRGB_STEPS = 4096;
+
+const std::array<float, 256>& srgb_to_linear_table();
+const std::array<uint8_t, LINEAR_TO_SRGB_STEPS + 1>& linear_to_srgb_table();
+
+inline float srgb_to_linear(uint8_t srgb_val)
+{
+    return srgb_to_linear_table()[srgb_val];
+}
+
+/// Values outside the [0, 1] range are clamped
+inline uint8_t linear_to_srgb(const std::array<uint8_t, LINEAR_TO_SRGB_STEPS + 1>& table, float linear_val)
+{
+    const float u = std::max(0.f, std::min(linear_val, 1.f));
+    return table[static_cast<size_t>(u * LINEAR_TO_SRGB_STEPS + 0.5f)];
+}
+
+inline uint8_t linear_to_srgb(float linear_val)
+{
+    return linear_to_srgb(linear_to_srgb_table(), linear_val);
+}
+
+} // namespace imggen
@@ -0,0 +1,213 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "ThumbnailCache.h"
+
+#include "Log.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QStringBuilder>
+#include <algorithm>
+#include <vector>
+
+
+namespace {
+constexpr int JPEG_QUALITY = 90;
+
+QSize fit_size(const QSize& full_size, const QSize& requested_size)
+{
+    const bool has_width = requested_size.width() > 0;
+    const bool has_height = requested_size.height() > 0;
+    if (!full_size.isValid() || (!has_width && !has_height))
+        return full_size;
+
+    QSize out = full_size;
+    if (has_width && has_height) {
+        out = full_size.scaled(requested_size, Qt::KeepAspectRatio);
+    }
+    else if (has_width) {
+        out.setWidth(requested_size.width());
+        out.setHeight(qRound(static_cast<qreal>(full_size.height()) * requested_size.width() / full_size.width()));
+    }
+    else {
+        out.setHeight(requested_size.height());
+        out.setWidth(qRound(static_cast<qreal>(full_size.width()) * requested_size.height() / full_size.height()));
+    }
+
+    // never upscale
+    if (out.width() >= full_size.width() || out.height() >= full_size.height())
+        return full_size;
+
+    return out.expandedTo(QSize(1, 1));
+}
+
+QString cache_key(const QFileInfo& fileinfo, const QSize& requested_size)
+{
+    const QString key_src = fileinfo.absoluteFilePath()
+        % QLatin1Char('\n') % QString::number(fileinfo.lastModified().toMSecsSinceEpoch())
+        % QLatin1Char('\n') % QString::number(fileinfo.size())
+        % QLatin1Char('\n') % QString::number(requested_size.width())
+        % QLatin1Char('x') % QString::number(requested_size.height());
+
+    const QByteArray hash = QCryptographicHash::hash(key_src.toUtf8(), QCryptographicHash::Sha1);
+    return QString::fromLatin1(hash.toHex());
+}
+
+void write_to_disk(const QString& path, const QImage& image)
+{
+    // NOTE: mkpath() returns true if the dir already exists
+    if (!QDir().mkpath(QFileInfo(path).path()))
+        return;
+
+    // the format is detected from the content when reading
+    const bool has_alpha = image.hasAlphaChannel();
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)
+        || !image.save(&file, has_alpha ? "PNG" : "JPG", has_alpha ? -1 : JPEG_QUALITY)
+        || !file.commit())
+    {
+        Log::warning(LOGMSG("Could not write thumbnail cache file `%1`: %2")
+            .arg(QDir::toNativeSeparators(path), file.errorString()));
+    }
+}
+} // namespace
+
+
+ThumbnailCache::ThumbnailCache(QString disk_dir, int memory_max_kb)
+    : m_disk_dir(std::move(disk_dir))
+    , m_memory(memory_max_kb)
+{}
+
+QImage ThumbnailCache::get(const QString& path, const QSize& requested_size, QString* error)
+{
+    const QFileInfo fileinfo(path);
+    if (!fileinfo.isFile()) {
+        if (error)
+            *error = LOGMSG("File `%1` not found").arg(QDir::toNativeSeparators(path));
+        return {};
+    }
+
+    const QString key = cache_key(fileinfo, requested_size);
+    QImage image = find_in_memory(key);
+    if (!image.isNull())
+        return image;
+
+    const QString thumb_path = disk_path(key);
+    if (QFileInfo::exists(thumb_path)) {
+        QImageReader thumb_reader(thumb_path);
+        image = thumb_reader.read();
+        if (image.isNull())
+            QFile::remove(thumb_path);
+    }
+
+    if (image.isNull()) {
+        QImageReader reader(path);
+        const QSize full_size = reader.size();
+        const QSize thumb_size = fit_size(full_size, requested_size);
+
+        // most formats can decode at a smaller size directly, for the rest the reader scales it
+        const bool is_downscaled = thumb_size != full_size;
+        if (is_downscaled)
+            reader.setScaledSize(thumb_size);
+
+        image = reader.read();
+        if (image.isNull()) {
+            if (error)
+                *error = reader.errorString();
+            return {};
+        }
+
+        // only the downscaled images are worth storing on the disk
+        if (is_downscaled)
+            write_to_disk(thumb_path, image);
+    }
+
+    store_in_memory(key, image);
+    return image;
+}
+
+QImage ThumbnailCache::find_in_memory(const QString& key)
+{
+    QMutexLocker lock(&m_memory_guard);
+    const QImage* const image = m_memory.object(key);
+    return image ? *image : QImage();
+}
+
+void ThumbnailCache::store_in_memory(const QString& key, const QImage& image)
+{
+    const int cost_kb = std::max(1, static_cast<int>(image.sizeInBytes() / 1024));
+
+    QMutexLocker lock(&m_memory_guard);
+    m_memory.insert(key, new QImage(image), cost_kb);
+}
+
+void ThumbnailCache::clear_memory()
+{
+    QMutexLocker lock(&m_memory_guard);
+    m_memory.clear();
+}
+
+QString ThumbnailCache::disk_path(const QString& key) const
+{
+    // split into subdirectories, to keep the directory sizes reasonable
+    return m_disk_dir % QLatin1Char('/') % key.leftRef(2) % QLatin1Char('/') % key;
+}
+
+void ThumbnailCache::prune_disk(qint64 max_bytes) const
+{
+    struct Entry {
+        QString path;
+        qint64 mtime;
+        qint64 size;
+    };
+    std::vector<Entry> entries;
+    qint64 total_size = 0;
+
+    QDirIterator dir_it(m_disk_dir, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (dir_it.hasNext()) {
+        dir_it.next();
+        const QFileInfo fileinfo = dir_it.fileInfo();
+        entries.push_back({ fileinfo.filePath(), fileinfo.lastModified().toMSecsSinceEpoch(), fileinfo.size() });
+        total_size += fileinfo.size();
+    }
+    if (total_size <= max_bytes)
+        return;
+
+    std::sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b){ return a.mtime < b.mtime; });
+
+    // remove a bit more, so this doesn't have to run every time
+    const qint64 target_size = max_bytes / 4 * 3;
+    size_t removed_cnt = 0;
+    for (const Entry& entry : entries) {
+        if (total_size <= target_size)
+            break;
+        if (QFile::remove(entry.path)) {
+            total_size -= entry.size;
+            removed_cnt++;
+        }
+    }
+
+    Log::info(LOGMSG("Removed %1 old thumbnails from the cache").arg(QString::number(removed_cnt)));
+}
@@ -0,0 +1,60 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include "utils/NoCopyNoMove.h"
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+
+
+/// Downscaled images of local files, kept both in memory and on the disk
+///
+/// The memory cache is a least recently used list of limited size. On the
+/// disk, the thumbnails are stored under the hash of the source file's path,
+/// modification time, size and the requested size, so changed files get new
+/// entries automatically. All functions are thread safe.
+class ThumbnailCache {
+public:
+    explicit ThumbnailCache(QString disk_dir, int memory_max_kb = 65536);
+    NO_COPY_NO_MOVE(ThumbnailCache)
+
+    /// Returns the image scaled down to fit in the requested size, keeping its aspect ratio.
+    /// If only one dimension is set, the other is calculated from the aspect ratio;
+    /// if none, or the image is already small enough, the original size is used.
+    /// Returns a null image and sets the error message on failure.
+    QImage get(const QString& path, const QSize& requested_size, QString* error = nullptr);
+
+    /// Deletes the oldest thumbnails from the disk if they take more space than the limit
+    void prune_disk(qint64 max_bytes) const;
+    /// Drops the images kept in memory; the disk cache is not affected
+    void clear_memory();
+
+private:
+    const QString m_disk_dir;
+
+    QMutex m_memory_guard;
+    QCache<QString, QImage> m_memory;
+
+    QImage find_in_memory(const QString& key);
+    void store_in_memory(const QString& key, const QImage&);
+    QString disk_path(const QString& key) const;
+};
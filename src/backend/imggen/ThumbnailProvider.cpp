@@ -0,0 +1,111 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "ThumbnailProvider.h"
+
+#include "ThumbnailCache.h"
+
+#include <QFutureWatcher>
+#include <QUrl>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <atomic>
+
+
+namespace {
+struct ThumbnailResult {
+    QImage image;
+    QString error;
+};
+
+
+class ThumbnailResponse : public QQuickImageResponse {
+public:
+    ThumbnailResponse(std::shared_ptr<ThumbnailCache> cache, QString path, QSize size, QThreadPool& pool)
+        : m_canceled(std::make_shared<std::atomic<bool>>(false))
+    {
+        // the watcher is owned by this object, so the result
+        // is not delivered if the engine deleted the response already
+        connect(&m_watcher, &QFutureWatcher<ThumbnailResult>::finished,
+            this, [this]{
+                m_result = m_watcher.result();
+                emit finished();
+            });
+
+        const std::shared_ptr<std::atomic<bool>> canceled = m_canceled;
+        m_watcher.setFuture(QtConcurrent::run(&pool, [cache, path, size, canceled]{
+            ThumbnailResult result;
+
+            // the image may have scrolled out of view while waiting in the queue
+            if (*canceled)
+                return result;
+
+            result.image = cache->get(path, size, &result.error);
+            return result;
+        }));
+    }
+
+    ~ThumbnailResponse() override {
+        // the task doesn't have to run if it's still in the queue
+        *m_canceled = true;
+    }
+
+    QQuickTextureFactory* textureFactory() const override {
+        return QQuickTextureFactory::textureFactoryForImage(m_result.image);
+    }
+    QString errorString() const override {
+        return m_result.error;
+    }
+    void cancel() override {
+        *m_canceled = true;
+    }
+
+private:
+    const std::shared_ptr<std::atomic<bool>> m_canceled;
+    QFutureWatcher<ThumbnailResult> m_watcher;
+    ThumbnailResult m_result;
+};
+
+
+QString path_from_id(const QString& id)
+{
+    const QString decoded = QUrl::fromPercentEncoding(id.toUtf8());
+    return decoded.startsWith(QLatin1String("file:"))
+        ? QUrl(decoded).toLocalFile()
+        : decoded;
+}
+} // namespace
+
+
+ThumbnailProvider::ThumbnailProvider(std::shared_ptr<ThumbnailCache> cache)
+    : m_cache(std::move(cache))
+{
+    // leave one core for the UI thread
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+ThumbnailProvider::~ThumbnailProvider()
+{
+    m_pool.waitForDone();
+}
+
+QQuickImageResponse* ThumbnailProvider::requestImageResponse(const QString& id, const QSize& requested_size)
+{
+    return new ThumbnailResponse(m_cache, path_from_id(id), requested_size, m_pool);
+}
+
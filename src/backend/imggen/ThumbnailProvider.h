@@ -0,0 +1,41 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QQuickAsyncImageProvider>
+#include <QThreadPool>
+#include <memory>
+
+class ThumbnailCache;
+
+
+/// Provides `image://thumb/<file url or path>` images, scaled down to their
+/// `sourceSize` on a pool of worker threads, and cached for later use.
+class ThumbnailProvider : public QQuickAsyncImageProvider {
+public:
+    explicit ThumbnailProvider(std::shared_ptr<ThumbnailCache>);
+    ~ThumbnailProvider() override;
+
+    QQuickImageResponse* requestImageResponse(const QString&, const QSize&) override;
+    const std::shared_ptr<ThumbnailCache>& cache() const { return m_cache; }
+
+private:
+    const std::shared_ptr<ThumbnailCache> m_cache;
+    QThreadPool m_pool;
+};
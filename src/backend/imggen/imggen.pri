@@ -1,5 +1,15 @@
 HEADERS += \
-    $$PWD/BlurhashProvider.h
+    $$PWD/BlurhashEncoder.h \
+    $$PWD/BlurhashGenerator.h \
+    $$PWD/BlurhashProvider.h \
+    $$PWD/Srgb.h \
+    $$PWD/ThumbnailCache.h \
+    $$PWD/ThumbnailProvider.h
 
 SOURCES += \
-    $$PWD/BlurhashProvider.cpp
+    $$PWD/BlurhashEncoder.cpp \
+    $$PWD/BlurhashGenerator.cpp \
+    $$PWD/BlurhashProvider.cpp \
+    $$PWD/Srgb.cpp \
+    $$PWD/ThumbnailCache.cpp \
+    $$PWD/ThumbnailProvider.cpp
@@ -0,0 +1,218 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "AssetPrefetcher.h"
+
+#include "imggen/ThumbnailCache.h"
+#include "imggen/ThumbnailProvider.h"
+#include "model/gaming/Assets.h"
+#include "utils/IoHints.h"
+
+#include <QQmlEngine>
+#include <QUrl>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+// at high speed, the items reached in this time are loaded
+constexpr qreal LOOKAHEAD_SECS = 1.0;
+// but at most this many times the count
+constexpr int MAX_LOOKAHEAD_FACTOR = 4;
+} // namespace
+
+
+namespace model {
+AssetPrefetcher::AssetPrefetcher(QObject* parent)
+    : QObject(parent)
+    , m_assets_role(-1)
+    , m_asset(QStringLiteral("boxFront"))
+    , m_asset_property(m_asset.toLatin1())
+    , m_count(8)
+    , m_generation(std::make_shared<std::atomic<unsigned>>(0))
+{
+    // one thread, so the requests are processed in order
+    m_pool.setMaxThreadCount(1);
+}
+
+AssetPrefetcher::~AssetPrefetcher()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+void AssetPrefetcher::setModel(QAbstractItemModel* model)
+{
+    if (model == m_model)
+        return;
+
+    if (m_model)
+        disconnect(m_model, nullptr, this, nullptr);
+
+    cancel();
+    m_model = model;
+    updateAssetsRole();
+
+    if (m_model) {
+        connect(m_model, &QAbstractItemModel::modelReset, this, &AssetPrefetcher::updateAssetsRole);
+        connect(m_model, &QAbstractItemModel::modelReset, this, &AssetPrefetcher::cancel);
+    }
+    emit modelChanged();
+}
+
+void AssetPrefetcher::setAsset(const QString& asset)
+{
+    if (asset == m_asset)
+        return;
+
+    cancel();
+    m_asset = asset;
+    m_asset_property = asset.toLatin1();
+    emit assetChanged();
+}
+
+void AssetPrefetcher::setSourceSize(const QSize& size)
+{
+    if (size == m_source_size)
+        return;
+
+    cancel();
+    m_source_size = size;
+    emit sourceSizeChanged();
+}
+
+void AssetPrefetcher::setCount(int count)
+{
+    count = std::max(0, count);
+    if (count == m_count)
+        return;
+
+    m_count = count;
+    emit countChanged();
+}
+
+void AssetPrefetcher::updateAssetsRole()
+{
+    m_assets_role = m_model
+        ? m_model->roleNames().key(QByteArrayLiteral("assets"), -1)
+        : -1;
+}
+
+void AssetPrefetcher::cancel()
+{
+    // the running task stops at the next item, the queued ones don't start
+    ++*m_generation;
+    m_pool.clear();
+}
+
+std::vector<int> AssetPrefetcher::rowsToLoad(int index, qreal velocity, int row_cnt) const
+{
+    std::vector<int> rows;
+
+    if (qFuzzyIsNull(velocity)) {
+        for (int dist = 1; static_cast<int>(rows.size()) < m_count; dist++) {
+            const bool has_next = index + dist < row_cnt;
+            const bool has_prev = index - dist >= 0;
+            if (!has_next && !has_prev)
+                break;
+
+            if (has_next)
+                rows.push_back(index + dist);
+            if (has_prev && static_cast<int>(rows.size()) < m_count)
+                rows.push_back(index - dist);
+        }
+        return rows;
+    }
+
+    const int ahead_cnt = std::min(
+        m_count * MAX_LOOKAHEAD_FACTOR,
+        std::max(m_count, static_cast<int>(std::ceil(std::abs(velocity) * LOOKAHEAD_SECS))));
+    const int step = velocity > 0.0 ? 1 : -1;
+    for (int dist = 1; dist <= ahead_cnt; dist++) {
+        const int row = index + dist * step;
+        if (row < 0 || row_cnt <= row)
+            break;
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+std::shared_ptr<ThumbnailCache> AssetPrefetcher::thumbnailCache() const
+{
+    if (!m_source_size.isValid() || m_source_size.isEmpty())
+        return nullptr;
+
+    QQmlEngine* const engine = qmlEngine(this);
+    if (!engine)
+        return nullptr;
+
+    // the `thumb` id is always registered with a ThumbnailProvider
+    QQmlImageProviderBase* const provider = engine->imageProvider(QStringLiteral("thumb"));
+    return provider
+        ? static_cast<ThumbnailProvider*>(provider)->cache()
+        : nullptr;
+}
+
+void AssetPrefetcher::setFocus(int index, qreal velocity)
+{
+    cancel();
+
+    if (!m_model || m_assets_role < 0 || m_count == 0)
+        return;
+
+    const int row_cnt = m_model->rowCount();
+    if (index < 0 || row_cnt <= index)
+        return;
+
+    QStringList paths;
+    for (const int row : rowsToLoad(index, velocity, row_cnt)) {
+        // NOTE: the assets are read directly, so the Game objects of these rows are not created
+        const QVariant assets_var = m_model->data(m_model->index(row, 0), m_assets_role);
+        const auto* const assets = qobject_cast<model::Assets*>(assets_var.value<QObject*>());
+        if (!assets)
+            continue;
+
+        // NOTE: this also starts the search of the lazy media directories, if any
+        const QUrl url(assets->property(m_asset_property.constData()).toString());
+        if (url.isLocalFile())
+            paths.append(url.toLocalFile());
+    }
+    if (paths.isEmpty())
+        return;
+
+    const std::shared_ptr<std::atomic<unsigned>> generation_ptr = m_generation;
+    const unsigned generation = *m_generation;
+    const std::shared_ptr<ThumbnailCache> thumbnails = thumbnailCache();
+    const QSize source_size = m_source_size;
+
+    QtConcurrent::run(&m_pool, [paths, generation_ptr, generation, thumbnails, source_size]{
+        utils::lower_thread_priority();
+
+        for (const QString& path : paths) {
+            if (*generation_ptr != generation)
+                return;
+
+            if (thumbnails)
+                thumbnails->get(path, source_size);
+            else
+                utils::prefetch_file(path);
+        }
+    });
+}
+} // namespace model
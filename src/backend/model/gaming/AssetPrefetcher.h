@@ -0,0 +1,91 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QObject>
+#include <QPointer>
+#include <QSize>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class ThumbnailCache;
+
+
+namespace model {
+/// Loads the assets of the games next to the focused one ahead of time, for QML
+///
+/// Themes report the focused index and scroll velocity of a view, and the
+/// images of the next few games in the direction of the movement are read
+/// on a low priority background thread. If `sourceSize` is set and the
+/// `image://thumb/` provider is available, thumbnails of that size are
+/// created; otherwise the files are loaded into the OS page cache. A new
+/// focus change cancels the previous requests.
+class AssetPrefetcher : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(QAbstractItemModel* model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(QString asset READ asset WRITE setAsset NOTIFY assetChanged)
+    Q_PROPERTY(QSize sourceSize READ sourceSize WRITE setSourceSize NOTIFY sourceSizeChanged)
+    Q_PROPERTY(int count READ count WRITE setCount NOTIFY countChanged)
+
+public:
+    explicit AssetPrefetcher(QObject* parent = nullptr);
+    ~AssetPrefetcher() override;
+
+    QAbstractItemModel* model() const { return m_model; }
+    void setModel(QAbstractItemModel*);
+    const QString& asset() const { return m_asset; }
+    void setAsset(const QString&);
+    const QSize& sourceSize() const { return m_source_size; }
+    void setSourceSize(const QSize&);
+    int count() const { return m_count; }
+    void setCount(int);
+
+    /// The velocity is in items per second; its sign is the direction of the movement,
+    /// and when it's fast, more items are loaded ahead. With zero velocity,
+    /// the items on both sides are loaded.
+    Q_INVOKABLE void setFocus(int index, qreal velocity = 0.0);
+    Q_INVOKABLE void cancel();
+
+    /// The rows loaded by setFocus(), in the order they are loaded
+    std::vector<int> rowsToLoad(int index, qreal velocity, int row_cnt) const;
+
+signals:
+    void modelChanged();
+    void assetChanged();
+    void sourceSizeChanged();
+    void countChanged();
+
+private:
+    QPointer<QAbstractItemModel> m_model;
+    int m_assets_role;
+    QString m_asset;
+    QByteArray m_asset_property;
+    QSize m_source_size;
+    int m_count;
+
+    const std::shared_ptr<std::atomic<unsigned>> m_generation;
+    QThreadPool m_pool;
+
+    void updateAssetsRole();
+    std::shared_ptr<ThumbnailCache> thumbnailCache() const;
+};
+} // namespace model
@@ -17,26 +17,126 @@
 
 #include "Assets.h"
 
+#include "PegasusAssets.h"
+
+#include <QDir>
+#include <QFutureWatcher>
+#include <QHash>
 #include <QUrl>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <limits>
+
+
+namespace {
+using FoundAssets = std::vector<std::pair<AssetType, QString>>;
+
+QString to_url(const QString& value, bool is_file)
+{
+    return is_file
+        ? QUrl::fromLocalFile(value).toString()
+        : value;
+}
+
+// The form used for comparing the entries: the local path
+// for files and `file:` URLs, otherwise the URL itself
+QString dedup_form(const QString& value, bool is_file, bool* is_local)
+{
+    if (!is_file && value.startsWith(QLatin1String("file:"))) {
+        *is_local = true;
+        return QUrl(value).toLocalFile();
+    }
+
+    *is_local = is_file;
+    return value;
+}
+
+quint64 dedup_key(AssetType type, const QString& value, bool is_file)
+{
+    bool is_local = false;
+    const QString form = dedup_form(value, is_file, &is_local);
+    const uint hash = qHash(form) ^ static_cast<uint>(is_local);
+    return (static_cast<quint64>(type) << 32) | hash;
+}
+
+bool same_asset(const QString& value_a, bool is_file_a, const QString& value_b, bool is_file_b)
+{
+    if (is_file_a == is_file_b)
+        return value_a == value_b;
+
+    bool is_local_a = false;
+    bool is_local_b = false;
+    const QString form_a = dedup_form(value_a, is_file_a, &is_local_a);
+    const QString form_b = dedup_form(value_b, is_file_b, &is_local_b);
+    return is_local_a == is_local_b && form_a == form_b;
+}
+
+FoundAssets find_assets_in(const QStringList& dir_paths)
+{
+    constexpr auto dir_filters = QDir::Files | QDir::Readable | QDir::NoDotAndDotDot;
+    constexpr auto dir_sort = QDir::Name;
+
+    FoundAssets out;
+    for (const QString& dir_path : dir_paths) {
+        const QFileInfoList entries = QDir(dir_path).entryInfoList(dir_filters, dir_sort);
+        for (const QFileInfo& fileinfo : entries) {
+            const AssetType asset_type = pegasus_assets::detect_media_type(fileinfo.completeBaseName(), fileinfo.suffix());
+            if (asset_type != AssetType::UNKNOWN)
+                out.emplace_back(asset_type, fileinfo.filePath());
+        }
+    }
+    return out;
+}
+} // namespace
 
 
 namespace model {
+static_assert(ASSET_TYPE_COUNT <= std::numeric_limits<unsigned>::digits,
+              "The URL cache validity mask is too small");
 
 Assets::Assets(QObject* parent)
     : QObject(parent)
-{}
+    , m_url_cache_valid(0)
+    , m_lazy_running(false)
+{
+    m_offsets.fill(0);
+}
 
-const QStringList& Assets::get(AssetType key) const {
-    static const QStringList empty;
+Assets::~Assets() = default;
 
-    const auto it = m_asset_lists.find(key);
-    if (it != m_asset_lists.cend())
-        return it->second;
+const QStringList& Assets::get(AssetType key) const
+{
+    static const QStringList empty;
 
-    return empty;
+    // NOTE: the getters are const for QML, but the lazy resolution is
+    //       invisible for the callers
+    if (!m_lazy_dirs.isEmpty() && !m_lazy_running)
+        const_cast<Assets*>(this)->resolve_lazy_dirs();
+
+    const size_t type_idx = static_cast<size_t>(key);
+    const size_t begin = m_offsets[type_idx];
+    const size_t end = m_offsets[type_idx + 1];
+    if (begin == end)
+        return empty;
+
+    if (!m_url_cache)
+        m_url_cache.reset(new UrlCache());
+
+    QStringList& urls = (*m_url_cache)[type_idx];
+    const unsigned type_bit = 1u << type_idx;
+    if (!(m_url_cache_valid & type_bit)) {
+        urls.clear();
+        urls.reserve(static_cast<int>(end - begin));
+        for (size_t i = begin; i < end; i++)
+            urls.append(to_url(m_entries[i].value, m_entries[i].is_file));
+
+        m_url_cache_valid |= type_bit;
+    }
+    return urls;
 }
 
-const QString& Assets::getFirst(AssetType key) const {
+const QString& Assets::getFirst(AssetType key) const
+{
     static const QString empty;
 
     const QStringList& list = get(key);
@@ -46,19 +146,98 @@ const QString& Assets::getFirst(AssetType key) const {
     return empty;
 }
 
+QString Assets::first_file_path(AssetType key) const
+{
+    const size_t type_idx = static_cast<size_t>(key);
+    const size_t begin = m_offsets[type_idx];
+    const size_t end = m_offsets[type_idx + 1];
+    if (begin == end || !m_entries[begin].is_file)
+        return QString();
+
+    return m_entries[begin].value;
+}
+
+Assets& Assets::set_box_front_blurhash(QString hash)
+{
+    if (hash != m_box_front_blurhash) {
+        m_box_front_blurhash = std::move(hash);
+        emit blurhashChanged();
+    }
+    return *this;
+}
+
 Assets& Assets::add_file(AssetType key, QString path)
 {
-    QString uri = QUrl::fromLocalFile(std::move(path)).toString();
-    return add_uri(key, std::move(uri));
+    return add_entry(key, std::move(path), true);
 }
 
 Assets& Assets::add_uri(AssetType key, QString url)
 {
-    QStringList& target = m_asset_lists[key];
+    return add_entry(key, std::move(url), false);
+}
+
+Assets& Assets::add_lazy_dir(QString dir_path)
+{
+    if (!dir_path.isEmpty() && !m_lazy_dirs.contains(dir_path))
+        m_lazy_dirs.append(std::move(dir_path));
+
+    return *this;
+}
 
-    if (!url.isEmpty() && !target.contains(url))
-        target.append(std::move(url));
+void Assets::resolve_lazy_dirs()
+{
+    Q_ASSERT(!m_lazy_dirs.isEmpty());
+    Q_ASSERT(!m_lazy_running);
+    m_lazy_running = true;
+
+    // the watcher is owned by this object, so the result
+    // is not delivered if this object is already deleted
+    auto* const watcher = new QFutureWatcher<FoundAssets>(this);
+    connect(watcher, &QFutureWatcher<FoundAssets>::finished,
+        this, [this, watcher]{
+            const FoundAssets found = watcher->result();
+            watcher->deleteLater();
+
+            for (const auto& pair : found)
+                add_file(pair.first, pair.second);
+
+            m_lazy_dirs.clear();
+            m_lazy_running = false;
+            if (!found.empty())
+                emit assetsChanged();
+        });
+
+    const QStringList dir_paths = m_lazy_dirs;
+    watcher->setFuture(QtConcurrent::run([dir_paths]{ return find_assets_in(dir_paths); }));
+}
 
+Assets& Assets::add_entry(AssetType key, QString value, bool is_file)
+{
+    if (value.isEmpty())
+        return *this;
+
+    const size_t type_idx = static_cast<size_t>(key);
+    const size_t begin = m_offsets[type_idx];
+    const size_t end = m_offsets[type_idx + 1];
+
+    // the strings are compared only on a hash match
+    const quint64 dedup = dedup_key(key, value, is_file);
+    const auto key_it = std::lower_bound(m_dedup_keys.begin(), m_dedup_keys.end(), dedup);
+    if (key_it != m_dedup_keys.end() && *key_it == dedup) {
+        for (size_t i = begin; i < end; i++) {
+            const Entry& entry = m_entries[i];
+            if (same_asset(entry.value, entry.is_file, value, is_file))
+                return *this;
+        }
+    }
+
+    Q_ASSERT(m_entries.size() < std::numeric_limits<unsigned short>::max());
+    m_dedup_keys.insert(key_it, dedup);
+    m_entries.insert(m_entries.begin() + end, Entry { std::move(value), is_file });
+    for (size_t i = type_idx + 1; i < m_offsets.size(); i++)
+        m_offsets[i]++;
+
+    m_url_cache_valid &= ~(1u << type_idx);
     return *this;
 }
 
@@ -18,11 +18,12 @@
 #pragma once
 
 #include "types/AssetType.h"
-#include "utils/HashMap.h"
-#include "utils/MoveOnly.h"
 
 #include <QStringList>
 #include <QObject>
+#include <array>
+#include <memory>
+#include <vector>
 
 
 namespace model {
@@ -37,8 +38,8 @@ public:
 #define GEN(qmlname, enumname) \
     const QString& qmlname() const { return getFirst(AssetType::enumname); } \
     const QStringList& qmlname##List() const { return get(AssetType::enumname); } \
-    Q_PROPERTY(QString qmlname READ qmlname CONSTANT) \
-    Q_PROPERTY(QStringList qmlname##List READ qmlname##List CONSTANT) \
+    Q_PROPERTY(QString qmlname READ qmlname NOTIFY assetsChanged) \
+    Q_PROPERTY(QStringList qmlname##List READ qmlname##List NOTIFY assetsChanged) \
 
     GEN(boxFront, BOX_FRONT)
     GEN(boxBack, BOX_BACK)
@@ -66,20 +67,72 @@ public:
 
     // deprecated fallacks
     // TODO: remove
-    Q_PROPERTY(QStringList screenshots READ screenshotList CONSTANT)
-    Q_PROPERTY(QStringList videos READ videoList CONSTANT)
+    Q_PROPERTY(QStringList screenshots READ screenshotList NOTIFY assetsChanged)
+    Q_PROPERTY(QStringList videos READ videoList NOTIFY assetsChanged)
+
+    // A small placeholder of the box front image, for `image://blurhash/`;
+    // generated in the background, so it may be empty at first
+    const QString& boxFrontBlurhash() const { return m_box_front_blurhash; }
+    Q_PROPERTY(QString boxFrontBlurhash READ boxFrontBlurhash NOTIFY blurhashChanged)
 
 public:
     explicit Assets(QObject* parent);
+    ~Assets();
 
     Assets& add_file(AssetType, QString);
     Assets& add_uri(AssetType, QString);
 
+    // Registers a directory that may contain media files of this item.
+    // The directory is not read until one of the assets is requested,
+    // then it's searched on a worker thread.
+    Assets& add_lazy_dir(QString);
+    /// The directories not searched yet
+    const QStringList& lazy_dirs() const { return m_lazy_dirs; }
+
+    /// The path of the first asset of the type, if it's a local file;
+    /// unlike the QML getters, this doesn't search the lazy directories
+    QString first_file_path(AssetType) const;
+
+    Assets& set_box_front_blurhash(QString);
+
+signals:
+    void assetsChanged();
+    void blurhashChanged();
+
 private:
     const QStringList& get(AssetType) const;
     const QString& getFirst(AssetType) const;
 
-    HashMap<AssetType, QStringList, EnumHash> m_asset_lists;
+    // NOTE: The entries of all asset types are stored in one flat buffer,
+    //       grouped by type; `m_offsets[type]` is the index of the first
+    //       entry of `type`, `m_offsets[type + 1]` is one past the last.
+    //       Local files are kept as raw paths, and converted to URLs only
+    //       when they are first read.
+    struct Entry {
+        QString value;
+        bool is_file;
+    };
+    std::vector<Entry> m_entries;
+    std::array<unsigned short, ASSET_TYPE_COUNT + 1> m_offsets;
+
+    // NOTE: Sorted (type, hash) keys of the entries, for detecting duplicates
+    //       without scanning the buffer. The hash is calculated from the local
+    //       path for files and `file:` URLs, so the same file added both as
+    //       a path and as a URL is stored only once.
+    std::vector<quint64> m_dedup_keys;
+
+    using UrlCache = std::array<QStringList, ASSET_TYPE_COUNT>;
+    mutable std::unique_ptr<UrlCache> m_url_cache;
+    mutable unsigned m_url_cache_valid;
+
+    Assets& add_entry(AssetType, QString, bool);
+
+    QStringList m_lazy_dirs;
+    bool m_lazy_running;
+
+    void resolve_lazy_dirs();
+
+    QString m_box_front_blurhash;
 };
 
 } // namespace model
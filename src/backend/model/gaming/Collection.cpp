@@ -37,7 +37,7 @@ void CollectionData::set_short_name(const QString& name)
 
 Collection::Collection(QString name, QObject* parent)
     : QObject(parent)
-    , m_games(new QQmlObjectListModel<model::Game>(this))
+    , m_games(new model::GameListModel(this))
     , m_data(std::move(name))
     , m_assets(new model::Assets(this))
 {}
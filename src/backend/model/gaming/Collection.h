@@ -17,7 +17,8 @@
 
 #pragma once
 
-#include "QtQmlTricks/QQmlObjectListModel.h"
+#include "model/gaming/GameListModel.h"
+
 #include <QString>
 
 #ifdef Q_CC_MSVC
@@ -94,8 +95,13 @@ public:
     Q_PROPERTY(model::Assets* assets READ assetsPtr CONSTANT)
 
     Collection& setGames(std::vector<model::Game*>&&);
-    const QVector<model::Game*>& gamesConst() const { Q_ASSERT(!m_games->isEmpty()); return m_games->asList(); }
-    QML_OBJMODEL_PROPERTY(model::Game, games)
+    // NOTE: this creates the Game objects of the collection
+    QVector<model::Game*> gamesConst() const { Q_ASSERT(!m_games->isEmpty()); return m_games->asList(); }
+    Q_PROPERTY(model::GameListModel* games READ gamesModel CONSTANT)
+
+private:
+    GameListModel* const m_games;
+    GameListModel* gamesModel() const { return m_games; }
 
 public:
     explicit Collection(QString name, QObject* parent = nullptr);
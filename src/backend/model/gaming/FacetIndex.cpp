@@ -0,0 +1,158 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "FacetIndex.h"
+
+#include "model/gaming/Game.h"
+#include "model/gaming/GameStore.h"
+#include "utils/HashMap.h"
+
+#include <algorithm>
+#include <map>
+
+
+namespace {
+constexpr int MAX_LISTED_PLAYERS = 4;
+
+std::vector<model::FacetIndex::Value> create_genre_values(const std::vector<model::GameRowRef>& refs)
+{
+    std::vector<model::FacetIndex::Value> out;
+    HashMap<QString, size_t> name_to_idx;
+
+    for (size_t row = 0; row < refs.size(); row++) {
+        for (const QString& genre : refs[row].store->genres[refs[row].row]) {
+            auto it = name_to_idx.find(genre);
+            if (it == name_to_idx.end()) {
+                it = name_to_idx.emplace(genre, out.size()).first;
+                out.push_back({ genre, utils::Bitset(refs.size()) });
+            }
+            out[it->second].rows.set(row);
+        }
+    }
+
+    std::sort(out.begin(), out.end(),
+        [](const model::FacetIndex::Value& a, const model::FacetIndex::Value& b){
+            return QString::localeAwareCompare(a.name, b.name) < 0;
+        });
+    return out;
+}
+
+std::vector<model::FacetIndex::Value> create_player_values(const std::vector<model::GameRowRef>& refs)
+{
+    std::vector<model::FacetIndex::Value> out;
+    for (int players = 1; players <= MAX_LISTED_PLAYERS; players++) {
+        QString name = QString::number(players);
+        if (players == MAX_LISTED_PLAYERS)
+            name += QChar('+');
+        out.push_back({ std::move(name), utils::Bitset(refs.size()) });
+    }
+
+    for (size_t row = 0; row < refs.size(); row++) {
+        const int player_count = refs[row].store->player_counts[refs[row].row];
+        const int players = std::min(std::max(player_count, 1), MAX_LISTED_PLAYERS);
+        out[static_cast<size_t>(players - 1)].rows.set(row);
+    }
+    return out;
+}
+
+std::vector<model::FacetIndex::Value> create_decade_values(const std::vector<model::GameRowRef>& refs)
+{
+    std::map<int, utils::Bitset> decades;
+    for (size_t row = 0; row < refs.size(); row++) {
+        const int year = refs[row].store->release_dates[refs[row].row].year();
+        if (year <= 0)
+            continue;
+
+        const int decade = year / 10 * 10;
+        auto it = decades.find(decade);
+        if (it == decades.end())
+            it = decades.emplace(decade, utils::Bitset(refs.size())).first;
+        it->second.set(row);
+    }
+
+    std::vector<model::FacetIndex::Value> out;
+    out.reserve(decades.size());
+    for (auto& pair : decades)
+        out.push_back({ QString::number(pair.first) + QChar('s'), std::move(pair.second) });
+    return out;
+}
+} // namespace
+
+
+namespace model {
+constexpr size_t FacetIndex::FACET_COUNT;
+
+FacetIndex::FacetIndex(const std::vector<GameRowRef>& refs)
+    : m_size(refs.size())
+{
+    m_values[GENRE] = create_genre_values(refs);
+    m_values[PLAYERS] = create_player_values(refs);
+    m_values[DECADE] = create_decade_values(refs);
+    m_values[FAVORITE].push_back({ QStringLiteral("favorite"), utils::Bitset(m_size) });
+    m_values[PLAYED].push_back({ QStringLiteral("played"), utils::Bitset(m_size) });
+
+    for (size_t row = 0; row < refs.size(); row++) {
+        const GameStore& store = *refs[row].store;
+        m_values[FAVORITE].front().rows.set(row, store.favorites[refs[row].row]);
+        m_values[PLAYED].front().rows.set(row, store.play_counts[refs[row].row] > 0);
+    }
+}
+
+QString FacetIndex::facetName(Facet facet)
+{
+    switch (facet) {
+        case GENRE: return QStringLiteral("genre");
+        case PLAYERS: return QStringLiteral("players");
+        case DECADE: return QStringLiteral("decade");
+        case FAVORITE: return QStringLiteral("favorite");
+        case PLAYED: return QStringLiteral("played");
+    }
+    Q_UNREACHABLE();
+    return QString();
+}
+
+void FacetIndex::updateDynamicFacets(size_t row, const model::Game& game)
+{
+    Q_ASSERT(row < m_size);
+    m_values[FAVORITE].front().rows.set(row, game.isFavorite());
+    m_values[PLAYED].front().rows.set(row, game.playCount() > 0);
+}
+
+utils::Bitset FacetIndex::match(const Selection& selection) const
+{
+    return matchExcept(selection, static_cast<Facet>(FACET_COUNT));
+}
+
+utils::Bitset FacetIndex::matchExcept(const Selection& selection, Facet skipped) const
+{
+    utils::Bitset result(m_size, true);
+
+    for (size_t facet = 0; facet < FACET_COUNT; facet++) {
+        if (facet == skipped || selection[facet].empty())
+            continue;
+
+        utils::Bitset any_selected(m_size);
+        for (const size_t value_idx : selection[facet])
+            any_selected |= m_values[facet][value_idx].rows;
+
+        result &= any_selected;
+    }
+
+    return result;
+}
+} // namespace model
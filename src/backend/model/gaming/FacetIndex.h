@@ -0,0 +1,77 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include "utils/Bitset.h"
+
+#include <QString>
+#include <QVector>
+#include <array>
+#include <vector>
+
+namespace model { class Game; }
+namespace model { struct GameRowRef; }
+
+
+namespace model {
+/// Bitmaps of the games for every value of the common facets
+///
+/// For each facet value there is a bitmap marking the rows of the game list
+/// that have that value. A selection is matched by OR-ing the selected
+/// values of a facet, then AND-ing the facets together.
+class FacetIndex {
+public:
+    enum Facet : unsigned char {
+        GENRE,
+        PLAYERS,
+        DECADE,
+        FAVORITE,
+        PLAYED,
+    };
+    static constexpr size_t FACET_COUNT = PLAYED + 1;
+
+    struct Value {
+        QString name;
+        utils::Bitset rows;
+    };
+
+    /// For each facet, the indices of the selected values
+    using Selection = std::array<std::vector<size_t>, FACET_COUNT>;
+
+    explicit FacetIndex(const std::vector<GameRowRef>&);
+
+    size_t size() const { return m_size; }
+    const std::vector<Value>& values(Facet facet) const { return m_values[facet]; }
+    static QString facetName(Facet);
+
+    /// Updates the bits of the fields that may change at runtime
+    /// (favorite and play stats) for a row
+    void updateDynamicFacets(size_t row, const model::Game&);
+
+    /// The rows matching the whole selection
+    utils::Bitset match(const Selection&) const;
+    /// The rows matching the selection of every facet except one; this
+    /// is what the counts of that facet's values should be compared to
+    utils::Bitset matchExcept(const Selection&, Facet) const;
+
+private:
+    size_t m_size;
+    std::array<std::vector<Value>, FACET_COUNT> m_values;
+};
+} // namespace model
@@ -19,6 +19,7 @@
 
 #include "model/gaming/Assets.h"
 #include "model/gaming/Collection.h"
+#include "model/gaming/GameEvents.h"
 #include "model/gaming/GameFile.h"
 
 
@@ -28,96 +29,157 @@ QString joined_list(const QStringList& list) { return list.join(QLatin1String(",
 
 
 namespace model {
-GameData::GameData() = default;
-
-GameData::GameData(QString new_title)
-    : title(std::move(new_title))
-    , sort_by(title)
+Game::Game(std::shared_ptr<GameStore> store, QObject* parent)
+    : QObject(parent)
+    , m_store(std::move(store))
+    , m_row(m_store->add_row(this))
+    , m_files(nullptr)
+    , m_collections(nullptr)
 {}
 
+Game::Game(std::shared_ptr<GameStore> store, size_t row, QObject* parent)
+    : QObject(parent)
+    , m_store(std::move(store))
+    , m_row(row)
+    , m_files(nullptr)
+    , m_collections(nullptr)
+{
+    Q_ASSERT(m_row < m_store->size());
+    Q_ASSERT(!m_store->games[m_row]);
+    m_store->games[m_row] = this;
+}
 
 Game::Game(QString name, QObject* parent)
-    : QObject(parent)
-    , m_files(new QQmlObjectListModel<model::GameFile>(this))
-    , m_collections(new QQmlObjectListModel<model::Collection>(this))
-    , m_data(std::move(name))
-    , m_assets(new model::Assets(this))
-{}
+    : Game(std::make_shared<GameStore>(), parent)
+{
+    setTitle(std::move(name));
+}
 
 Game::Game(QObject* parent)
     : Game(QString(), parent)
 {}
 
-QString Game::developerStr() const { return joined_list(m_data.developers); }
-QString Game::publisherStr() const { return joined_list(m_data.publishers); }
-QString Game::genreStr() const { return joined_list(m_data.genres); }
-QString Game::tagStr() const { return joined_list(m_data.tags); }
+Game::~Game()
+{
+    if (m_store->games[m_row] == this)
+        m_store->games[m_row] = nullptr;
+}
+
+Game& Game::moveToStore(const std::shared_ptr<GameStore>& new_store)
+{
+    Q_ASSERT(new_store && new_store != m_store);
+
+    m_row = new_store->take_row(*m_store, m_row, this);
+    m_store = new_store;
+    return *this;
+}
+
+Assets* Game::assetsPtr() const
+{
+    // NOTE: the assets are kept by the store, and may outlive this object;
+    //       at the end of scanning, they are given a new parent
+    Assets*& assets = m_store->assets[m_row];
+    if (!assets)
+        assets = new model::Assets(const_cast<Game*>(this));
+    return assets;
+}
+
+QQmlObjectListModelBase* Game::filesModel() const
+{
+    if (!m_files) {
+        m_files = new QQmlObjectListModel<model::GameFile>(const_cast<Game*>(this));
+        m_files->append(fileList());
+    }
+    return m_files;
+}
+
+QQmlObjectListModelBase* Game::collectionsModel() const
+{
+    if (!m_collections) {
+        m_collections = new QQmlObjectListModel<model::Collection>(const_cast<Game*>(this));
+        m_collections->append(collectionList());
+    }
+    return m_collections;
+}
+
+QString Game::developerStr() const { return joined_list(developerListConst()); }
+QString Game::publisherStr() const { return joined_list(publisherListConst()); }
+QString Game::genreStr() const { return joined_list(genreListConst()); }
+QString Game::tagStr() const { return joined_list(tagListConst()); }
 
 Game& Game::setTitle(QString title)
 {
-    m_data.title = std::move(title);
+    m_store->titles[m_row] = std::move(title);
     if (sortBy().isEmpty())
-        setSortBy(m_data.title);
+        setSortBy(this->title());
     return *this;
 }
 
 Game& Game::setFavorite(bool new_val)
 {
-    m_data.is_favorite = new_val;
+    m_store->favorites[m_row] = new_val;
     emit favoriteChanged();
+    GameEvents::reportFavoriteChanged(this);
     return *this;
 }
 
 void Game::onEntryPlayStatsChanged()
 {
-    const auto prev_play_count = m_data.playstats.play_count;
-    const auto prev_play_time = m_data.playstats.play_time;
-    const auto prev_last_played = m_data.playstats.last_played;
+    // the files report their changes during scanning too,
+    // the totals are calculated once they are added to the game
+    const QVector<model::GameFile*>& file_list = fileList();
+    if (file_list.isEmpty())
+        return;
 
-    m_data.playstats.play_count = std::accumulate(filesConst().cbegin(), filesConst().cend(), 0,
+    const int play_count = std::accumulate(file_list.cbegin(), file_list.cend(), 0,
         [](int sum, const model::GameFile* const gamefile){
             return sum + gamefile->playCount();
         });
-    m_data.playstats.play_time = std::accumulate(filesConst().cbegin(), filesConst().cend(), 0,
+    const int play_time = std::accumulate(file_list.cbegin(), file_list.cend(), 0,
         [](qint64 sum, const model::GameFile* const gamefile){
             return sum + gamefile->playTime();
         });
-    m_data.playstats.last_played = std::accumulate(filesConst().cbegin(), filesConst().cend(), QDateTime(),
+    QDateTime last_played = std::accumulate(file_list.cbegin(), file_list.cend(), QDateTime(),
         [](const QDateTime& current_max, const model::GameFile* const gamefile){
             return std::max(current_max, gamefile->lastPlayed());
         });
 
-    const bool changed = prev_play_count != m_data.playstats.play_count
-        || prev_play_time != m_data.playstats.play_time
-        || prev_last_played != m_data.playstats.last_played;
-    if (changed)
-        emit playStatsChanged();
+    const bool changed = play_count != playCount()
+        || play_time != playTime()
+        || last_played != lastPlayed();
+    if (!changed)
+        return;
+
+    m_store->play_counts[m_row] = play_count;
+    m_store->play_times[m_row] = play_time;
+    m_store->last_played[m_row] = std::move(last_played);
+    emit playStatsChanged();
+    GameEvents::reportPlayStatsChanged(this);
 }
 
 void Game::launch()
 {
-    Q_ASSERT(m_files->count() > 0);
+    const QVector<model::GameFile*>& file_list = fileList();
+    Q_ASSERT(!file_list.isEmpty());
 
-    if (m_files->count() == 1)
-        m_files->first()->launch();
-    else
+    if (file_list.count() == 1)
+        file_list.first()->launch();
+    else {
         emit launchFileSelectorRequested();
+        GameEvents::reportFileSelectorRequested(this);
+    }
 }
 
 Game& Game::setFiles(std::vector<model::GameFile*>&& files)
 {
-    for (model::GameFile* const gamefile : files) {
-        connect(gamefile, &model::GameFile::playStatsChanged,
-                this, &model::Game::onEntryPlayStatsChanged);
-    }
-
     std::sort(files.begin(), files.end(), model::sort_gamefiles);
 
-    QVector<model::GameFile*> modelvec;
-    modelvec.reserve(files.size());
-    std::move(files.begin(), files.end(), std::back_inserter(modelvec));
+    QVector<model::GameFile*>& file_list = m_store->files[m_row];
+    file_list.reserve(file_list.size() + static_cast<int>(files.size()));
+    std::move(files.begin(), files.end(), std::back_inserter(file_list));
 
-    m_files->append(std::move(modelvec));
+    if (m_files)
+        m_files->append(file_list.mid(m_files->count()));
 
     onEntryPlayStatsChanged();
 
@@ -128,11 +190,12 @@ Game& Game::setCollections(std::vector<model::Collection*>&& collections)
 {
     std::sort(collections.begin(), collections.end(), model::sort_collections);
 
-    QVector<model::Collection*> modelvec;
-    modelvec.reserve(collections.size());
-    std::move(collections.begin(), collections.end(), std::back_inserter(modelvec));
+    QVector<model::Collection*>& collection_list = m_store->collections[m_row];
+    collection_list.reserve(collection_list.size() + static_cast<int>(collections.size()));
+    std::move(collections.begin(), collections.end(), std::back_inserter(collection_list));
 
-    m_collections->append(std::move(modelvec));
+    if (m_collections)
+        m_collections->append(collection_list.mid(m_collections->count()));
     return *this;
 }
 
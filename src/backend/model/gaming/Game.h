@@ -17,9 +17,12 @@
 
 #pragma once
 
+#include "model/gaming/GameStore.h"
+
 #include "QtQmlTricks/QQmlObjectListModel.h"
 #include <QDateTime>
 #include <QStringList>
+#include <memory>
 
 #ifdef Q_CC_MSVC
 // MSVC has troubles with forward declared QML model types
@@ -33,97 +36,68 @@ namespace model { class Collection; }
 
 
 namespace model {
-struct GameData {
-    explicit GameData();
-    explicit GameData(QString);
-
-    QString title;
-    QString sort_by;
-    QString summary;
-    QString description;
-
-    QStringList developers;
-    QStringList publishers;
-    QStringList genres;
-    QStringList tags;
-
-    short player_count = 1;
-    float rating = 0.0;
-    QDate release_date;
-
-    struct PlayStats {
-        int play_count = 0;
-        int play_time = 0;
-        QDateTime last_played;
-    } playstats;
-
-    bool is_favorite = false;
-
-    struct LaunchParams {
-        QString launch_cmd;
-        QString launch_workdir;
-        QString relative_basedir; // TODO: check if needed
-    } launch_params;
-};
-
-
+/// A thin QObject view of one row of a GameStore
+///
+/// After scanning, these are created by GameStore::game() on demand. The
+/// child objects of the game (assets, file and collection models) are only
+/// created when they are first accessed.
 class Game : public QObject {
     Q_OBJECT
 
 public:
-#define GETTER(type, name, field) \
-    type name() const { return m_data.field; }
+#define GETTER(type, name, column) \
+    type name() const { return m_store->column[m_row]; }
 
-    GETTER(const QString&, title, title)
-    GETTER(const QString&, sortBy, sort_by)
-    GETTER(const QString&, summary, summary)
-    GETTER(const QString&, description, description)
-    GETTER(const QDate&, releaseDate, release_date)
-    GETTER(int, playerCount, player_count)
-    GETTER(float, rating, rating)
+    GETTER(const QString&, title, titles)
+    GETTER(const QString&, sortBy, sort_titles)
+    GETTER(const QString&, summary, summaries)
+    GETTER(const QString&, description, descriptions)
+    GETTER(const QDate&, releaseDate, release_dates)
+    GETTER(int, playerCount, player_counts)
+    GETTER(float, rating, ratings)
 
     GETTER(const QStringList&, developerListConst, developers)
     GETTER(const QStringList&, publisherListConst, publishers)
     GETTER(const QStringList&, genreListConst, genres)
     GETTER(const QStringList&, tagListConst, tags)
 
-    GETTER(int, releaseYear, release_date.year())
-    GETTER(int, releaseMonth, release_date.month())
-    GETTER(int, releaseDay, release_date.day())
-
-    GETTER(int, playCount, playstats.play_count)
-    GETTER(int, playTime, playstats.play_time)
-    GETTER(const QDateTime&, lastPlayed, playstats.last_played)
-    GETTER(bool, isFavorite, is_favorite)
+    GETTER(int, playCount, play_counts)
+    GETTER(int, playTime, play_times)
+    GETTER(const QDateTime&, lastPlayed, last_played)
+    GETTER(bool, isFavorite, favorites)
 
-    GETTER(const QString&, launchCmd, launch_params.launch_cmd)
-    GETTER(const QString&, launchWorkdir, launch_params.launch_workdir)
-    GETTER(const QString&, launchCmdBasedir, launch_params.relative_basedir)
+    GETTER(const QString&, launchCmd, launch_cmds)
+    GETTER(const QString&, launchWorkdir, launch_workdirs)
+    GETTER(const QString&, launchCmdBasedir, launch_basedirs)
 #undef GETTER
 
+    int releaseYear() const { return releaseDate().year(); }
+    int releaseMonth() const { return releaseDate().month(); }
+    int releaseDay() const { return releaseDate().day(); }
+
 
-#define SETTER(type, name, field) \
-    Game& set##name(type val) { m_data.field = std::move(val); return *this; }
+#define SETTER(type, name, column) \
+    Game& set##name(type val) { m_store->column[m_row] = std::move(val); return *this; }
 
     Game& setTitle(QString);
-    SETTER(QString, SortBy, sort_by)
-    SETTER(QString, Summary, summary)
-    SETTER(QString, Description, description)
-    SETTER(QDate, ReleaseDate, release_date)
-    SETTER(int, PlayerCount, player_count)
-    SETTER(float, Rating, rating)
+    SETTER(QString, SortBy, sort_titles)
+    SETTER(QString, Summary, summaries)
+    SETTER(QString, Description, descriptions)
+    SETTER(QDate, ReleaseDate, release_dates)
+    SETTER(int, PlayerCount, player_counts)
+    SETTER(float, Rating, ratings)
 
-    SETTER(QString, LaunchCmd, launch_params.launch_cmd)
-    SETTER(QString, LaunchWorkdir, launch_params.launch_workdir)
-    SETTER(QString, LaunchCmdBasedir, launch_params.relative_basedir)
+    SETTER(QString, LaunchCmd, launch_cmds)
+    SETTER(QString, LaunchWorkdir, launch_workdirs)
+    SETTER(QString, LaunchCmdBasedir, launch_basedirs)
 
     Game& setFavorite(bool val);
 #undef SETTER
 
 
-#define STRLIST(singular, field) \
+#define STRLIST(singular, column) \
     QString singular##Str() const; \
-    QStringList& singular##List() { return m_data.field; } \
+    QStringList& singular##List() { return m_store->column[m_row]; } \
     Q_PROPERTY(QString singular READ singular##Str CONSTANT) \
     Q_PROPERTY(QStringList singular##List READ singular##ListConst CONSTANT)
 
@@ -153,35 +127,56 @@ public:
     Q_PROPERTY(bool favorite READ isFavorite WRITE setFavorite NOTIFY favoriteChanged)
 
 
-    const Assets& assets() const { return *m_assets; }
-    Assets& assetsMut() { return *m_assets; }
+    const Assets& assets() const { return *assetsPtr(); }
+    Assets& assetsMut() { return *assetsPtr(); }
     Q_PROPERTY(model::Assets* assets READ assetsPtr CONSTANT)
 
     Game& setFiles(std::vector<model::GameFile*>&&);
     Game& setCollections(std::vector<model::Collection*>&&);
-    const QVector<model::GameFile*>& filesConst() const { Q_ASSERT(!m_files->isEmpty()); return m_files->asList(); }
-    const QVector<model::Collection*>& collectionsConst() const { Q_ASSERT(!m_collections->isEmpty()); return m_collections->asList(); }
-    QML_OBJMODEL_PROPERTY(model::GameFile, files)
-    QML_OBJMODEL_PROPERTY(model::Collection, collections)
+    const QVector<model::GameFile*>& filesConst() const { Q_ASSERT(!fileList().isEmpty()); return fileList(); }
+    const QVector<model::Collection*>& collectionsConst() const { Q_ASSERT(!collectionList().isEmpty()); return collectionList(); }
+    Q_PROPERTY(QQmlObjectListModelBase* files READ filesModel CONSTANT)
+    Q_PROPERTY(QQmlObjectListModelBase* collections READ collectionsModel CONSTANT)
+
+    const GameStore& store() const { return *m_store; }
+    const std::shared_ptr<GameStore>& sharedStore() const { return m_store; }
+    size_t storeRow() const { return m_row; }
+    GameRowRef rowRef() const { return GameRowRef { m_store.get(), m_row }; }
+    /// Moves the data of this game to the end of an other store
+    Game& moveToStore(const std::shared_ptr<GameStore>&);
+
+    /// Called by the files of this game when their play stats change
+    void onEntryPlayStatsChanged();
+
+    // the child objects are created on the first call
+    Assets* assetsPtr() const;
+    bool hasAssets() const { return m_store->assets[m_row] != nullptr; }
+    QQmlObjectListModelBase* filesModel() const;
+    QQmlObjectListModelBase* collectionsModel() const;
 
 private:
-    GameData m_data;
-    Assets* const m_assets;
+    std::shared_ptr<GameStore> m_store;
+    size_t m_row;
+
+    const QVector<model::GameFile*>& fileList() const { return m_store->files[m_row]; }
+    const QVector<model::Collection*>& collectionList() const { return m_store->collections[m_row]; }
 
-    Assets* assetsPtr() const { return m_assets; }
+    mutable QQmlObjectListModel<model::GameFile>* m_files;
+    mutable QQmlObjectListModel<model::Collection>* m_collections;
 
 signals:
     void launchFileSelectorRequested();
     void favoriteChanged();
     void playStatsChanged();
 
-private slots:
-    void onEntryPlayStatsChanged();
-
 
 public:
     explicit Game(QObject* parent = nullptr);
     explicit Game(QString name, QObject* parent = nullptr);
+    explicit Game(std::shared_ptr<GameStore>, QObject* parent = nullptr);
+    /// Creates the object of an existing row that has none; see GameStore::game()
+    explicit Game(std::shared_ptr<GameStore>, size_t row, QObject* parent = nullptr);
+    ~Game() override;
 
     Q_INVOKABLE void launch();
 
@@ -0,0 +1,68 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "GameEvents.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+
+namespace {
+bool on_main_thread()
+{
+    const QCoreApplication* const app = QCoreApplication::instance();
+    return !app || app->thread() == QThread::currentThread();
+}
+} // namespace
+
+
+namespace model {
+GameEvents::GameEvents()
+    : QObject()
+{}
+
+GameEvents& GameEvents::instance()
+{
+    static GameEvents events;
+    return events;
+}
+
+void GameEvents::reportFavoriteChanged(model::Game* game)
+{
+    if (on_main_thread())
+        emit instance().favoriteChanged(game);
+}
+
+void GameEvents::reportPlayStatsChanged(model::Game* game)
+{
+    if (on_main_thread())
+        emit instance().playStatsChanged(game);
+}
+
+void GameEvents::reportFileSelectorRequested(model::Game* game)
+{
+    if (on_main_thread())
+        emit instance().fileSelectorRequested(game);
+}
+
+void GameEvents::reportLaunchRequested(model::GameFile* gamefile)
+{
+    if (on_main_thread())
+        emit instance().launchRequested(gamefile);
+}
+} // namespace model
@@ -0,0 +1,58 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QObject>
+
+namespace model { class Game; }
+namespace model { class GameFile; }
+
+
+namespace model {
+/// Forwards the events of every game and game file to the backend
+///
+/// Connecting to the signals of each game separately is slow and takes
+/// a considerable amount of memory for large libraries, so the games also
+/// report their changes here, and the listeners connect only once. The games
+/// keep emitting their own signals too, for QML.
+///
+/// Only the events happening on the main thread are forwarded; during
+/// scanning the games are not visible yet, and the providers already know
+/// about the changes they make.
+class GameEvents : public QObject {
+    Q_OBJECT
+
+public:
+    static GameEvents& instance();
+
+    static void reportFavoriteChanged(model::Game*);
+    static void reportPlayStatsChanged(model::Game*);
+    static void reportFileSelectorRequested(model::Game*);
+    static void reportLaunchRequested(model::GameFile*);
+
+signals:
+    void favoriteChanged(model::Game*);
+    void playStatsChanged(model::Game*);
+    void fileSelectorRequested(model::Game*);
+    void launchRequested(model::GameFile*);
+
+private:
+    explicit GameEvents();
+};
+} // namespace model
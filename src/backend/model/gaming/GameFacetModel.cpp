@@ -0,0 +1,246 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "GameFacetModel.h"
+
+#include "model/gaming/GameListModel.h"
+
+#include <algorithm>
+#include <memory>
+
+
+namespace model {
+GameFacetModel::GameFacetModel(QObject* parent)
+    : QAbstractListModel(parent)
+    , m_source(nullptr)
+{}
+
+void GameFacetModel::setSourceModel(GameListModel* source)
+{
+    if (m_source == source)
+        return;
+
+    if (m_source)
+        disconnect(m_source, nullptr, this, nullptr);
+
+    m_source = source;
+    if (m_source) {
+        connect(m_source, &QObject::destroyed,
+                this, [this]{ setSourceModel(nullptr); });
+        connect(m_source, &QAbstractItemModel::modelReset,
+                this, &GameFacetModel::onSourceReset);
+        connect(m_source, &QAbstractItemModel::rowsInserted,
+                this, &GameFacetModel::onSourceReset);
+        connect(m_source, &QAbstractItemModel::rowsRemoved,
+                this, &GameFacetModel::onSourceReset);
+        connect(m_source, &QAbstractItemModel::layoutChanged,
+                this, &GameFacetModel::onSourceReset);
+        connect(m_source, &QAbstractItemModel::dataChanged,
+                this, &GameFacetModel::onSourceDataChanged);
+        connect(m_source, &GameListModel::facetIndexChanged,
+                this, &GameFacetModel::onSourceReset);
+    }
+
+    emit sourceModelChanged();
+    onSourceReset();
+}
+
+bool GameFacetModel::hasSelection() const
+{
+    return std::any_of(m_selection.cbegin(), m_selection.cend(),
+        [](const std::vector<size_t>& values){ return !values.empty(); });
+}
+
+bool GameFacetModel::accepts(int source_row) const
+{
+    if (source_row < 0 || m_match.size() <= static_cast<size_t>(source_row))
+        return true;
+
+    return m_match.test(static_cast<size_t>(source_row));
+}
+
+void GameFacetModel::toggle(int idx)
+{
+    if (idx < 0 || count() <= idx)
+        return;
+
+    Entry& entry = m_entries[static_cast<size_t>(idx)];
+    entry.selected = !entry.selected;
+
+    std::vector<size_t>& selected_values = m_selection[entry.facet];
+    if (entry.selected)
+        selected_values.push_back(entry.value);
+    else
+        selected_values.erase(std::remove(selected_values.begin(), selected_values.end(), entry.value), selected_values.end());
+
+    emit dataChanged(index(idx), index(idx), { SelectedRole });
+    updateCounts();
+}
+
+void GameFacetModel::clearSelection()
+{
+    if (!hasSelection())
+        return;
+
+    for (Entry& entry : m_entries)
+        entry.selected = false;
+    for (std::vector<size_t>& values : m_selection)
+        values.clear();
+
+    emit dataChanged(index(0), index(count() - 1), { SelectedRole });
+    updateCounts();
+}
+
+const FacetIndex* GameFacetModel::facetIndex() const
+{
+    return m_source ? m_source->facetIndex().get() : nullptr;
+}
+
+void GameFacetModel::updateCounts()
+{
+    const FacetIndex* const index = facetIndex();
+    if (!index) {
+        if (m_match.size() != 0) {
+            m_match = utils::Bitset();
+            emit matchChanged();
+        }
+        return;
+    }
+
+    // each value is counted against the games matching the other facets,
+    // so the number shows the result of selecting it too
+    int changed_first = count();
+    int changed_last = -1;
+    for (size_t facet = 0; facet < FacetIndex::FACET_COUNT; facet++) {
+        const auto facet_id = static_cast<FacetIndex::Facet>(facet);
+        const utils::Bitset others = index->matchExcept(m_selection, facet_id);
+        const std::vector<FacetIndex::Value>& values = index->values(facet_id);
+
+        for (size_t i = 0; i < m_entries.size(); i++) {
+            Entry& entry = m_entries[i];
+            if (entry.facet != facet_id)
+                continue;
+
+            const int new_count = static_cast<int>(utils::Bitset::count_and(values[entry.value].rows, others));
+            if (entry.count != new_count) {
+                entry.count = new_count;
+                changed_first = std::min(changed_first, static_cast<int>(i));
+                changed_last = std::max(changed_last, static_cast<int>(i));
+            }
+        }
+    }
+    if (changed_first <= changed_last)
+        emit dataChanged(index(changed_first), index(changed_last), { CountRole });
+
+    utils::Bitset match = index->match(m_selection);
+    if (m_match != match) {
+        m_match = std::move(match);
+        emit matchChanged();
+    }
+}
+
+void GameFacetModel::onSourceReset()
+{
+    // the index is created on demand and given to the source;
+    // installing it calls this function again
+    if (m_source && !m_source->facetIndex() && m_source->count() > 0) {
+        m_source->setFacetIndex(std::make_shared<FacetIndex>(m_source->rowRefs()));
+        return;
+    }
+
+    const int prev_count = count();
+
+    beginResetModel();
+    m_entries.clear();
+    for (std::vector<size_t>& values : m_selection)
+        values.clear();
+
+    const FacetIndex* const index = facetIndex();
+    if (index) {
+        for (size_t facet = 0; facet < FacetIndex::FACET_COUNT; facet++) {
+            const auto facet_id = static_cast<FacetIndex::Facet>(facet);
+            const size_t value_count = index->values(facet_id).size();
+            for (size_t value = 0; value < value_count; value++)
+                m_entries.push_back({ facet_id, value, 0, false });
+        }
+    }
+    endResetModel();
+
+    if (prev_count != count())
+        emit countChanged();
+
+    m_match = utils::Bitset();
+    updateCounts();
+}
+
+void GameFacetModel::onSourceDataChanged(const QModelIndex&, const QModelIndex&, const QVector<int>& roles)
+{
+    // the facet index itself is updated by the source list
+    const bool dynamic_facets_changed = roles.isEmpty()
+        || roles.contains(GameListModel::FavoriteRole)
+        || roles.contains(GameListModel::PlayCountRole);
+    if (dynamic_facets_changed)
+        updateCounts();
+}
+
+int GameFacetModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant GameFacetModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || count() <= index.row())
+        return {};
+
+    const Entry& entry = m_entries[static_cast<size_t>(index.row())];
+    switch (role) {
+        case FacetRole:
+            return FacetIndex::facetName(entry.facet);
+        case ValueRole:
+            return facetIndex() ? facetIndex()->values(entry.facet)[entry.value].name : QVariant();
+        case CountRole:
+            return entry.count;
+        case SelectedRole:
+            return entry.selected;
+        default:
+            return {};
+    }
+}
+
+bool GameFacetModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (role != SelectedRole || !index.isValid() || count() <= index.row())
+        return false;
+
+    if (m_entries[static_cast<size_t>(index.row())].selected != value.toBool())
+        toggle(index.row());
+    return true;
+}
+
+QHash<int, QByteArray> GameFacetModel::roleNames() const
+{
+    static const QHash<int, QByteArray> ROLE_NAMES {
+        { FacetRole, QByteArrayLiteral("facet") },
+        { ValueRole, QByteArrayLiteral("value") },
+        { CountRole, QByteArrayLiteral("count") },
+        { SelectedRole, QByteArrayLiteral("selected") },
+    };
+    return ROLE_NAMES;
+}
+} // namespace model
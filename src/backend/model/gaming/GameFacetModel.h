@@ -0,0 +1,99 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include "model/gaming/FacetIndex.h"
+#include "utils/Bitset.h"
+
+#include <QAbstractListModel>
+#include <vector>
+
+namespace model { class GameListModel; }
+
+
+namespace model {
+/// The values of the common facets of a game list with live counts, for QML
+///
+/// Every row is a value of a facet (eg. a genre or a decade), which can be
+/// selected. The games matching the selection can be queried by a filter
+/// model, while the count of each value shows how many games would match
+/// if that value was also selected. The counts are calculated from the
+/// bitmaps of the facet index of the source, and are refreshed when the
+/// favorite or play stats of a game change.
+class GameFacetModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(model::GameListModel* sourceModel READ sourceModel WRITE setSourceModel NOTIFY sourceModelChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int matchCount READ matchCount NOTIFY matchChanged)
+    Q_PROPERTY(bool hasSelection READ hasSelection NOTIFY matchChanged)
+
+public:
+    enum Roles {
+        FacetRole = Qt::UserRole + 1,
+        ValueRole,
+        CountRole,
+        SelectedRole,
+    };
+
+    explicit GameFacetModel(QObject* parent = nullptr);
+
+    GameListModel* sourceModel() const { return m_source; }
+    void setSourceModel(GameListModel*);
+    int count() const { return static_cast<int>(m_entries.size()); }
+    int matchCount() const { return static_cast<int>(m_match.count()); }
+    bool hasSelection() const;
+
+    /// Whether the game at the source row matches the current selection
+    bool accepts(int source_row) const;
+
+    Q_INVOKABLE void toggle(int idx);
+    Q_INVOKABLE void clearSelection();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role) override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void sourceModelChanged();
+    void countChanged();
+    void matchChanged();
+
+private slots:
+    void onSourceReset();
+    void onSourceDataChanged(const QModelIndex&, const QModelIndex&, const QVector<int>&);
+
+private:
+    struct Entry {
+        FacetIndex::Facet facet;
+        size_t value;
+        int count;
+        bool selected;
+    };
+
+    // the facet index is always read from the source, as that's the one it keeps up to date
+    GameListModel* m_source;
+    std::vector<Entry> m_entries;
+    FacetIndex::Selection m_selection;
+    utils::Bitset m_match;
+
+    const FacetIndex* facetIndex() const;
+    void updateCounts();
+};
+} // namespace model
@@ -18,6 +18,7 @@
 #include "GameFile.h"
 
 #include "model/gaming/Game.h"
+#include "model/gaming/GameEvents.h"
 
 
 namespace model {
@@ -47,16 +48,25 @@ bool GameFileData::operator==(const GameFileData& other) const {
 GameFile::GameFile(QFileInfo finfo, model::Game& parent)
     : QObject(&parent)
     , m_data(std::move(finfo))
+    , m_store(parent.sharedStore())
+    , m_row(parent.storeRow())
 {}
 
 model::Game* GameFile::parentGame() const
 {
-    return static_cast<model::Game*>(parent());
+    return m_store->game(m_row);
+}
+
+void GameFile::setStoreRow(std::shared_ptr<GameStore> store, size_t row)
+{
+    m_store = std::move(store);
+    m_row = row;
 }
 
 void GameFile::launch()
 {
     emit launchRequested();
+    GameEvents::reportLaunchRequested(this);
 }
 
 void GameFile::update_playstats(int playcount, qint64 playtime, QDateTime last_played)
@@ -65,6 +75,8 @@ void GameFile::update_playstats(int playcount, qint64 playtime, QDateTime last_p
     m_data.playstats.play_time += playtime;
     m_data.playstats.play_count += playcount;
     emit playStatsChanged();
+
+    parentGame()->onEntryPlayStatsChanged();
 }
 
 bool sort_gamefiles(const model::GameFile* const a, const model::GameFile* const b) {
@@ -22,8 +22,10 @@
 #include <QDateTime>
 #include <QFileInfo>
 #include <QString>
+#include <memory>
 
 namespace model { class Game; }
+namespace model { class GameStore; }
 
 
 namespace model {
@@ -75,7 +77,10 @@ public:
 public:
     explicit GameFile(QFileInfo, model::Game&);
 
+    /// The game of this file; its object is created if it doesn't exist
     model::Game* parentGame() const;
+    /// Called by the store when the game of this file is moved
+    void setStoreRow(std::shared_ptr<GameStore>, size_t);
 
     Q_INVOKABLE void launch();
 
@@ -87,6 +92,11 @@ signals:
 
 private:
     GameFileData m_data;
+
+    // the files outlive the scan-time Game objects,
+    // so they refer to the row of their game instead
+    std::shared_ptr<GameStore> m_store;
+    size_t m_row;
 };
 
 
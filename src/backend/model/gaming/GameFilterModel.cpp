@@ -0,0 +1,563 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "GameFilterModel.h"
+
+#include "model/gaming/Game.h"
+#include "model/gaming/GameFacetModel.h"
+#include "model/gaming/GameListModel.h"
+#include "model/gaming/GameStore.h"
+
+#include <QCollator>
+#include <algorithm>
+#include <numeric>
+
+
+namespace {
+enum FilterBit : unsigned char {
+    FILTER_TITLE = 1 << 0,
+    FILTER_GENRE = 1 << 1,
+    FILTER_FAVORITE = 1 << 2,
+    FILTER_PLAYERS = 1 << 3,
+    FILTER_RELEASE_YEAR = 1 << 4,
+    FILTER_LAST_PLAYED = 1 << 5,
+    FILTER_FACETS = 1 << 6,
+    FILTER_ALL = (1 << 7) - 1,
+};
+
+template<typename Getter>
+void sort_by_field(std::vector<int>& rows, const std::vector<model::GameRowRef>& refs, Getter getter)
+{
+    std::stable_sort(rows.begin(), rows.end(),
+        [&refs, &getter](int a, int b){
+            const model::GameRowRef& ref_a = refs[static_cast<size_t>(a)];
+            const model::GameRowRef& ref_b = refs[static_cast<size_t>(b)];
+            return getter(*ref_a.store, ref_a.row) < getter(*ref_b.store, ref_b.row);
+        });
+}
+} // namespace
+
+
+namespace model {
+GameFilterModel::GameFilterModel(QObject* parent)
+    : QAbstractListModel(parent)
+    , m_source(nullptr)
+    , m_complete(true)
+    , m_favorites_only(false)
+    , m_min_players(0)
+    , m_year_min(0)
+    , m_year_max(0)
+    , m_facets(nullptr)
+    , m_sort_key(SourceOrder)
+    , m_sort_order(Qt::AscendingOrder)
+{}
+
+void GameFilterModel::classBegin()
+{
+    m_complete = false;
+}
+
+void GameFilterModel::componentComplete()
+{
+    m_complete = true;
+    onSourceReset();
+}
+
+void GameFilterModel::setSourceModel(GameListModel* source)
+{
+    if (m_source == source)
+        return;
+
+    if (m_source)
+        disconnect(m_source, nullptr, this, nullptr);
+
+    m_source = source;
+    if (m_source) {
+        connect(m_source, &QObject::destroyed,
+                this, [this]{ setSourceModel(nullptr); });
+        connect(m_source, &QAbstractItemModel::modelReset,
+                this, &GameFilterModel::onSourceReset);
+        connect(m_source, &QAbstractItemModel::rowsInserted,
+                this, &GameFilterModel::onSourceReset);
+        connect(m_source, &QAbstractItemModel::rowsRemoved,
+                this, &GameFilterModel::onSourceReset);
+        connect(m_source, &QAbstractItemModel::layoutChanged,
+                this, &GameFilterModel::onSourceReset);
+        connect(m_source, &QAbstractItemModel::dataChanged,
+                this, &GameFilterModel::onSourceDataChanged);
+    }
+
+    emit sourceModelChanged();
+    onSourceReset();
+}
+
+#define FILTER_SETTER(type, name, field, signal, bit) \
+    void GameFilterModel::set##name(type val) { \
+        if (field == val) \
+            return; \
+        field = std::move(val); \
+        emit signal(); \
+        refilter(bit); \
+    }
+
+FILTER_SETTER(QString, GenreFilter, m_genre, genreFilterChanged, FILTER_GENRE)
+FILTER_SETTER(bool, FavoritesOnly, m_favorites_only, favoritesOnlyChanged, FILTER_FAVORITE)
+FILTER_SETTER(int, MinPlayers, m_min_players, minPlayersChanged, FILTER_PLAYERS)
+FILTER_SETTER(int, ReleaseYearMin, m_year_min, releaseYearRangeChanged, FILTER_RELEASE_YEAR)
+FILTER_SETTER(int, ReleaseYearMax, m_year_max, releaseYearRangeChanged, FILTER_RELEASE_YEAR)
+FILTER_SETTER(QDateTime, LastPlayedSince, m_last_played_since, lastPlayedSinceChanged, FILTER_LAST_PLAYED)
+#undef FILTER_SETTER
+
+void GameFilterModel::setFacets(GameFacetModel* facets)
+{
+    if (m_facets == facets)
+        return;
+
+    if (m_facets)
+        disconnect(m_facets, nullptr, this, nullptr);
+
+    m_facets = facets;
+    if (m_facets) {
+        connect(m_facets, &QObject::destroyed,
+                this, [this]{ setFacets(nullptr); });
+        connect(m_facets, &GameFacetModel::matchChanged,
+                this, [this]{ refilter(FILTER_FACETS); });
+    }
+
+    emit facetsChanged();
+    refilter(FILTER_FACETS);
+}
+
+void GameFilterModel::setTitleFilter(QString val)
+{
+    if (m_title == val)
+        return;
+
+    // typing more characters can only remove games from the results
+    const bool narrowing = val.contains(m_title, Qt::CaseInsensitive);
+
+    m_title = std::move(val);
+    emit titleFilterChanged();
+    refilter(FILTER_TITLE, narrowing);
+}
+
+void GameFilterModel::setSortKey(SortKey key)
+{
+    if (m_sort_key == key)
+        return;
+
+    m_sort_key = key;
+    emit sortChanged();
+    if (m_complete && m_source)
+        updateRows();
+}
+
+void GameFilterModel::setSortOrder(Qt::SortOrder order)
+{
+    if (m_sort_order == order)
+        return;
+
+    m_sort_order = order;
+    emit sortChanged();
+    if (m_complete && m_source)
+        updateRows();
+}
+
+bool GameFilterModel::passes(unsigned char filter_bit, int source_row, const GameRowRef& ref) const
+{
+    const GameStore& store = *ref.store;
+    const size_t row = ref.row;
+
+    switch (filter_bit) {
+        case FILTER_TITLE:
+            return m_title.isEmpty() || store.titles[row].contains(m_title, Qt::CaseInsensitive);
+        case FILTER_GENRE:
+            return m_genre.isEmpty() || store.genres[row].contains(m_genre, Qt::CaseInsensitive);
+        case FILTER_FAVORITE:
+            return !m_favorites_only || store.favorites[row];
+        case FILTER_PLAYERS:
+            return store.player_counts[row] >= m_min_players;
+        case FILTER_RELEASE_YEAR: {
+            const int year = store.release_dates[row].year();
+            return (m_year_min <= 0 || m_year_min <= year)
+                && (m_year_max <= 0 || year <= m_year_max);
+        }
+        case FILTER_LAST_PLAYED: {
+            const QDateTime& last_played = store.last_played[row];
+            return !m_last_played_since.isValid()
+                || (last_played.isValid() && m_last_played_since <= last_played);
+        }
+        case FILTER_FACETS:
+            return !m_facets || m_facets->accepts(source_row);
+        default:
+            Q_UNREACHABLE();
+            return false;
+    }
+}
+
+void GameFilterModel::evaluate(unsigned char filter_bits, int first, int last, bool narrowing)
+{
+    const std::vector<GameRowRef>& refs = m_source->rowRefs();
+
+    for (unsigned char bit = 1; bit & FILTER_ALL; bit <<= 1) {
+        if (!(filter_bits & bit))
+            continue;
+
+        for (int i = first; i <= last; i++) {
+            unsigned char& fail_bits = m_fail_bits[static_cast<size_t>(i)];
+            // with a narrowing change, rows failing already cannot pass
+            if (narrowing && (fail_bits & bit))
+                continue;
+
+            if (passes(bit, i, refs[static_cast<size_t>(i)]))
+                fail_bits &= ~bit;
+            else
+                fail_bits |= bit;
+        }
+    }
+}
+
+void GameFilterModel::refilter(unsigned char filter_bits, bool narrowing)
+{
+    if (!m_complete || !m_source)
+        return;
+    // the source has changed, but the reset signal has not arrived yet
+    if (m_fail_bits.size() != static_cast<size_t>(m_source->count()))
+        return;
+
+    evaluate(filter_bits, 0, m_source->count() - 1, narrowing);
+    updateRows();
+}
+
+const std::vector<int>& GameFilterModel::permutation(SortKey key)
+{
+    Q_ASSERT(m_source);
+    std::vector<int>& rows = m_permutations[static_cast<size_t>(key)];
+    if (!rows.empty() || m_source->count() == 0)
+        return rows;
+
+    const std::vector<GameRowRef>& refs = m_source->rowRefs();
+    rows.resize(refs.size());
+    std::iota(rows.begin(), rows.end(), 0);
+
+    switch (key) {
+        case SourceOrder:
+            break;
+        case SortByTitle: {
+            QCollator collator;
+            std::vector<QCollatorSortKey> sort_keys;
+            sort_keys.reserve(rows.size());
+            for (const GameRowRef& ref : refs)
+                sort_keys.emplace_back(collator.sortKey(ref.store->sort_titles[ref.row]));
+
+            std::stable_sort(rows.begin(), rows.end(),
+                [&sort_keys](int a, int b){ return sort_keys[a].compare(sort_keys[b]) < 0; });
+            break;
+        }
+        case SortByRelease:
+            sort_by_field(rows, refs, [](const GameStore& store, size_t row){ return store.release_dates[row]; });
+            break;
+        case SortByRating:
+            sort_by_field(rows, refs, [](const GameStore& store, size_t row){ return store.ratings[row]; });
+            break;
+        case SortByPlayers:
+            sort_by_field(rows, refs, [](const GameStore& store, size_t row){ return store.player_counts[row]; });
+            break;
+        case SortByLastPlayed:
+            sort_by_field(rows, refs, [](const GameStore& store, size_t row){ return store.last_played[row]; });
+            break;
+        case SortByPlayCount:
+            sort_by_field(rows, refs, [](const GameStore& store, size_t row){ return store.play_counts[row]; });
+            break;
+        case SortByPlayTime:
+            sort_by_field(rows, refs, [](const GameStore& store, size_t row){ return store.play_times[row]; });
+            break;
+    }
+
+    return rows;
+}
+
+std::vector<int> GameFilterModel::visibleRows()
+{
+    std::vector<int> rows;
+    if (!m_source)
+        return rows;
+
+    const std::vector<int>& order = permutation(m_sort_key);
+    const auto try_add = [this, &rows](int source_row){
+        if (m_fail_bits[static_cast<size_t>(source_row)] == 0)
+            rows.push_back(source_row);
+    };
+
+    if (m_sort_order == Qt::AscendingOrder)
+        std::for_each(order.cbegin(), order.cend(), try_add);
+    else
+        std::for_each(order.crbegin(), order.crend(), try_add);
+
+    return rows;
+}
+
+void GameFilterModel::rebuildSourceMapping()
+{
+    m_source_to_row.assign(m_fail_bits.size(), -1);
+    for (size_t i = 0; i < m_rows.size(); i++)
+        m_source_to_row[static_cast<size_t>(m_rows[i])] = static_cast<int>(i);
+}
+
+void GameFilterModel::resetRows()
+{
+    const int prev_count = count();
+
+    beginResetModel();
+    m_rows = visibleRows();
+    rebuildSourceMapping();
+    endResetModel();
+
+    if (prev_count != count())
+        emit countChanged();
+}
+
+void GameFilterModel::updateRows()
+{
+    const int prev_count = count();
+    const std::vector<int> new_rows = visibleRows();
+
+    // NOTE: The changes are reported in three steps, so the views can keep
+    //       their current item, scroll position and delegates: first the
+    //       hidden rows are removed, then the remaining ones are moved to
+    //       their new position, finally the newly visible rows are inserted.
+    removeHiddenRows();
+    reorderRows(new_rows);
+    insertShownRows(new_rows);
+    Q_ASSERT(m_rows == new_rows);
+
+    if (prev_count != count())
+        emit countChanged();
+}
+
+void GameFilterModel::removeHiddenRows()
+{
+    const auto is_hidden = [this](int row){
+        return m_fail_bits[static_cast<size_t>(m_rows[static_cast<size_t>(row)])] != 0;
+    };
+
+    // going backwards, so the indices of the unvisited rows do not change
+    int last = count() - 1;
+    while (last >= 0) {
+        if (!is_hidden(last)) {
+            last--;
+            continue;
+        }
+
+        int first = last;
+        while (first > 0 && is_hidden(first - 1))
+            first--;
+
+        beginRemoveRows(QModelIndex(), first, last);
+        m_rows.erase(m_rows.begin() + first, m_rows.begin() + last + 1);
+        endRemoveRows();
+
+        last = first - 1;
+    }
+
+    rebuildSourceMapping();
+}
+
+void GameFilterModel::reorderRows(const std::vector<int>& new_rows)
+{
+    // the current rows, in their new order
+    std::vector<int> reordered;
+    reordered.reserve(m_rows.size());
+    for (const int source_row : new_rows) {
+        if (m_source_to_row[static_cast<size_t>(source_row)] >= 0)
+            reordered.push_back(source_row);
+    }
+    Q_ASSERT(reordered.size() == m_rows.size());
+    if (reordered == m_rows)
+        return;
+
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+
+    const std::vector<int> prev_rows = std::move(m_rows);
+    m_rows = std::move(reordered);
+    rebuildSourceMapping();
+
+    const QModelIndexList prev_indices = persistentIndexList();
+    QModelIndexList new_indices;
+    new_indices.reserve(prev_indices.size());
+    for (const QModelIndex& prev_index : prev_indices) {
+        const int source_row = prev_rows[static_cast<size_t>(prev_index.row())];
+        new_indices.append(index(m_source_to_row[static_cast<size_t>(source_row)], prev_index.column()));
+    }
+    changePersistentIndexList(prev_indices, new_indices);
+
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+}
+
+void GameFilterModel::insertShownRows(const std::vector<int>& new_rows)
+{
+    // at this point the current rows are in the same relative order as in
+    // the new list, so going forward, every range can be inserted at its
+    // final position
+    const auto is_new = [this, &new_rows](int row){
+        return m_source_to_row[static_cast<size_t>(new_rows[static_cast<size_t>(row)])] < 0;
+    };
+
+    const int new_count = static_cast<int>(new_rows.size());
+    int first = 0;
+    while (first < new_count) {
+        if (!is_new(first)) {
+            first++;
+            continue;
+        }
+
+        int last = first;
+        while (last + 1 < new_count && is_new(last + 1))
+            last++;
+
+        beginInsertRows(QModelIndex(), first, last);
+        m_rows.insert(m_rows.begin() + first, new_rows.cbegin() + first, new_rows.cbegin() + last + 1);
+        endInsertRows();
+
+        first = last + 1;
+    }
+
+    rebuildSourceMapping();
+}
+
+void GameFilterModel::onSourceReset()
+{
+    for (std::vector<int>& rows : m_permutations)
+        rows.clear();
+
+    const size_t source_count = m_source ? static_cast<size_t>(m_source->count()) : 0;
+    m_fail_bits.assign(source_count, 0);
+
+    if (!m_complete)
+        return;
+
+    if (m_source)
+        evaluate(FILTER_ALL, 0, m_source->count() - 1);
+    resetRows();
+}
+
+void GameFilterModel::onSourceDataChanged(const QModelIndex& top_left, const QModelIndex& bottom_right, const QVector<int>& roles)
+{
+    if (!m_complete || !m_source)
+        return;
+
+    // unknown changes
+    if (roles.isEmpty()) {
+        onSourceReset();
+        return;
+    }
+
+    const int first = top_left.row();
+    const int last = bottom_right.row();
+
+    unsigned char filter_bits = 0;
+    std::vector<SortKey> sort_keys;
+    for (const int role : roles) {
+        switch (role) {
+            case GameListModel::FavoriteRole:
+                filter_bits |= FILTER_FAVORITE;
+                break;
+            case GameListModel::PlayCountRole:
+                sort_keys.push_back(SortByPlayCount);
+                break;
+            case GameListModel::PlayTimeRole:
+                sort_keys.push_back(SortByPlayTime);
+                break;
+            case GameListModel::LastPlayedRole:
+                filter_bits |= FILTER_LAST_PLAYED;
+                sort_keys.push_back(SortByLastPlayed);
+                break;
+            default:
+                break;
+        }
+    }
+
+    const std::vector<unsigned char> prev_bits(
+        m_fail_bits.cbegin() + first,
+        m_fail_bits.cbegin() + last + 1);
+    evaluate(filter_bits, first, last);
+    const bool visibility_changed = !std::equal(prev_bits.cbegin(), prev_bits.cend(), m_fail_bits.cbegin() + first);
+
+    bool order_changed = false;
+    for (const SortKey key : sort_keys) {
+        m_permutations[static_cast<size_t>(key)].clear();
+        order_changed |= key == m_sort_key;
+    }
+
+    if (visibility_changed || order_changed)
+        updateRows();
+
+    // forward the changed values of the rows still visible
+    int proxy_first = count();
+    int proxy_last = -1;
+    for (int i = first; i <= last; i++) {
+        const int row = m_source_to_row[static_cast<size_t>(i)];
+        if (row >= 0) {
+            proxy_first = std::min(proxy_first, row);
+            proxy_last = std::max(proxy_last, row);
+        }
+    }
+    if (proxy_first <= proxy_last)
+        emit dataChanged(index(proxy_first), index(proxy_last), roles);
+}
+
+QObject* GameFilterModel::get(int idx) const
+{
+    const int source_idx = mapToSource(idx);
+    return source_idx >= 0
+        ? m_source->at(source_idx)
+        : nullptr;
+}
+
+int GameFilterModel::mapToSource(int idx) const
+{
+    return (0 <= idx && idx < count())
+        ? m_rows[static_cast<size_t>(idx)]
+        : -1;
+}
+
+int GameFilterModel::mapFromSource(int source_idx) const
+{
+    return (0 <= source_idx && static_cast<size_t>(source_idx) < m_source_to_row.size())
+        ? m_source_to_row[static_cast<size_t>(source_idx)]
+        : -1;
+}
+
+int GameFilterModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant GameFilterModel::data(const QModelIndex& index, int role) const
+{
+    const int source_idx = index.isValid() ? mapToSource(index.row()) : -1;
+    return source_idx >= 0
+        ? m_source->data(m_source->index(source_idx), role)
+        : QVariant();
+}
+
+QHash<int, QByteArray> GameFilterModel::roleNames() const
+{
+    return GameListModel::gameRoleNames();
+}
+} // namespace model
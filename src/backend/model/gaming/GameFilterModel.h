@@ -0,0 +1,164 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QQmlParserStatus>
+#include <array>
+#include <vector>
+
+namespace model { class GameFacetModel; }
+namespace model { class GameListModel; }
+namespace model { struct GameRowRef; }
+
+
+namespace model {
+/// A sorted and filtered view of a game list, for QML
+///
+/// The filters are evaluated in C++, with one pass bit per criterion for
+/// every game, so a change of one filter only re-evaluates that criterion.
+/// The order of the games for each sort key is calculated once, then
+/// reused until the related fields change.
+class GameFilterModel : public QAbstractListModel, public QQmlParserStatus {
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+
+public:
+    enum SortKey {
+        SourceOrder,
+        SortByTitle,
+        SortByRelease,
+        SortByRating,
+        SortByPlayers,
+        SortByLastPlayed,
+        SortByPlayCount,
+        SortByPlayTime,
+    };
+    Q_ENUM(SortKey)
+
+private:
+    Q_PROPERTY(model::GameListModel* sourceModel READ sourceModel WRITE setSourceModel NOTIFY sourceModelChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+    Q_PROPERTY(QString titleFilter READ titleFilter WRITE setTitleFilter NOTIFY titleFilterChanged)
+    Q_PROPERTY(QString genreFilter READ genreFilter WRITE setGenreFilter NOTIFY genreFilterChanged)
+    Q_PROPERTY(bool favoritesOnly READ favoritesOnly WRITE setFavoritesOnly NOTIFY favoritesOnlyChanged)
+    Q_PROPERTY(int minPlayers READ minPlayers WRITE setMinPlayers NOTIFY minPlayersChanged)
+    Q_PROPERTY(int releaseYearMin READ releaseYearMin WRITE setReleaseYearMin NOTIFY releaseYearRangeChanged)
+    Q_PROPERTY(int releaseYearMax READ releaseYearMax WRITE setReleaseYearMax NOTIFY releaseYearRangeChanged)
+    Q_PROPERTY(QDateTime lastPlayedSince READ lastPlayedSince WRITE setLastPlayedSince NOTIFY lastPlayedSinceChanged)
+    Q_PROPERTY(model::GameFacetModel* facets READ facets WRITE setFacets NOTIFY facetsChanged)
+
+    Q_PROPERTY(SortKey sortKey READ sortKey WRITE setSortKey NOTIFY sortChanged)
+    Q_PROPERTY(Qt::SortOrder sortOrder READ sortOrder WRITE setSortOrder NOTIFY sortChanged)
+
+public:
+    explicit GameFilterModel(QObject* parent = nullptr);
+
+    GameListModel* sourceModel() const { return m_source; }
+    void setSourceModel(GameListModel*);
+    int count() const { return static_cast<int>(m_rows.size()); }
+
+    const QString& titleFilter() const { return m_title; }
+    const QString& genreFilter() const { return m_genre; }
+    bool favoritesOnly() const { return m_favorites_only; }
+    int minPlayers() const { return m_min_players; }
+    int releaseYearMin() const { return m_year_min; }
+    int releaseYearMax() const { return m_year_max; }
+    const QDateTime& lastPlayedSince() const { return m_last_played_since; }
+    GameFacetModel* facets() const { return m_facets; }
+    SortKey sortKey() const { return m_sort_key; }
+    Qt::SortOrder sortOrder() const { return m_sort_order; }
+
+    void setTitleFilter(QString);
+    void setGenreFilter(QString);
+    void setFavoritesOnly(bool);
+    void setMinPlayers(int);
+    void setReleaseYearMin(int);
+    void setReleaseYearMax(int);
+    void setLastPlayedSince(QDateTime);
+    void setFacets(GameFacetModel*);
+    void setSortKey(SortKey);
+    void setSortOrder(Qt::SortOrder);
+
+    Q_INVOKABLE QObject* get(int idx) const;
+    Q_INVOKABLE int mapToSource(int idx) const;
+    Q_INVOKABLE int mapFromSource(int source_idx) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void classBegin() override;
+    void componentComplete() override;
+
+signals:
+    void sourceModelChanged();
+    void countChanged();
+    void titleFilterChanged();
+    void genreFilterChanged();
+    void favoritesOnlyChanged();
+    void minPlayersChanged();
+    void releaseYearRangeChanged();
+    void lastPlayedSinceChanged();
+    void facetsChanged();
+    void sortChanged();
+
+private slots:
+    void onSourceReset();
+    void onSourceDataChanged(const QModelIndex&, const QModelIndex&, const QVector<int>&);
+
+private:
+    GameListModel* m_source;
+    bool m_complete;
+
+    QString m_title;
+    QString m_genre;
+    bool m_favorites_only;
+    int m_min_players;
+    int m_year_min;
+    int m_year_max;
+    QDateTime m_last_played_since;
+    GameFacetModel* m_facets;
+    SortKey m_sort_key;
+    Qt::SortOrder m_sort_order;
+
+    // one bit for each failed criterion, per source row
+    std::vector<unsigned char> m_fail_bits;
+    // cached source row order for each sort key; empty if not calculated yet
+    std::array<std::vector<int>, SortByPlayTime + 1> m_permutations;
+    // the visible source rows, and the reverse mapping
+    std::vector<int> m_rows;
+    std::vector<int> m_source_to_row;
+
+    bool passes(unsigned char filter_bit, int source_row, const GameRowRef&) const;
+    void evaluate(unsigned char filter_bits, int first, int last, bool narrowing = false);
+    void refilter(unsigned char filter_bits, bool narrowing = false);
+    const std::vector<int>& permutation(SortKey);
+
+    std::vector<int> visibleRows();
+    void rebuildSourceMapping();
+    void resetRows();
+    void updateRows();
+    void removeHiddenRows();
+    void reorderRows(const std::vector<int>&);
+    void insertShownRows(const std::vector<int>&);
+};
+} // namespace model
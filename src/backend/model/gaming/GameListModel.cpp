@@ -0,0 +1,316 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "GameListModel.h"
+
+#include "model/gaming/Assets.h"
+#include "model/gaming/Game.h"
+#include "model/gaming/FacetIndex.h"
+#include "model/gaming/GameEvents.h"
+#include "model/gaming/SearchIndex.h"
+
+#include <algorithm>
+#include <array>
+
+
+namespace {
+QString joined_list(const QStringList& list) { return list.join(QLatin1String(", ")); }
+
+// NOTE: the values are read from the columns of the store; the Game object
+//       is only created for the object roles
+using RoleGetter = QVariant (*)(model::GameStore&, size_t);
+
+struct RoleEntry {
+    const char* name;
+    RoleGetter getter;
+};
+
+// NOTE: the order must match the role enum
+const std::array<RoleEntry, model::GameListModel::CollectionsRole - model::GameListModel::ModelDataRole + 1> ROLE_TABLE {{
+    { "modelData", [](model::GameStore& store, size_t row) -> QVariant {
+        return QVariant::fromValue(static_cast<QObject*>(store.game(row))); } },
+    { "title", [](model::GameStore& store, size_t row) -> QVariant { return store.titles[row]; } },
+    { "sortTitle", [](model::GameStore& store, size_t row) -> QVariant { return store.sort_titles[row]; } },
+    { "sortBy", [](model::GameStore& store, size_t row) -> QVariant { return store.sort_titles[row]; } },
+    { "summary", [](model::GameStore& store, size_t row) -> QVariant { return store.summaries[row]; } },
+    { "description", [](model::GameStore& store, size_t row) -> QVariant { return store.descriptions[row]; } },
+    { "release", [](model::GameStore& store, size_t row) -> QVariant { return store.release_dates[row]; } },
+    { "players", [](model::GameStore& store, size_t row) -> QVariant { return static_cast<int>(store.player_counts[row]); } },
+    { "rating", [](model::GameStore& store, size_t row) -> QVariant { return store.ratings[row]; } },
+    { "releaseYear", [](model::GameStore& store, size_t row) -> QVariant { return store.release_dates[row].year(); } },
+    { "releaseMonth", [](model::GameStore& store, size_t row) -> QVariant { return store.release_dates[row].month(); } },
+    { "releaseDay", [](model::GameStore& store, size_t row) -> QVariant { return store.release_dates[row].day(); } },
+    { "playCount", [](model::GameStore& store, size_t row) -> QVariant { return store.play_counts[row]; } },
+    { "playTime", [](model::GameStore& store, size_t row) -> QVariant { return store.play_times[row]; } },
+    { "lastPlayed", [](model::GameStore& store, size_t row) -> QVariant { return store.last_played[row]; } },
+    { "favorite", [](model::GameStore& store, size_t row) -> QVariant { return static_cast<bool>(store.favorites[row]); } },
+    { "developer", [](model::GameStore& store, size_t row) -> QVariant { return joined_list(store.developers[row]); } },
+    { "developerList", [](model::GameStore& store, size_t row) -> QVariant { return store.developers[row]; } },
+    { "publisher", [](model::GameStore& store, size_t row) -> QVariant { return joined_list(store.publishers[row]); } },
+    { "publisherList", [](model::GameStore& store, size_t row) -> QVariant { return store.publishers[row]; } },
+    { "genre", [](model::GameStore& store, size_t row) -> QVariant { return joined_list(store.genres[row]); } },
+    { "genreList", [](model::GameStore& store, size_t row) -> QVariant { return store.genres[row]; } },
+    { "tag", [](model::GameStore& store, size_t row) -> QVariant { return joined_list(store.tags[row]); } },
+    { "tagList", [](model::GameStore& store, size_t row) -> QVariant { return store.tags[row]; } },
+    { "assets", [](model::GameStore& store, size_t row) -> QVariant {
+        model::Assets* const assets = store.assets[row];
+        return QVariant::fromValue(assets ? assets : store.game(row)->assetsPtr()); } },
+    { "files", [](model::GameStore& store, size_t row) -> QVariant {
+        return QVariant::fromValue(store.game(row)->filesModel()); } },
+    { "collections", [](model::GameStore& store, size_t row) -> QVariant {
+        return QVariant::fromValue(store.game(row)->collectionsModel()); } },
+}};
+} // namespace
+
+
+namespace model {
+GameListModel::GameListModel(QObject* parent)
+    : QAbstractListModel(parent)
+    , m_changed_flags(0)
+    , m_changed_first(0)
+    , m_changed_last(0)
+{
+    // the list can be large, so instead of connecting to every game,
+    // the changes are received through the shared dispatcher
+    connect(&GameEvents::instance(), &GameEvents::favoriteChanged,
+            this, &GameListModel::onGameFavoriteChanged);
+    connect(&GameEvents::instance(), &GameEvents::playStatsChanged,
+            this, &GameListModel::onGamePlayStatsChanged);
+}
+
+QHash<int, QByteArray> GameListModel::roleNames() const
+{
+    return gameRoleNames();
+}
+
+const QHash<int, QByteArray>& GameListModel::gameRoleNames()
+{
+    static const QHash<int, QByteArray> roles = []{
+        QHash<int, QByteArray> out;
+        for (size_t i = 0; i < ROLE_TABLE.size(); i++)
+            out.insert(ModelDataRole + static_cast<int>(i), QByteArray(ROLE_TABLE[i].name));
+        return out;
+    }();
+    return roles;
+}
+
+int GameListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant GameListModel::data(const QModelIndex& index, int role) const
+{
+    const size_t role_idx = static_cast<size_t>(role - ModelDataRole);
+    if (!index.isValid() || index.row() >= count() || ROLE_TABLE.size() <= role_idx)
+        return QVariant();
+
+    const GameRowRef& ref = m_row_refs[static_cast<size_t>(index.row())];
+    return ROLE_TABLE[role_idx].getter(*ref.store, ref.row);
+}
+
+bool GameListModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (!index.isValid() || index.row() >= count() || role != FavoriteRole)
+        return false;
+
+    at(index.row())->setFavorite(value.toBool());
+    return true;
+}
+
+Game* GameListModel::at(int idx) const
+{
+    if (idx < 0 || count() <= idx)
+        return nullptr;
+
+    const GameRowRef& ref = m_row_refs[static_cast<size_t>(idx)];
+    return ref.store->game(ref.row);
+}
+
+QObject* GameListModel::get(int idx) const { return at(idx); }
+QObject* GameListModel::getFirst() const { return at(0); }
+QObject* GameListModel::getLast() const { return at(count() - 1); }
+
+int GameListModel::indexOf(QObject* item) const
+{
+    const auto* const game = qobject_cast<const Game*>(item);
+    return game
+        ? m_rows.value(RowKey(&game->store(), game->storeRow()), -1)
+        : -1;
+}
+
+QVector<Game*> GameListModel::asList() const
+{
+    QVector<Game*> out;
+    out.reserve(count());
+    for (const GameRowRef& ref : m_row_refs)
+        out.append(ref.store->game(ref.row));
+    return out;
+}
+
+QVariantList GameListModel::toVarArray() const
+{
+    QVariantList out;
+    out.reserve(count());
+    for (const GameRowRef& ref : m_row_refs)
+        out.append(QVariant::fromValue(static_cast<QObject*>(ref.store->game(ref.row))));
+    return out;
+}
+
+void GameListModel::append(QVector<Game*> games,
+                           std::shared_ptr<const SearchIndex> search_index,
+                           std::shared_ptr<FacetIndex> facet_index)
+{
+    std::vector<GameRowRef> refs;
+    refs.reserve(static_cast<size_t>(games.count()));
+    for (Game* const game : qAsConst(games)) {
+        Q_ASSERT(game->store().games[game->storeRow()] == game);
+        refs.push_back(game->rowRef());
+
+        if (m_stores.find(&game->store()) == m_stores.cend())
+            m_stores.emplace(&game->store(), game->sharedStore());
+    }
+
+    appendRows(std::move(refs), std::move(search_index), std::move(facet_index));
+}
+
+void GameListModel::append(const std::shared_ptr<GameStore>& store,
+                           std::shared_ptr<const SearchIndex> search_index,
+                           std::shared_ptr<FacetIndex> facet_index)
+{
+    Q_ASSERT(store);
+
+    std::vector<GameRowRef> refs;
+    refs.reserve(store->size());
+    for (size_t row = 0; row < store->size(); row++)
+        refs.push_back(GameRowRef { store.get(), row });
+
+    m_stores.emplace(store.get(), store);
+    appendRows(std::move(refs), std::move(search_index), std::move(facet_index));
+}
+
+void GameListModel::appendRows(std::vector<GameRowRef> refs,
+                               std::shared_ptr<const SearchIndex> search_index,
+                               std::shared_ptr<FacetIndex> facet_index)
+{
+    if (refs.empty())
+        return;
+
+    const int first = count();
+    const int last = first + static_cast<int>(refs.size()) - 1;
+
+    m_search_index.reset();
+    m_facet_index.reset();
+
+    beginInsertRows(QModelIndex(), first, last);
+
+    m_rows.reserve(last + 1);
+    m_row_refs.reserve(m_row_refs.size() + refs.size());
+    for (const GameRowRef& ref : refs) {
+        m_rows.insert(RowKey(ref.store, ref.row), count());
+        m_row_refs.push_back(ref);
+    }
+
+    // set before the views learn about the new rows, so they don't build their own
+    setSearchIndex(std::move(search_index));
+    m_facet_index = std::move(facet_index);
+    Q_ASSERT(!m_facet_index || m_facet_index->size() == m_row_refs.size());
+
+    endInsertRows();
+    emit countChanged();
+}
+
+void GameListModel::setSearchIndex(std::shared_ptr<const SearchIndex> index)
+{
+    Q_ASSERT(!index || index->size() == m_row_refs.size());
+    m_search_index = std::move(index);
+}
+
+void GameListModel::setFacetIndex(std::shared_ptr<FacetIndex> index)
+{
+    Q_ASSERT(!index || index->size() == m_row_refs.size());
+    if (m_facet_index == index)
+        return;
+
+    m_facet_index = std::move(index);
+    emit facetIndexChanged();
+}
+
+void GameListModel::clear()
+{
+    m_search_index.reset();
+    m_facet_index.reset();
+    if (m_row_refs.empty())
+        return;
+
+    beginResetModel();
+    m_rows.clear();
+    m_row_refs.clear();
+    m_stores.clear();
+    m_changed_flags = 0;
+    endResetModel();
+
+    emit countChanged();
+}
+
+void GameListModel::onGameFavoriteChanged(model::Game* game)
+{
+    markChanged(game, CHANGED_FAVORITE);
+}
+
+void GameListModel::onGamePlayStatsChanged(model::Game* game)
+{
+    markChanged(game, CHANGED_PLAYSTATS);
+}
+
+void GameListModel::markChanged(const model::Game* game, unsigned char flag)
+{
+    const int row = m_rows.value(RowKey(&game->store(), game->storeRow()), -1);
+    if (row < 0)
+        return;
+
+    if (m_facet_index)
+        m_facet_index->updateDynamicFacets(static_cast<size_t>(row), *game);
+
+    if (m_changed_flags == 0) {
+        m_changed_first = row;
+        m_changed_last = row;
+        QMetaObject::invokeMethod(this, "flushChanges", Qt::QueuedConnection);
+    }
+    else {
+        m_changed_first = std::min(m_changed_first, row);
+        m_changed_last = std::max(m_changed_last, row);
+    }
+    m_changed_flags |= flag;
+}
+
+void GameListModel::flushChanges()
+{
+    if (m_changed_flags == 0)
+        return;
+
+    QVector<int> roles;
+    if (m_changed_flags & CHANGED_FAVORITE)
+        roles << FavoriteRole;
+    if (m_changed_flags & CHANGED_PLAYSTATS)
+        roles << PlayCountRole << PlayTimeRole << LastPlayedRole;
+
+    m_changed_flags = 0;
+    emit dataChanged(index(m_changed_first), index(m_changed_last), roles);
+}
+} // namespace model
@@ -0,0 +1,157 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include "model/gaming/GameStore.h"
+
+#include "utils/HashMap.h"
+
+#include <QAbstractListModel>
+#include <QPair>
+#include <QVector>
+#include <memory>
+
+namespace model { class FacetIndex; }
+namespace model { class Game; }
+namespace model { class SearchIndex; }
+
+
+namespace model {
+/// A read-only list model of games, for QML
+///
+/// Unlike the generic object list models, the role ids are fixed and
+/// the values are read through a table of getters, without looking up
+/// the properties of the games by name. The list stores the rows of the
+/// games, and the Game objects are only created for the object roles and
+/// the getters returning them. The changes of the games are reported in
+/// batches, once per event loop iteration.
+class GameListModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        ModelDataRole = Qt::UserRole + 1,
+        TitleRole,
+        SortTitleRole,
+        SortByRole,
+        SummaryRole,
+        DescriptionRole,
+        ReleaseRole,
+        PlayersRole,
+        RatingRole,
+        ReleaseYearRole,
+        ReleaseMonthRole,
+        ReleaseDayRole,
+        PlayCountRole,
+        PlayTimeRole,
+        LastPlayedRole,
+        FavoriteRole,
+        DeveloperRole,
+        DeveloperListRole,
+        PublisherRole,
+        PublisherListRole,
+        GenreRole,
+        GenreListRole,
+        TagRole,
+        TagListRole,
+        AssetsRole,
+        FilesRole,
+        CollectionsRole,
+    };
+
+    explicit GameListModel(QObject* parent = nullptr);
+
+    int count() const { return static_cast<int>(m_row_refs.size()); }
+    /// The Game objects of the list; this creates the objects of every game,
+    /// so prefer rowRefs() for large lists
+    QVector<model::Game*> asList() const;
+    /// The store rows of the games, in the order of the list
+    const std::vector<GameRowRef>& rowRefs() const { return m_row_refs; }
+    model::Game* at(int idx) const;
+
+    /// Appends the games; the indices, if given, should cover the whole list
+    /// after the append, and are in place by the time the rows are reported
+    void append(QVector<model::Game*>,
+                std::shared_ptr<const SearchIndex> search_index = {},
+                std::shared_ptr<FacetIndex> facet_index = {});
+    /// Appends every row of the store, without creating their Game objects
+    void append(const std::shared_ptr<GameStore>&,
+                std::shared_ptr<const SearchIndex> search_index = {},
+                std::shared_ptr<FacetIndex> facet_index = {});
+    void clear();
+
+    /// The full text index of the games, if available;
+    /// changing the list invalidates it
+    const std::shared_ptr<const SearchIndex>& searchIndex() const { return m_search_index; }
+    void setSearchIndex(std::shared_ptr<const SearchIndex>);
+    /// The facet bitmaps of the games, if available; the favorite and
+    /// play stats bits are kept up to date by the list. Replacing it without
+    /// changing the rows is reported by facetIndexChanged().
+    const std::shared_ptr<FacetIndex>& facetIndex() const { return m_facet_index; }
+    void setFacetIndex(std::shared_ptr<FacetIndex>);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role) override;
+    QHash<int, QByteArray> roleNames() const override;
+    static const QHash<int, QByteArray>& gameRoleNames();
+
+    // the same QML API as the object list models
+    Q_INVOKABLE int size() const { return count(); }
+    Q_INVOKABLE bool isEmpty() const { return m_row_refs.empty(); }
+    Q_INVOKABLE QObject* get(int idx) const;
+    Q_INVOKABLE QObject* getFirst() const;
+    Q_INVOKABLE QObject* getLast() const;
+    Q_INVOKABLE int indexOf(QObject* item) const;
+    Q_INVOKABLE bool contains(QObject* item) const { return indexOf(item) >= 0; }
+    Q_INVOKABLE QVariantList toVarArray() const;
+
+signals:
+    void countChanged();
+    void facetIndexChanged();
+
+private slots:
+    void onGameFavoriteChanged(model::Game*);
+    void onGamePlayStatsChanged(model::Game*);
+    void flushChanges();
+
+private:
+    using RowKey = QPair<const GameStore*, size_t>;
+
+    std::vector<GameRowRef> m_row_refs;
+    QHash<RowKey, int> m_rows;
+    HashMap<const GameStore*, std::shared_ptr<GameStore>> m_stores;
+    std::shared_ptr<const SearchIndex> m_search_index;
+    std::shared_ptr<FacetIndex> m_facet_index;
+
+    enum ChangeFlags : unsigned char {
+        CHANGED_FAVORITE = 1 << 0,
+        CHANGED_PLAYSTATS = 1 << 1,
+    };
+    unsigned char m_changed_flags;
+    int m_changed_first;
+    int m_changed_last;
+
+    void appendRows(std::vector<GameRowRef>,
+                    std::shared_ptr<const SearchIndex>,
+                    std::shared_ptr<FacetIndex>);
+    void markChanged(const model::Game*, unsigned char);
+};
+} // namespace model
@@ -0,0 +1,250 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "GameSearchModel.h"
+
+#include "model/gaming/Game.h"
+#include "model/gaming/GameListModel.h"
+#include "model/gaming/SearchIndex.h"
+
+#include <QFutureWatcher>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+
+
+namespace {
+// the number of results inserted in one event loop iteration
+constexpr size_t RESULT_BATCH_SIZE = 100;
+} // namespace
+
+
+namespace model {
+GameSearchModel::GameSearchModel(QObject* parent)
+    : QAbstractListModel(parent)
+    , m_source(nullptr)
+    , m_source_generation(0)
+    , m_limit(0)
+    , m_scheduled(false)
+    , m_running(false)
+    , m_rerun_needed(false)
+    , m_next_batch(0)
+{}
+
+void GameSearchModel::setSourceModel(GameListModel* source)
+{
+    if (m_source == source)
+        return;
+
+    if (m_source)
+        disconnect(m_source, nullptr, this, nullptr);
+
+    m_source = source;
+    m_source_generation++;
+    if (m_source) {
+        const auto on_source_change = [this]{
+            m_source_generation++;
+            resetResults();
+            scheduleSearch();
+        };
+        connect(m_source, &QObject::destroyed,
+                this, [this]{ setSourceModel(nullptr); });
+        connect(m_source, &QAbstractItemModel::modelReset, this, on_source_change);
+        connect(m_source, &QAbstractItemModel::rowsInserted, this, on_source_change);
+        connect(m_source, &QAbstractItemModel::rowsRemoved, this, on_source_change);
+    }
+
+    emit sourceModelChanged();
+    resetResults();
+    scheduleSearch();
+}
+
+void GameSearchModel::setQuery(QString query)
+{
+    if (m_query == query)
+        return;
+
+    m_query = std::move(query);
+    emit queryChanged();
+    scheduleSearch();
+}
+
+void GameSearchModel::setLimit(int limit)
+{
+    limit = std::max(0, limit);
+    if (m_limit == limit)
+        return;
+
+    m_limit = limit;
+    emit limitChanged();
+    scheduleSearch();
+}
+
+void GameSearchModel::scheduleSearch()
+{
+    if (m_scheduled)
+        return;
+
+    m_scheduled = true;
+    QMetaObject::invokeMethod(this, "startSearch", Qt::QueuedConnection);
+}
+
+void GameSearchModel::startSearch()
+{
+    m_scheduled = false;
+    if (m_running) {
+        m_rerun_needed = true;
+        return;
+    }
+
+    if (!m_source || m_query.trimmed().isEmpty()) {
+        resetResults();
+        return;
+    }
+
+    m_running = true;
+    emit runningChanged();
+
+    const GameListModel* const source = m_source;
+    const unsigned source_generation = m_source_generation;
+    const std::shared_ptr<const SearchIndex> index = m_source->searchIndex();
+    const std::vector<GameRowRef> refs = m_source->rowRefs();
+    const QString query = m_query;
+    const size_t limit = static_cast<size_t>(m_limit);
+
+    auto* const watcher = new QFutureWatcher<SearchJob>(this);
+    connect(watcher, &QFutureWatcher<SearchJob>::finished,
+        this, [this, watcher]{
+            const SearchJob job = watcher->result();
+            watcher->deleteLater();
+            onSearchFinished(job);
+        });
+
+    watcher->setFuture(QtConcurrent::run([source, source_generation, index, refs, query, limit]{
+        SearchJob job;
+        job.source = source;
+        job.source_generation = source_generation;
+        job.index = index ? index : std::shared_ptr<const SearchIndex>(new SearchIndex(refs));
+        job.rows = job.index->find(query, limit);
+        return job;
+    }));
+}
+
+void GameSearchModel::onSearchFinished(const SearchJob& job)
+{
+    m_running = false;
+
+    // the source may have been replaced or changed since the job started,
+    // in which case neither the index nor the rows belong to it anymore
+    const bool job_current = m_source
+        && job.source == m_source
+        && job.source_generation == m_source_generation;
+
+    // keep the index for the next queries
+    if (job_current && !m_source->searchIndex())
+        m_source->setSearchIndex(job.index);
+
+    if (m_rerun_needed || !job_current) {
+        m_rerun_needed = false;
+        startSearch();
+        return;
+    }
+
+    resetResults();
+    if (job.rows.empty()) {
+        emit runningChanged();
+        return;
+    }
+
+    m_pending_rows = job.rows;
+    m_next_batch = 0;
+    insertNextBatch();
+}
+
+void GameSearchModel::insertNextBatch()
+{
+    if (m_pending_rows.empty())
+        return;
+
+    const size_t batch_end = std::min(m_next_batch + RESULT_BATCH_SIZE, m_pending_rows.size());
+    if (m_next_batch < batch_end) {
+        const int first = count();
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(batch_end - m_next_batch) - 1);
+        m_rows.insert(m_rows.end(), m_pending_rows.cbegin() + m_next_batch, m_pending_rows.cbegin() + batch_end);
+        endInsertRows();
+        emit countChanged();
+    }
+    m_next_batch = batch_end;
+
+    if (m_next_batch < m_pending_rows.size()) {
+        QTimer::singleShot(0, this, &GameSearchModel::insertNextBatch);
+        return;
+    }
+
+    m_pending_rows.clear();
+    m_next_batch = 0;
+    emit runningChanged();
+}
+
+void GameSearchModel::resetResults()
+{
+    const bool had_rows = !m_rows.empty();
+
+    beginResetModel();
+    m_rows.clear();
+    m_pending_rows.clear();
+    m_next_batch = 0;
+    endResetModel();
+
+    if (had_rows)
+        emit countChanged();
+}
+
+QObject* GameSearchModel::get(int idx) const
+{
+    const int source_idx = mapToSource(idx);
+    return source_idx >= 0
+        ? m_source->at(source_idx)
+        : nullptr;
+}
+
+int GameSearchModel::mapToSource(int idx) const
+{
+    return (m_source && 0 <= idx && idx < count())
+        ? m_rows[static_cast<size_t>(idx)]
+        : -1;
+}
+
+int GameSearchModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant GameSearchModel::data(const QModelIndex& index, int role) const
+{
+    const int source_idx = index.isValid() ? mapToSource(index.row()) : -1;
+    return source_idx >= 0
+        ? m_source->data(m_source->index(source_idx), role)
+        : QVariant();
+}
+
+QHash<int, QByteArray> GameSearchModel::roleNames() const
+{
+    return GameListModel::gameRoleNames();
+}
+} // namespace model
@@ -0,0 +1,103 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <memory>
+#include <vector>
+
+namespace model { class GameListModel; }
+namespace model { class SearchIndex; }
+
+
+namespace model {
+/// The results of a full text search in a game list, for QML
+///
+/// The query runs on a worker thread, using the search index of the source
+/// (which is created on demand if the source doesn't have one). The ranked
+/// results are then added in small batches, so the first items can appear
+/// before all of them are inserted. Queries made while an other one is
+/// running are merged, and only the latest one is executed; the results of a
+/// query started before the source was changed are dropped.
+class GameSearchModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(model::GameListModel* sourceModel READ sourceModel WRITE setSourceModel NOTIFY sourceModelChanged)
+    Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+    Q_PROPERTY(int limit READ limit WRITE setLimit NOTIFY limitChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+
+public:
+    explicit GameSearchModel(QObject* parent = nullptr);
+
+    GameListModel* sourceModel() const { return m_source; }
+    void setSourceModel(GameListModel*);
+    const QString& query() const { return m_query; }
+    void setQuery(QString);
+    int limit() const { return m_limit; }
+    void setLimit(int);
+    int count() const { return static_cast<int>(m_rows.size()); }
+    bool running() const { return m_running || m_next_batch < m_pending_rows.size(); }
+
+    Q_INVOKABLE QObject* get(int idx) const;
+    Q_INVOKABLE int mapToSource(int idx) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void sourceModelChanged();
+    void queryChanged();
+    void limitChanged();
+    void countChanged();
+    void runningChanged();
+
+private slots:
+    void scheduleSearch();
+    void startSearch();
+    void insertNextBatch();
+
+private:
+    struct SearchJob {
+        // the source and its contents the job was started with
+        const GameListModel* source = nullptr;
+        unsigned source_generation = 0;
+
+        std::shared_ptr<const SearchIndex> index;
+        std::vector<int> rows;
+    };
+
+    GameListModel* m_source;
+    unsigned m_source_generation;
+    QString m_query;
+    int m_limit;
+
+    bool m_scheduled;
+    bool m_running;
+    bool m_rerun_needed;
+
+    std::vector<int> m_rows;
+    std::vector<int> m_pending_rows;
+    size_t m_next_batch;
+
+    void onSearchFinished(const SearchJob&);
+    void resetResults();
+};
+} // namespace model
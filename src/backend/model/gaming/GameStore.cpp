@@ -0,0 +1,139 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "GameStore.h"
+
+#include "model/gaming/Game.h"
+#include "model/gaming/GameFile.h"
+
+
+namespace model {
+GameStore::GameStore() = default;
+
+void GameStore::reserve(size_t count)
+{
+    games.reserve(count);
+    assets.reserve(count);
+    files.reserve(count);
+    collections.reserve(count);
+    titles.reserve(count);
+    sort_titles.reserve(count);
+    summaries.reserve(count);
+    descriptions.reserve(count);
+    developers.reserve(count);
+    publishers.reserve(count);
+    genres.reserve(count);
+    tags.reserve(count);
+    player_counts.reserve(count);
+    ratings.reserve(count);
+    release_dates.reserve(count);
+    play_counts.reserve(count);
+    play_times.reserve(count);
+    last_played.reserve(count);
+    favorites.reserve(count);
+    launch_cmds.reserve(count);
+    launch_workdirs.reserve(count);
+    launch_basedirs.reserve(count);
+}
+
+size_t GameStore::add_row(Game* game)
+{
+    games.emplace_back(game);
+    assets.emplace_back(nullptr);
+    files.emplace_back();
+    collections.emplace_back();
+    titles.emplace_back();
+    sort_titles.emplace_back();
+    summaries.emplace_back();
+    descriptions.emplace_back();
+    developers.emplace_back();
+    publishers.emplace_back();
+    genres.emplace_back();
+    tags.emplace_back();
+    player_counts.emplace_back(1);
+    ratings.emplace_back(0.f);
+    release_dates.emplace_back();
+    play_counts.emplace_back(0);
+    play_times.emplace_back(0);
+    last_played.emplace_back();
+    favorites.emplace_back(false);
+    launch_cmds.emplace_back();
+    launch_workdirs.emplace_back();
+    launch_basedirs.emplace_back();
+
+    return games.size() - 1;
+}
+
+size_t GameStore::take_row(GameStore& other, size_t row, Game* game)
+{
+    Q_ASSERT(row < other.size());
+    Q_ASSERT(other.games[row] == game);
+    other.games[row] = nullptr;
+
+    games.emplace_back(game);
+    assets.emplace_back(other.assets[row]);
+    files.emplace_back(std::move(other.files[row]));
+    collections.emplace_back(std::move(other.collections[row]));
+    other.assets[row] = nullptr;
+    titles.emplace_back(std::move(other.titles[row]));
+    sort_titles.emplace_back(std::move(other.sort_titles[row]));
+    summaries.emplace_back(std::move(other.summaries[row]));
+    descriptions.emplace_back(std::move(other.descriptions[row]));
+    developers.emplace_back(std::move(other.developers[row]));
+    publishers.emplace_back(std::move(other.publishers[row]));
+    genres.emplace_back(std::move(other.genres[row]));
+    tags.emplace_back(std::move(other.tags[row]));
+    player_counts.emplace_back(other.player_counts[row]);
+    ratings.emplace_back(other.ratings[row]);
+    release_dates.emplace_back(other.release_dates[row]);
+    play_counts.emplace_back(other.play_counts[row]);
+    play_times.emplace_back(other.play_times[row]);
+    last_played.emplace_back(std::move(other.last_played[row]));
+    favorites.emplace_back(other.favorites[row]);
+    launch_cmds.emplace_back(std::move(other.launch_cmds[row]));
+    launch_workdirs.emplace_back(std::move(other.launch_workdirs[row]));
+    launch_basedirs.emplace_back(std::move(other.launch_basedirs[row]));
+
+    const size_t new_row = games.size() - 1;
+    for (GameFile* const gamefile : qAsConst(files.back()))
+        gamefile->setStoreRow(shared_from_this(), new_row);
+
+    return new_row;
+}
+
+Game* GameStore::game(size_t row)
+{
+    Q_ASSERT(row < size());
+    if (games[row])
+        return games[row];
+
+    // the constructor registers the object in the row
+    auto* const game_ptr = new Game(shared_from_this(), row);
+    if (m_object_parent) {
+        game_ptr->moveToThread(m_object_parent->thread());
+        game_ptr->setParent(m_object_parent);
+    }
+    Q_ASSERT(games[row] == game_ptr);
+    return game_ptr;
+}
+
+void GameStore::set_object_parent(QObject* parent)
+{
+    m_object_parent = parent;
+}
+} // namespace model
@@ -0,0 +1,113 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include "utils/NoCopyNoMove.h"
+
+#include <QDate>
+#include <QDateTime>
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+namespace model { class Assets; }
+namespace model { class Collection; }
+namespace model { class Game; }
+namespace model { class GameFile; }
+
+
+namespace model {
+/// Column-oriented storage of game data
+///
+/// Every field of the games is stored in its own array, and a Game object
+/// is a view of one row. The providers create a Game object for every game
+/// during scanning, but these are deleted at the end of it; after that, the
+/// Game object of a row is only created when something asks for it with
+/// game(), which in practice means the games the UI actually shows. The code
+/// working with one field of every game (eg. the list models, sorting and
+/// filtering) reads the columns directly, with the help of GameRowRef.
+///
+/// The store must be owned by a shared_ptr; the Game objects and the files
+/// keep it alive.
+class GameStore : public std::enable_shared_from_this<GameStore> {
+public:
+    explicit GameStore();
+    NO_COPY_NO_MOVE(GameStore)
+
+    size_t size() const { return games.size(); }
+    void reserve(size_t);
+
+    /// Adds a default row for the game, and returns its index
+    size_t add_row(Game*);
+    /// Moves a row of an other store to the end of this one,
+    /// and returns its new index
+    size_t take_row(GameStore&, size_t, Game*);
+
+    /// Returns the Game object of the row, creating it if there's none
+    Game* game(size_t row);
+    /// The parent of the Game objects created by game(); these are moved
+    /// to its thread, and are deleted with it
+    void set_object_parent(QObject*);
+
+    /// The Game objects of the rows, or null if not created yet
+    std::vector<Game*> games;
+    /// The objects of the games; these are kept when the Game object
+    /// of the row is deleted
+    std::vector<Assets*> assets;
+    std::vector<QVector<GameFile*>> files;
+    std::vector<QVector<Collection*>> collections;
+
+    std::vector<QString> titles;
+    std::vector<QString> sort_titles;
+    std::vector<QString> summaries;
+    std::vector<QString> descriptions;
+
+    std::vector<QStringList> developers;
+    std::vector<QStringList> publishers;
+    std::vector<QStringList> genres;
+    std::vector<QStringList> tags;
+
+    std::vector<short> player_counts;
+    std::vector<float> ratings;
+    std::vector<QDate> release_dates;
+
+    std::vector<int> play_counts;
+    std::vector<int> play_times;
+    std::vector<QDateTime> last_played;
+    std::vector<bool> favorites;
+
+    std::vector<QString> launch_cmds;
+    std::vector<QString> launch_workdirs;
+    std::vector<QString> launch_basedirs;
+
+private:
+    QPointer<QObject> m_object_parent;
+};
+
+
+/// The location of a game in a store; valid until the game is moved to
+/// an other store, which only happens at the end of scanning
+struct GameRowRef {
+    GameStore* store;
+    size_t row;
+};
+} // namespace model
@@ -0,0 +1,257 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "SearchIndex.h"
+
+#include "model/gaming/GameStore.h"
+
+#include <algorithm>
+#include <array>
+
+
+namespace {
+enum FieldBit : unsigned char {
+    FIELD_TITLE = 1 << 0,
+    FIELD_SORT_TITLE = 1 << 1,
+    FIELD_DEVELOPER = 1 << 2,
+    FIELD_PUBLISHER = 1 << 3,
+    FIELD_GENRE = 1 << 4,
+    FIELD_TAG = 1 << 5,
+    FIELD_SUMMARY = 1 << 6,
+};
+
+// only the beginning of the summaries is indexed, to keep the index small
+constexpr int SUMMARY_INDEX_LEN = 200;
+
+constexpr int EXACT_TITLE_BONUS = 1000;
+constexpr int TITLE_PREFIX_BONUS = 500;
+
+// the score of a trigram found in the fields, which is the best field weight
+std::array<unsigned char, 256> create_mask_weights()
+{
+    constexpr std::array<unsigned char, 7> field_weights {{ 10, 8, 4, 3, 3, 2, 1 }};
+
+    std::array<unsigned char, 256> out {};
+    for (size_t mask = 0; mask < out.size(); mask++) {
+        for (size_t bit = 0; bit < field_weights.size(); bit++) {
+            if (mask & (1u << bit))
+                out[mask] = std::max(out[mask], field_weights[bit]);
+        }
+    }
+    return out;
+}
+const std::array<unsigned char, 256> MASK_WEIGHTS = create_mask_weights();
+
+// lowercase, without accents, and only letters and numbers separated by single spaces
+QString normalize(const QString& text)
+{
+    const QString decomposed = text.normalized(QString::NormalizationForm_KD).toCaseFolded();
+
+    QString out;
+    out.reserve(decomposed.length());
+    for (const QChar ch : decomposed) {
+        if (ch.isLetterOrNumber())
+            out.append(ch);
+        else if (!ch.isMark() && !out.isEmpty() && out.at(out.length() - 1) != QChar(' '))
+            out.append(QChar(' '));
+    }
+    if (!out.isEmpty() && out.at(out.length() - 1) == QChar(' '))
+        out.chop(1);
+
+    return out;
+}
+
+quint64 trigram_key(QChar a, QChar b, QChar c)
+{
+    return static_cast<quint64>(a.unicode()) << 32
+        | static_cast<quint64>(b.unicode()) << 16
+        | static_cast<quint64>(c.unicode());
+}
+
+// calls the function with the trigrams of every word, padded with spaces
+template<typename Func>
+void for_each_trigram(const QString& normalized, Func&& func)
+{
+    const QChar space(' ');
+    const int len = normalized.length();
+
+    int word_start = 0;
+    while (word_start < len) {
+        int word_end = normalized.indexOf(space, word_start);
+        if (word_end < 0)
+            word_end = len;
+
+        // the padded word is ` word `
+        const auto char_at = [&](int padded_idx){
+            const int idx = word_start + padded_idx - 1;
+            return (idx < word_start || word_end <= idx) ? space : normalized.at(idx);
+        };
+        const int padded_len = word_end - word_start + 2;
+        for (int i = 0; i + 2 < padded_len; i++)
+            func(trigram_key(char_at(i), char_at(i + 1), char_at(i + 2)));
+
+        word_start = word_end + 1;
+    }
+}
+
+void sort_and_limit(std::vector<std::pair<int, int>>& scored_rows, size_t limit, std::vector<int>& out)
+{
+    // best score first, then in the original order
+    std::sort(scored_rows.begin(), scored_rows.end(),
+        [](const std::pair<int, int>& a, const std::pair<int, int>& b){
+            return a.second != b.second
+                ? a.second > b.second
+                : a.first < b.first;
+        });
+
+    const size_t count = limit > 0 ? std::min(limit, scored_rows.size()) : scored_rows.size();
+    out.reserve(count);
+    for (size_t i = 0; i < count; i++)
+        out.push_back(scored_rows[i].first);
+}
+} // namespace
+
+
+namespace model {
+SearchIndex::SearchIndex(const std::vector<GameRowRef>& refs)
+{
+    m_titles.reserve(refs.size());
+
+    std::vector<std::pair<quint64, unsigned char>> game_trigrams;
+    for (size_t row = 0; row < refs.size(); row++) {
+        const GameStore& store = *refs[row].store;
+        const size_t store_row = refs[row].row;
+        game_trigrams.clear();
+
+        const auto add_field = [&game_trigrams](const QString& text, unsigned char field_bit){
+            for_each_trigram(normalize(text), [&game_trigrams, field_bit](quint64 key){
+                game_trigrams.emplace_back(key, field_bit);
+            });
+        };
+        const auto add_list = [&add_field](const QStringList& list, unsigned char field_bit){
+            for (const QString& item : list)
+                add_field(item, field_bit);
+        };
+
+        const QString& title = store.titles[store_row];
+        const QString& sort_title = store.sort_titles[store_row];
+        m_titles.emplace_back(normalize(title));
+        for_each_trigram(m_titles.back(), [&game_trigrams](quint64 key){
+            game_trigrams.emplace_back(key, FIELD_TITLE);
+        });
+        if (sort_title != title)
+            add_field(sort_title, FIELD_SORT_TITLE);
+        add_list(store.developers[store_row], FIELD_DEVELOPER);
+        add_list(store.publishers[store_row], FIELD_PUBLISHER);
+        add_list(store.genres[store_row], FIELD_GENRE);
+        add_list(store.tags[store_row], FIELD_TAG);
+        add_field(store.summaries[store_row].left(SUMMARY_INDEX_LEN), FIELD_SUMMARY);
+
+        // one posting per trigram, with all the fields it was found in
+        std::sort(game_trigrams.begin(), game_trigrams.end());
+        for (size_t i = 0; i < game_trigrams.size(); ) {
+            const quint64 key = game_trigrams[i].first;
+            unsigned char mask = 0;
+            for (; i < game_trigrams.size() && game_trigrams[i].first == key; i++)
+                mask |= game_trigrams[i].second;
+
+            m_postings[key].push_back(static_cast<quint32>(row) << 8 | mask);
+        }
+    }
+
+    for (auto& pair : m_postings)
+        pair.second.shrink_to_fit();
+}
+
+std::vector<int> SearchIndex::find(const QString& query, size_t limit) const
+{
+    const QString normalized = normalize(query);
+    if (normalized.isEmpty())
+        return {};
+    // too short for trigrams to be useful
+    if (normalized.length() < 3)
+        return find_short(normalized, limit);
+
+    std::vector<quint64> query_trigrams;
+    for_each_trigram(normalized, [&query_trigrams](quint64 key){ query_trigrams.push_back(key); });
+    std::sort(query_trigrams.begin(), query_trigrams.end());
+    query_trigrams.erase(std::unique(query_trigrams.begin(), query_trigrams.end()), query_trigrams.end());
+
+    std::vector<unsigned short> hits(m_titles.size(), 0);
+    std::vector<int> scores(m_titles.size(), 0);
+    std::vector<int> touched_rows;
+
+    for (const quint64 key : query_trigrams) {
+        const auto it = m_postings.find(key);
+        if (it == m_postings.cend())
+            continue;
+
+        for (const quint32 entry : it->second) {
+            const size_t row = entry >> 8;
+            if (hits[row] == 0)
+                touched_rows.push_back(static_cast<int>(row));
+
+            hits[row]++;
+            scores[row] += MASK_WEIGHTS[entry & 0xFF];
+        }
+    }
+
+    // a typo changes at most three trigrams; allow about one typo
+    // for every five characters of the query
+    const size_t trigram_cnt = query_trigrams.size();
+    const size_t allowed_typos = static_cast<size_t>(normalized.length() + 1) / 5;
+    const size_t min_hits = std::max<size_t>(1, trigram_cnt - std::min(trigram_cnt - 1, allowed_typos * 3));
+
+    std::vector<std::pair<int, int>> scored_rows;
+    for (const int row : touched_rows) {
+        const size_t row_idx = static_cast<size_t>(row);
+        if (hits[row_idx] < min_hits)
+            continue;
+
+        int score = scores[row_idx];
+        const int title_pos = m_titles[row_idx].indexOf(normalized);
+        if (title_pos >= 0)
+            score += title_pos == 0 ? EXACT_TITLE_BONUS + TITLE_PREFIX_BONUS : EXACT_TITLE_BONUS;
+
+        scored_rows.emplace_back(row, score);
+    }
+
+    std::vector<int> out;
+    sort_and_limit(scored_rows, limit, out);
+    return out;
+}
+
+std::vector<int> SearchIndex::find_short(const QString& normalized, size_t limit) const
+{
+    // only the titles are searched, at word starts
+    const QString word_start = QChar(' ') + normalized;
+
+    std::vector<std::pair<int, int>> scored_rows;
+    for (size_t row = 0; row < m_titles.size(); row++) {
+        const QString& title = m_titles[row];
+        if (title.startsWith(normalized))
+            scored_rows.emplace_back(static_cast<int>(row), TITLE_PREFIX_BONUS);
+        else if (title.contains(word_start))
+            scored_rows.emplace_back(static_cast<int>(row), 0);
+    }
+
+    std::vector<int> out;
+    sort_and_limit(scored_rows, limit, out);
+    return out;
+}
+} // namespace model
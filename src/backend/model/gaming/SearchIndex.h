@@ -0,0 +1,57 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include "utils/HashMap.h"
+#include "utils/NoCopyNoMove.h"
+
+#include <QString>
+#include <vector>
+
+namespace model { struct GameRowRef; }
+
+
+namespace model {
+/// Trigram based full text index of a game list
+///
+/// The titles, developers, publishers, genres, tags and the beginning of
+/// the summaries are split into lowercase, accent-free words, and every
+/// three character long part of the words (with the word boundaries) is
+/// mapped to the games containing it. A query matches the games that
+/// contain most of its trigrams, so small typos are tolerated.
+class SearchIndex {
+public:
+    explicit SearchIndex(const std::vector<GameRowRef>&);
+    NO_COPY_NO_MOVE(SearchIndex)
+
+    size_t size() const { return m_titles.size(); }
+
+    /// Returns the matching rows of the game list, best first.
+    /// If the limit is not zero, at most that many results are returned.
+    std::vector<int> find(const QString& query, size_t limit = 0) const;
+
+private:
+    // every entry is `row << 8 | field bits`
+    HashMap<quint64, std::vector<quint32>> m_postings;
+    // normalized titles, for exact match bonus and short queries
+    std::vector<QString> m_titles;
+
+    std::vector<int> find_short(const QString&, size_t) const;
+};
+} // namespace model
@@ -1,11 +1,29 @@
 HEADERS += \
+    $$PWD/AssetPrefetcher.h \
     $$PWD/Assets.h \
     $$PWD/Collection.h \
+    $$PWD/FacetIndex.h \
     $$PWD/Game.h \
+    $$PWD/GameEvents.h \
+    $$PWD/GameFacetModel.h \
     $$PWD/GameFile.h \
+    $$PWD/GameFilterModel.h \
+    $$PWD/GameListModel.h \
+    $$PWD/GameSearchModel.h \
+    $$PWD/GameStore.h \
+    $$PWD/SearchIndex.h \
 
 SOURCES += \
+    $$PWD/AssetPrefetcher.cpp \
     $$PWD/Assets.cpp \
     $$PWD/Collection.cpp \
+    $$PWD/FacetIndex.cpp \
     $$PWD/Game.cpp \
+    $$PWD/GameEvents.cpp \
+    $$PWD/GameFacetModel.cpp \
     $$PWD/GameFile.cpp \
+    $$PWD/GameFilterModel.cpp \
+    $$PWD/GameListModel.cpp \
+    $$PWD/GameSearchModel.cpp \
+    $$PWD/GameStore.cpp \
+    $$PWD/SearchIndex.cpp \
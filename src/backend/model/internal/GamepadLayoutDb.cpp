@@ -0,0 +1,125 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "GamepadLayoutDb.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace {
+constexpr int GUID_HEX_LEN = 32;
+
+bool is_hex_guid(const char* const str, int len)
+{
+    return len == GUID_HEX_LEN && std::all_of(str, str + len, [](char ch){
+        return ('0' <= ch && ch <= '9') || ('a' <= ch && ch <= 'f') || ('A' <= ch && ch <= 'F');
+    });
+}
+
+void to_lower_hex(char* const str, int len)
+{
+    std::transform(str, str + len, str, [](char ch){
+        return ('A' <= ch && ch <= 'F') ? static_cast<char>(ch - 'A' + 'a') : ch;
+    });
+}
+} // namespace
+
+
+namespace model {
+
+GamepadLayoutDb::GamepadLayoutDb(QByteArray contents, const QByteArray& platform)
+    : m_contents(std::move(contents))
+{
+    // SDL would skip the mappings of other platforms too
+    const QByteArray platform_field = QByteArrayLiteral("platform:") + platform + ',';
+
+    char* const db_data = m_contents.data();
+    int line_start = 0;
+    while (line_start < m_contents.size()) {
+        int line_end = m_contents.indexOf('\n', line_start);
+        if (line_end < 0)
+            line_end = m_contents.size();
+
+        int line_len = line_end - line_start;
+        if (line_len > 0 && db_data[line_end - 1] == '\r')
+            line_len--;
+
+        const QByteArray line = QByteArray::fromRawData(db_data + line_start, line_len);
+        const int name_len = line.indexOf(',');
+        const bool is_mapping = name_len > 0 && line.at(0) != '#';
+        const bool is_for_platform = !line.contains("platform:") || line.contains(platform_field);
+        if (is_mapping && is_for_platform) {
+            if (is_hex_guid(db_data + line_start, name_len)) {
+                to_lower_hex(db_data + line_start, name_len);
+                m_index.push_back({ line_start, line_len });
+            }
+            else {
+                m_special.push_back({ line_start, line_len });
+            }
+        }
+
+        line_start = line_end + 1;
+    }
+
+    // stable, so the last one of the same GUID can be found
+    std::stable_sort(m_index.begin(), m_index.end(),
+        [db_data](const Entry& a, const Entry& b){
+            return std::memcmp(db_data + a.offset, db_data + b.offset, GUID_HEX_LEN) < 0;
+        });
+    m_index.shrink_to_fit();
+    m_special.shrink_to_fit();
+}
+
+QByteArray GamepadLayoutDb::line_of(const Entry& entry) const
+{
+    return QByteArray(m_contents.constData() + entry.offset, entry.length);
+}
+
+QByteArray GamepadLayoutDb::find(const QByteArray& guid) const
+{
+    if (!is_hex_guid(guid.constData(), guid.size()))
+        return {};
+
+    QByteArray key = guid;
+    to_lower_hex(key.data(), key.size());
+
+    const char* const db_data = m_contents.constData();
+    const auto it = std::upper_bound(m_index.cbegin(), m_index.cend(), key,
+        [db_data](const QByteArray& value, const Entry& entry){
+            return std::memcmp(value.constData(), db_data + entry.offset, GUID_HEX_LEN) < 0;
+        });
+    if (it == m_index.cbegin())
+        return {};
+
+    const Entry& entry = *std::prev(it);
+    if (std::memcmp(key.constData(), db_data + entry.offset, GUID_HEX_LEN) != 0)
+        return {};
+
+    return line_of(entry);
+}
+
+std::vector<QByteArray> GamepadLayoutDb::specialMappings() const
+{
+    std::vector<QByteArray> out;
+    out.reserve(m_special.size());
+    for (const Entry& entry : m_special)
+        out.emplace_back(line_of(entry));
+    return out;
+}
+
+} // namespace model
@@ -0,0 +1,56 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QByteArray>
+#include <vector>
+
+
+namespace model {
+
+/// An SDL gamepad layout database (gamecontrollerdb.txt), indexed by GUID
+///
+/// Only the lines of the given platform are kept, the same way SDL would
+/// filter them. SDL reads the GUIDs in any letter case, so they are stored and
+/// looked up in lower case. Lines that start with a special name instead of
+/// a GUID (eg. `xinput`) are kept separately, as these can't be looked up by
+/// the GUID of a device.
+class GamepadLayoutDb {
+public:
+    explicit GamepadLayoutDb(QByteArray contents, const QByteArray& platform);
+
+    /// The mapping line of the GUID, or a null array if there's none;
+    /// if the GUID appears more than once, the last line wins, like in SDL
+    QByteArray find(const QByteArray& guid) const;
+    /// The lines that don't start with a GUID
+    std::vector<QByteArray> specialMappings() const;
+
+private:
+    struct Entry {
+        int offset;
+        int length;
+    };
+
+    QByteArray m_contents;
+    std::vector<Entry> m_index;
+    std::vector<Entry> m_special;
+
+    QByteArray line_of(const Entry&) const;
+};
+
+} // namespace model
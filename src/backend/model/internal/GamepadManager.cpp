@@ -30,8 +30,9 @@
 namespace {
 void call_gamepad_reconfig_scripts()
 {
-    ScriptRunner::run(ScriptEvent::CONFIG_CHANGED);
-    ScriptRunner::run(ScriptEvent::CONTROLS_CHANGED);
+    // in the background; the events are run in order
+    ScriptRunner::runAsync(ScriptEvent::CONFIG_CHANGED);
+    ScriptRunner::runAsync(ScriptEvent::CONTROLS_CHANGED);
 }
 
 QQmlObjectListModel<model::Gamepad>::const_iterator
@@ -21,18 +21,45 @@
 #include "Paths.h"
 #include "utils/StdStringHelpers.h"
 
-#include <QDataStream>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QStringBuilder>
 #include <QTextStream>
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstring>
 
 
 namespace {
 constexpr size_t GUID_LEN = 33; // 16x2 + null
+constexpr int GUID_HEX_LEN = GUID_LEN - 1;
 constexpr auto USERCFG_FILE = "/sdl_controllers.txt";
 
+// the polling intervals of the input thread: short while there's input,
+// to keep the latency low, and longer when idle, to let the CPU sleep
+constexpr size_t INPUT_QUEUE_SIZE = 1024;
+constexpr auto ACTIVE_POLL_INTERVAL = std::chrono::milliseconds(1);
+constexpr auto IDLE_POLL_INTERVAL = std::chrono::milliseconds(50);
+constexpr auto IDLE_AFTER = std::chrono::seconds(3);
+constexpr qint64 LATENCY_REPORT_INTERVAL = 200;
+
+qint64 monotonic_ns()
+{
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+// The time SDL has queued the event, on the monotonic clock. SDL only has
+// millisecond ticks, so this is accurate to about a millisecond.
+qint64 event_time_ns(const SDL_Event& event)
+{
+    const qint64 now_ns = monotonic_ns();
+    const Uint32 age_ms = SDL_GetTicks() - event.common.timestamp;
+    return now_ns - static_cast<qint64>(age_ms) * 1000000;
+}
+
 constexpr uint16_t version(uint16_t major, uint16_t minor, uint16_t micro)
 {
     return major * 1000u + minor * 100u + micro;
@@ -72,7 +99,7 @@ QLatin1String gamepaddb_file_suffix(uint16_t linked_ver)
     return QLatin1String("204");
 }
 
-bool load_internal_gamepaddb(uint16_t linked_ver)
+QByteArray read_internal_gamepaddb(uint16_t linked_ver)
 {
     const QString path = QLatin1String(":/sdl2/gamecontrollerdb_")
         % gamepaddb_file_suffix(linked_ver)
@@ -81,20 +108,15 @@ bool load_internal_gamepaddb(uint16_t linked_ver)
     dbfile.open(QFile::ReadOnly);
     Q_ASSERT(dbfile.isOpen()); // it's embedded
 
-    const auto size = static_cast<int>(dbfile.size());
-    QByteArray contents(size, 0);
-    QDataStream stream(&dbfile);
-    stream.readRawData(contents.data(), size);
-
-    SDL_RWops* const rw = SDL_RWFromConstMem(contents.constData(), contents.size());
-    if (!rw)
-        return false;
-
-    const int entry_cnt = SDL_GameControllerAddMappingsFromRW(rw, 1);
-    if (entry_cnt < 0)
-        return false;
+    return dbfile.readAll();
+}
 
-    return true;
+std::string device_guid_str(int device_idx)
+{
+    std::array<char, GUID_LEN> guid_raw_str;
+    const SDL_JoystickGUID guid = SDL_JoystickGetDeviceGUID(device_idx);
+    SDL_JoystickGetGUIDString(guid, guid_raw_str.data(), guid_raw_str.size());
+    return utils::trimmed(guid_raw_str.data());
 }
 
 void try_register_default_mapping(int device_idx)
@@ -269,6 +291,7 @@ bool GamepadManagerSDL2::RecordingState::is_active() const
 void GamepadManagerSDL2::RecordingState::reset()
 {
     device = -1;
+    id = 0;
     target_button = GamepadButton::INVALID;
     target_axis = GamepadAxis::INVALID;
     value.clear();
@@ -277,34 +300,181 @@ void GamepadManagerSDL2::RecordingState::reset()
 GamepadManagerSDL2::GamepadManagerSDL2(QObject* parent)
     : GamepadManagerBackend(parent)
     , m_sdl_version(linked_sdl_version())
+    , m_queue(INPUT_QUEUE_SIZE)
+    , m_drain_pending(false)
+    , m_stop_input(false)
+    , m_measure_latency(false)
+    , m_gui_recording_device(-1)
+    , m_gui_recording_id(0)
+    , m_autoconfig(true)
+{}
+
+void GamepadManagerSDL2::start(const backend::CliArgs& args)
 {
-    connect(&m_poll_timer, &QTimer::timeout, this, &GamepadManagerSDL2::poll);
+    QElapsedTimer init_timer;
+    init_timer.start();
+
+    m_measure_latency = args.measure_input_latency;
+    m_autoconfig = args.enable_gamepad_autoconfig;
+
+    // SDL is initialized and used only on the thread that reads the events
+    std::promise<bool> init_promise;
+    std::future<bool> init_result = init_promise.get_future();
+    m_input_thread = std::thread(&GamepadManagerSDL2::run_input_thread, this,
+                                 std::move(init_promise), paths::configDirs());
+
+    if (!init_result.get()) {
+        m_input_thread.join();
+        return;
+    }
+
+    Log::info(LOGMSG("SDL2: gamepad support initialized in %1 ms").arg(init_timer.elapsed()));
+
+    // the events that arrived in the meantime are waiting in the queue
+    schedule_drain();
 }
 
-void GamepadManagerSDL2::start(const backend::CliArgs& args)
+GamepadManagerSDL2::~GamepadManagerSDL2()
+{
+    if (m_input_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_request_guard);
+            m_stop_input.store(true);
+        }
+        m_input_wakeup.notify_one();
+        m_input_thread.join();
+    }
+}
+
+void GamepadManagerSDL2::run_input_thread(std::promise<bool> init_promise, QStringList config_dirs)
 {
     if (SDL_Init(SDL_INIT_GAMECONTROLLER) != 0) {
+        // the SDL error message is thread local, so it's printed here
         Log::info(LOGMSG("Failed to initialize SDL2. Gamepad support may not work."));
         print_sdl_error();
+        init_promise.set_value(false);
         return;
     }
 
-    if (args.enable_gamepad_autoconfig) {
-        if (Q_UNLIKELY(!load_internal_gamepaddb(m_sdl_version)))
-            print_sdl_error();
+    // the known layouts are only registered when a matching device connects
+    for (const QString& dir : qAsConst(config_dirs))
+        load_user_gamepaddb(dir);
+
+    init_promise.set_value(true);
+
+    auto last_input_time = std::chrono::steady_clock::now();
+
+    while (!m_stop_input.load()) {
+        apply_recording_request();
+
+        SDL_Event event;
+        bool had_input = false;
+        while (SDL_PollEvent(&event)) {
+            handle_event(event, event_time_ns(event));
+            had_input = true;
+        }
+
+        // NOTE: without the video subsystem, SDL can't block until a joystick event
+        // arrives, so the thread has to wake up regularly even when there's no input
+        const auto now = std::chrono::steady_clock::now();
+        if (had_input)
+            last_input_time = now;
+        const auto interval = now - last_input_time < IDLE_AFTER
+            ? ACTIVE_POLL_INTERVAL
+            : IDLE_POLL_INTERVAL;
+
+        // the main thread wakes it up early only to stop, or to change the recording
+        std::unique_lock<std::mutex> lock(m_request_guard);
+        m_input_wakeup.wait_for(lock, interval,
+            [this]{ return m_stop_input.load() || m_recording_request.pending; });
     }
 
-    for (const QString& dir : paths::configDirs())
-        load_user_gamepaddb(dir);
+    // the devices are closed on the thread that opened them
+    m_idx_to_device.clear();
+    m_iid_to_idx.clear();
+    SDL_Quit();
+}
 
-    m_poll_timer.start(16);
+void GamepadManagerSDL2::push_event(OutputEvent& item)
+{
+    // if the main thread is so busy that the queue is full, wait for it
+    while (!m_queue.try_push(item)) {
+        schedule_drain();
+        SDL_Delay(1);
+        if (m_stop_input.load())
+            return;
+    }
+    schedule_drain();
 }
 
-GamepadManagerSDL2::~GamepadManagerSDL2()
+void GamepadManagerSDL2::schedule_drain()
 {
-    m_poll_timer.stop();
-    m_idx_to_device.clear();
-    SDL_Quit();
+    if (!m_drain_pending.exchange(true))
+        QMetaObject::invokeMethod(this, [this]{ drain_events(); }, Qt::QueuedConnection);
+}
+
+void GamepadManagerSDL2::drain_events()
+{
+    // reset first, so events pushed during the drain schedule a new one
+    m_drain_pending.store(false);
+
+    OutputEvent item;
+    while (m_queue.try_pop(item)) {
+        dispatch_event(item);
+
+        if (m_measure_latency)
+            record_latency(item.received_ns);
+    }
+}
+
+void GamepadManagerSDL2::dispatch_event(const OutputEvent& item)
+{
+    switch (item.type) {
+        case OutputEvent::Type::CONNECTED:
+            emit connected(item.device, item.name);
+            break;
+        case OutputEvent::Type::DISCONNECTED:
+            emit disconnected(item.device);
+            break;
+        case OutputEvent::Type::BUTTON:
+            emit buttonChanged(item.device, item.button, item.value != 0.0);
+            break;
+        case OutputEvent::Type::AXIS:
+            emit axisChanged(item.device, item.axis, item.value);
+            break;
+        case OutputEvent::Type::BUTTON_CONFIGURED:
+        case OutputEvent::Type::AXIS_CONFIGURED:
+        case OutputEvent::Type::RECORDING_CANCELED:
+            // the recording might have been restarted or canceled here in the meantime
+            if (item.recording_id != m_gui_recording_id || m_gui_recording_device < 0)
+                break;
+
+            m_gui_recording_device = -1;
+            if (item.type == OutputEvent::Type::BUTTON_CONFIGURED)
+                emit buttonConfigured(item.device, item.button);
+            else if (item.type == OutputEvent::Type::AXIS_CONFIGURED)
+                emit axisConfigured(item.device, item.axis);
+            else
+                emit configurationCanceled(item.device);
+            break;
+    }
+}
+
+void GamepadManagerSDL2::record_latency(qint64 received_ns)
+{
+    const qint64 latency_ns = monotonic_ns() - received_ns;
+    m_latency.count++;
+    m_latency.sum_ns += latency_ns;
+    m_latency.max_ns = std::max(m_latency.max_ns, latency_ns);
+
+    if (m_latency.count < LATENCY_REPORT_INTERVAL)
+        return;
+
+    Log::info(LOGMSG("SDL2: input latency over %1 events: average %2 us, max %3 us")
+        .arg(QString::number(m_latency.count),
+             QString::number(m_latency.sum_ns / m_latency.count / 1000),
+             QString::number(m_latency.max_ns / 1000)));
+    m_latency = LatencyStats();
 }
 
 void GamepadManagerSDL2::load_user_gamepaddb(const QString& dir)
@@ -363,80 +533,110 @@ void GamepadManagerSDL2::load_user_gamepaddb(const QString& dir)
 
 void GamepadManagerSDL2::start_recording(int device_idx, GamepadButton button)
 {
-    m_recording.reset();
-    m_recording.device = device_idx;
-    m_recording.target_button = button;
+    m_gui_recording_device = device_idx;
+    m_gui_recording_id++;
+
+    RecordingState request;
+    request.device = device_idx;
+    request.id = m_gui_recording_id;
+    request.target_button = button;
+    request_recording(std::move(request));
 }
 
 void GamepadManagerSDL2::start_recording(int device_idx, GamepadAxis axis)
 {
-    m_recording.reset();
-    m_recording.device = device_idx;
-    m_recording.target_axis = axis;
+    m_gui_recording_device = device_idx;
+    m_gui_recording_id++;
+
+    RecordingState request;
+    request.device = device_idx;
+    request.id = m_gui_recording_id;
+    request.target_axis = axis;
+    request_recording(std::move(request));
 }
 
 void GamepadManagerSDL2::cancel_recording()
 {
-    if (m_recording.is_active())
-        emit configurationCanceled(m_recording.device);
+    if (m_gui_recording_device >= 0)
+        emit configurationCanceled(m_gui_recording_device);
 
-    m_recording.reset();
+    m_gui_recording_device = -1;
+    request_recording(RecordingState());
 }
 
-void GamepadManagerSDL2::poll()
+void GamepadManagerSDL2::request_recording(RecordingState state)
 {
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        switch (event.type) {
-            case SDL_CONTROLLERDEVICEADDED:
-                // ignored in favor of SDL_JOYDEVICEADDED
-                break;
-            case SDL_CONTROLLERDEVICEREMOVED:
-                remove_pad_by_iid(event.cdevice.which);
-                break;
-            case SDL_CONTROLLERDEVICEREMAPPED:
-                // ignored, could be logged
-                break;
-            case SDL_JOYDEVICEADDED:
-                add_controller_by_idx(event.jdevice.which);
-                break;
-            case SDL_JOYDEVICEREMOVED:
-                // ignored in favor of SDL_CONTROLLERDEVICEREMOVED
-                break;
-            case SDL_CONTROLLERBUTTONUP:
-            case SDL_CONTROLLERBUTTONDOWN:
-                // also ignore input from other (non-recording) gamepads
-                if (!m_recording.is_active()) {
-                    const bool pressed = event.cbutton.state == SDL_PRESSED;
-                    fwd_button_event(event.cbutton.which, event.cbutton.button, pressed);
-                }
-                break;
-            case SDL_CONTROLLERAXISMOTION:
-                if (!m_recording.is_active())
-                    fwd_axis_event(event.caxis.which, event.caxis.axis, event.caxis.value);
-                break;
-            case SDL_JOYBUTTONUP:
-                // ignored
-                break;
-            case SDL_JOYBUTTONDOWN:
-                record_joy_button_maybe(event.jbutton.which, event.jbutton.button);
-                break;
-            case SDL_JOYHATMOTION:
-                record_joy_hat_maybe(event.jhat.which, event.jhat.hat, event.jhat.value);
-                break;
-            case SDL_JOYAXISMOTION:
-                record_joy_axis_maybe(event.jaxis.which, event.jaxis.axis, event.jaxis.value);
-                break;
-            default:
-                break;
-        }
+    {
+        std::lock_guard<std::mutex> lock(m_request_guard);
+        m_recording_request.state = std::move(state);
+        m_recording_request.pending = true;
+    }
+    m_input_wakeup.notify_one();
+}
+
+void GamepadManagerSDL2::apply_recording_request()
+{
+    std::lock_guard<std::mutex> lock(m_request_guard);
+    if (!m_recording_request.pending)
+        return;
+
+    m_recording = std::move(m_recording_request.state);
+    m_recording_request.pending = false;
+}
+
+void GamepadManagerSDL2::handle_event(const SDL_Event& event, qint64 received_ns)
+{
+    switch (event.type) {
+        case SDL_CONTROLLERDEVICEADDED:
+            // ignored in favor of SDL_JOYDEVICEADDED
+            break;
+        case SDL_CONTROLLERDEVICEREMOVED:
+            remove_pad_by_iid(event.cdevice.which, received_ns);
+            break;
+        case SDL_CONTROLLERDEVICEREMAPPED:
+            // ignored, could be logged
+            break;
+        case SDL_JOYDEVICEADDED:
+            add_controller_by_idx(event.jdevice.which, received_ns);
+            break;
+        case SDL_JOYDEVICEREMOVED:
+            // ignored in favor of SDL_CONTROLLERDEVICEREMOVED
+            break;
+        case SDL_CONTROLLERBUTTONUP:
+        case SDL_CONTROLLERBUTTONDOWN:
+            // also ignore input from other (non-recording) gamepads
+            if (!m_recording.is_active()) {
+                const bool pressed = event.cbutton.state == SDL_PRESSED;
+                fwd_button_event(event.cbutton.which, event.cbutton.button, pressed, received_ns);
+            }
+            break;
+        case SDL_CONTROLLERAXISMOTION:
+            if (!m_recording.is_active())
+                fwd_axis_event(event.caxis.which, event.caxis.axis, event.caxis.value, received_ns);
+            break;
+        case SDL_JOYBUTTONUP:
+            // ignored
+            break;
+        case SDL_JOYBUTTONDOWN:
+            record_joy_button_maybe(event.jbutton.which, event.jbutton.button, received_ns);
+            break;
+        case SDL_JOYHATMOTION:
+            record_joy_hat_maybe(event.jhat.which, event.jhat.hat, event.jhat.value, received_ns);
+            break;
+        case SDL_JOYAXISMOTION:
+            record_joy_axis_maybe(event.jaxis.which, event.jaxis.axis, event.jaxis.value, received_ns);
+            break;
+        default:
+            break;
     }
 }
 
-void GamepadManagerSDL2::add_controller_by_idx(int device_idx)
+void GamepadManagerSDL2::add_controller_by_idx(int device_idx, qint64 received_ns)
 {
     Q_ASSERT(m_idx_to_device.count(device_idx) == 0);
 
+    if (m_autoconfig)
+        register_known_mapping(device_idx);
     if (!SDL_IsGameController(device_idx))
         try_register_default_mapping(device_idx);
 
@@ -451,18 +651,63 @@ void GamepadManagerSDL2::add_controller_by_idx(int device_idx)
     if (!mapping)
         Log::info(LOGMSG("SDL2: layout for gamepad %1 set to `%2`").arg(pretty_idx(device_idx), mapping.get()));
 
-    QString name = QLatin1String(SDL_GameControllerName(pad)).trimmed();
-
     SDL_Joystick* const joystick = SDL_GameControllerGetJoystick(pad);
     const SDL_JoystickID iid = SDL_JoystickInstanceID(joystick);
 
     m_idx_to_device.emplace(device_idx, device_ptr(pad, SDL_GameControllerClose));
     m_iid_to_idx.emplace(iid, device_idx);
 
-    emit connected(device_idx, name);
+    OutputEvent item;
+    item.type = OutputEvent::Type::CONNECTED;
+    item.device = device_idx;
+    item.name = QLatin1String(SDL_GameControllerName(pad)).trimmed();
+    item.received_ns = received_ns;
+    push_event(item);
 }
 
-void GamepadManagerSDL2::remove_pad_by_iid(SDL_JoystickID instance_id)
+void GamepadManagerSDL2::load_gamepaddb()
+{
+    Q_ASSERT(!m_gamepaddb);
+    m_gamepaddb.reset(new GamepadLayoutDb(read_internal_gamepaddb(m_sdl_version), SDL_GetPlatform()));
+
+    // these can't be matched to a device by GUID, SDL recognizes them itself (eg. `xinput`)
+    for (const QByteArray& mapping : m_gamepaddb->specialMappings()) {
+        if (SDL_GameControllerAddMapping(mapping.constData()) < 0) {
+            Log::error(LOGMSG("SDL2: failed to register the built-in layout `%1`")
+                .arg(QString::fromLatin1(mapping.left(mapping.indexOf(',')))));
+            print_sdl_error();
+        }
+    }
+}
+
+void GamepadManagerSDL2::register_known_mapping(int device_idx)
+{
+    const std::string guid_str = device_guid_str(device_idx);
+    if (guid_str.size() != static_cast<size_t>(GUID_HEX_LEN))
+        return;
+
+    // the user's own layout takes precedence
+    const bool has_custom = std::any_of(m_custom_mappings.cbegin(), m_custom_mappings.cend(),
+        [&guid_str](const std::string& mapping){
+            return qstrnicmp(mapping.data(), guid_str.data(), GUID_HEX_LEN) == 0;
+        });
+    if (has_custom)
+        return;
+
+    if (!m_gamepaddb)
+        load_gamepaddb();
+
+    const QByteArray mapping = m_gamepaddb->find(QByteArray::fromStdString(guid_str));
+    if (mapping.isNull())
+        return;
+
+    if (SDL_GameControllerAddMapping(mapping.constData()) < 0) {
+        Log::error(LOGMSG("SDL2: failed to set the known layout for gamepad %1").arg(pretty_idx(device_idx)));
+        print_sdl_error();
+    }
+}
+
+void GamepadManagerSDL2::remove_pad_by_iid(SDL_JoystickID instance_id, qint64 received_ns)
 {
     Q_ASSERT(m_iid_to_idx.count(instance_id) == 1);
     Q_ASSERT(m_idx_to_device.count(m_iid_to_idx.at(instance_id)) == 1);
@@ -471,33 +716,57 @@ void GamepadManagerSDL2::remove_pad_by_iid(SDL_JoystickID instance_id)
     m_idx_to_device.erase(device_idx);
     m_iid_to_idx.erase(instance_id);
 
-    if (m_recording.device == device_idx)
-        cancel_recording();
+    if (m_recording.device == device_idx) {
+        OutputEvent item;
+        item.type = OutputEvent::Type::RECORDING_CANCELED;
+        item.device = device_idx;
+        item.recording_id = m_recording.id;
+        item.received_ns = received_ns;
+        push_event(item);
 
-    emit disconnected(device_idx);
+        m_recording.reset();
+    }
+
+    OutputEvent item;
+    item.type = OutputEvent::Type::DISCONNECTED;
+    item.device = device_idx;
+    item.received_ns = received_ns;
+    push_event(item);
 }
 
-void GamepadManagerSDL2::fwd_button_event(SDL_JoystickID instance_id, Uint8 button, bool pressed)
+void GamepadManagerSDL2::fwd_button_event(SDL_JoystickID instance_id, Uint8 button, bool pressed, qint64 received_ns)
 {
-    const int device_idx = m_iid_to_idx.at(instance_id);
-    emit buttonChanged(device_idx, translate_button(button), pressed);
+    OutputEvent item;
+    item.type = OutputEvent::Type::BUTTON;
+    item.device = m_iid_to_idx.at(instance_id);
+    item.button = translate_button(button);
+    item.value = pressed ? 1.0 : 0.0;
+    item.received_ns = received_ns;
+    push_event(item);
 }
 
-void GamepadManagerSDL2::fwd_axis_event(SDL_JoystickID instance_id, Uint8 axis, Sint16 value)
+void GamepadManagerSDL2::fwd_axis_event(SDL_JoystickID instance_id, Uint8 axis, Sint16 value, qint64 received_ns)
 {
-    const int device_idx = m_iid_to_idx.at(instance_id);
+    OutputEvent item;
+    item.device = m_iid_to_idx.at(instance_id);
+    item.received_ns = received_ns;
 
     const GamepadButton button = detect_trigger_axis(axis);
     if (button != GamepadButton::INVALID) {
-        emit buttonChanged(device_idx, button, value != 0);
+        item.type = OutputEvent::Type::BUTTON;
+        item.button = button;
+        item.value = value != 0 ? 1.0 : 0.0;
+        push_event(item);
         return;
     }
 
-    const double dblval = value / static_cast<double>(std::numeric_limits<Sint16>::max());
-    emit axisChanged(device_idx, translate_axis(axis), dblval);
+    item.type = OutputEvent::Type::AXIS;
+    item.axis = translate_axis(axis);
+    item.value = value / static_cast<double>(std::numeric_limits<Sint16>::max());
+    push_event(item);
 }
 
-void GamepadManagerSDL2::record_joy_button_maybe(SDL_JoystickID instance_id, Uint8 button)
+void GamepadManagerSDL2::record_joy_button_maybe(SDL_JoystickID instance_id, Uint8 button, qint64 received_ns)
 {
     if (!m_recording.is_active())
         return;
@@ -507,10 +776,10 @@ void GamepadManagerSDL2::record_joy_button_maybe(SDL_JoystickID instance_id, Uin
         return;
 
     m_recording.value = generate_button_str(button);
-    finish_recording();
+    finish_recording(received_ns);
 }
 
-void GamepadManagerSDL2::record_joy_axis_maybe(SDL_JoystickID instance_id, Uint8 axis, Sint16 axis_value)
+void GamepadManagerSDL2::record_joy_axis_maybe(SDL_JoystickID instance_id, Uint8 axis, Sint16 axis_value, qint64 received_ns)
 {
     if (!m_recording.is_active())
         return;
@@ -527,10 +796,10 @@ void GamepadManagerSDL2::record_joy_axis_maybe(SDL_JoystickID instance_id, Uint8
         return;
 
     m_recording.value = generate_axis_str(axis);
-    finish_recording();
+    finish_recording(received_ns);
 }
 
-void GamepadManagerSDL2::record_joy_hat_maybe(SDL_JoystickID instance_id, Uint8 hat, Uint8 hat_value)
+void GamepadManagerSDL2::record_joy_hat_maybe(SDL_JoystickID instance_id, Uint8 hat, Uint8 hat_value, qint64 received_ns)
 {
     if (!m_recording.is_active())
         return;
@@ -543,7 +812,7 @@ void GamepadManagerSDL2::record_joy_hat_maybe(SDL_JoystickID instance_id, Uint8
         return;
 
     m_recording.value = generate_hat_str(hat, hat_value);
-    finish_recording();
+    finish_recording(received_ns);
 }
 
 std::string GamepadManagerSDL2::generate_mapping_for_field(const char* const field, const char* const recording_field,
@@ -625,7 +894,7 @@ void GamepadManagerSDL2::update_mapping_store(std::string new_mapping)
         m_custom_mappings.emplace_back(std::move(new_mapping));
 }
 
-void GamepadManagerSDL2::finish_recording()
+void GamepadManagerSDL2::finish_recording(qint64 received_ns)
 {
     Q_ASSERT(m_recording.is_active());
     std::string new_mapping = generate_mapping(m_recording.device).c_str();
@@ -638,10 +907,19 @@ void GamepadManagerSDL2::finish_recording()
     update_mapping_store(std::move(new_mapping));
     write_mappings(m_custom_mappings);
 
-    if (m_recording.target_button != GamepadButton::INVALID)
-        emit buttonConfigured(m_recording.device, m_recording.target_button);
-    else
-        emit axisConfigured(m_recording.device, m_recording.target_axis);
+    OutputEvent item;
+    item.device = m_recording.device;
+    item.recording_id = m_recording.id;
+    item.received_ns = received_ns;
+    if (m_recording.target_button != GamepadButton::INVALID) {
+        item.type = OutputEvent::Type::BUTTON_CONFIGURED;
+        item.button = m_recording.target_button;
+    }
+    else {
+        item.type = OutputEvent::Type::AXIS_CONFIGURED;
+        item.axis = m_recording.target_axis;
+    }
+    push_event(item);
 
     m_recording.reset();
 }
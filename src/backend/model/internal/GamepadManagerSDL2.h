@@ -18,15 +18,35 @@
 #pragma once
 
 #include "utils/HashMap.h"
+#include "utils/MpscRingBuffer.h"
+#include "GamepadLayoutDb.h"
 #include "GamepadManagerBackend.h"
 
 #include <SDL.h>
-#include <QTimer>
+#include <QStringList>
+#include <atomic>
+#include <condition_variable>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 
 namespace model {
 
+/// Gamepad support using SDL2
+///
+/// SDL is only used on a dedicated input thread, including opening and
+/// closing the devices and registering their layouts, as SDL before 2.0.7
+/// does not lock its joystick functions. The thread turns the SDL events into
+/// finished changes (connections, button and axis values, recording results),
+/// and passes them to the main thread through a lock-free queue, with the
+/// time SDL has queued the original event. The recording requests go the other way, guarded by a mutex.
+///
+/// NOTE: Without its video subsystem, SDL can't block until a gamepad event
+/// arrives, so the thread polls: every millisecond while there's input, and
+/// every 50 ms after a few seconds of inactivity. This reduces the CPU usage
+/// when idle, but does not eliminate it.
 class GamepadManagerSDL2 : public GamepadManagerBackend {
 public:
     explicit GamepadManagerSDL2(QObject* parent);
@@ -38,43 +58,107 @@ public:
     void start_recording(int, GamepadAxis) final;
     void cancel_recording() final;
 
-private slots:
-    void poll();
-
 private:
+    // a change to report on the main thread
+    struct OutputEvent {
+        enum class Type : unsigned char {
+            CONNECTED,
+            DISCONNECTED,
+            BUTTON,
+            AXIS,
+            BUTTON_CONFIGURED,
+            AXIS_CONFIGURED,
+            RECORDING_CANCELED,
+        };
+        Type type = Type::BUTTON;
+        int device = -1;
+        GamepadButton button = GamepadButton::INVALID;
+        GamepadAxis axis = GamepadAxis::INVALID;
+        double value = 0.0;
+        unsigned recording_id = 0;
+        QString name;
+        qint64 received_ns = 0;
+    };
+
+    struct LatencyStats {
+        qint64 count = 0;
+        qint64 sum_ns = 0;
+        qint64 max_ns = 0;
+    };
+
     const uint16_t m_sdl_version;
-    QTimer m_poll_timer;
 
-    using device_deleter = void(*)(SDL_GameController*);
-    using device_ptr = std::unique_ptr<SDL_GameController, device_deleter>;
-    HashMap<int, const device_ptr> m_idx_to_device;
-    HashMap<SDL_JoystickID, const int> m_iid_to_idx;
+    utils::MpscRingBuffer<OutputEvent> m_queue;
+    std::atomic<bool> m_drain_pending;
+    std::atomic<bool> m_stop_input;
+    std::thread m_input_thread;
+
+    // main thread
+    bool m_measure_latency;
+    LatencyStats m_latency;
+    int m_gui_recording_device;
+    unsigned m_gui_recording_id;
 
-    void add_controller_by_idx(int);
-    void remove_pad_by_iid(SDL_JoystickID);
-    void fwd_button_event(SDL_JoystickID, Uint8, bool);
-    void fwd_axis_event(SDL_JoystickID, Uint8, Sint16);
+    void schedule_drain();
+    void drain_events();
+    void dispatch_event(const OutputEvent&);
+    void record_latency(qint64 received_ns);
 
     struct RecordingState {
         int device = -1;
+        unsigned id = 0;
         GamepadButton target_button = GamepadButton::INVALID;
         GamepadAxis target_axis = GamepadAxis::INVALID;
         std::string value;
 
         bool is_active() const;
         void reset();
-    } m_recording;
+    };
+
+    // passing the recording requests to the input thread
+    std::mutex m_request_guard;
+    std::condition_variable m_input_wakeup;
+    struct {
+        RecordingState state;
+        bool pending = false;
+    } m_recording_request;
+
+    void request_recording(RecordingState);
 
-    void record_joy_button_maybe(SDL_JoystickID, Uint8);
-    void record_joy_axis_maybe(SDL_JoystickID, Uint8, Sint16);
-    void record_joy_hat_maybe(SDL_JoystickID, Uint8, Uint8);
-    void finish_recording();
+    // input thread
+    void run_input_thread(std::promise<bool>, QStringList config_dirs);
+    void push_event(OutputEvent&);
+    void handle_event(const SDL_Event&, qint64 received_ns);
+    void apply_recording_request();
+
+    using device_deleter = void(*)(SDL_GameController*);
+    using device_ptr = std::unique_ptr<SDL_GameController, device_deleter>;
+    HashMap<int, const device_ptr> m_idx_to_device;
+    HashMap<SDL_JoystickID, const int> m_iid_to_idx;
+
+    void add_controller_by_idx(int, qint64 received_ns);
+    void remove_pad_by_iid(SDL_JoystickID, qint64 received_ns);
+    void fwd_button_event(SDL_JoystickID, Uint8, bool, qint64 received_ns);
+    void fwd_axis_event(SDL_JoystickID, Uint8, Sint16, qint64 received_ns);
+
+    RecordingState m_recording;
+
+    void record_joy_button_maybe(SDL_JoystickID, Uint8, qint64 received_ns);
+    void record_joy_axis_maybe(SDL_JoystickID, Uint8, Sint16, qint64 received_ns);
+    void record_joy_hat_maybe(SDL_JoystickID, Uint8, Uint8, qint64 received_ns);
+    void finish_recording(qint64 received_ns);
     void update_mapping_store(std::string);
 
     std::string generate_mapping_for_field(const char* const, const char* const, const SDL_GameControllerButtonBind&);
     std::string generate_mapping(int);
     std::vector<std::string> m_custom_mappings;
     void load_user_gamepaddb(const QString&);
+
+    // the embedded layout database, read when the first device connects
+    bool m_autoconfig;
+    std::unique_ptr<GamepadLayoutDb> m_gamepaddb;
+    void load_gamepaddb();
+    void register_known_mapping(int);
 };
 
 } // namespace model
@@ -1,5 +1,6 @@
 HEADERS += \
     $$PWD/Gamepad.h \
+    $$PWD/GamepadLayoutDb.h \
     $$PWD/GamepadManager.h \
     $$PWD/GamepadManagerBackend.h \
     $$PWD/Internal.h \
@@ -8,6 +9,7 @@ HEADERS += \
 
 SOURCES += \
     $$PWD/Gamepad.cpp \
+    $$PWD/GamepadLayoutDb.cpp \
     $$PWD/GamepadManager.cpp \
     $$PWD/GamepadManagerBackend.cpp \
     $$PWD/Internal.cpp \
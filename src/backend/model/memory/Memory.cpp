@@ -24,10 +24,15 @@
 #include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QSaveFile>
 #include <QStringBuilder>
+#include <QtConcurrent/QtConcurrent>
 
 
 namespace {
+// changes within this time are saved together
+constexpr int SAVE_DELAY_MS = 1000;
+
 QString default_settings_dir()
 {
     return paths::writableConfigDir() % QStringLiteral("/theme_settings/");
@@ -49,8 +54,9 @@ void save_map_maybe(const QVariantMap& map, const QString& settings_dir, const Q
         return;
     }
 
+    // the file is replaced only after the new one is fully written and synced
     const QString json_path = json_path_for(settings_dir, theme_id);
-    QFile json_file(json_path);
+    QSaveFile json_file(json_path);
     if (!json_file.open(QIODevice::WriteOnly)) {
         Log::warning(LOGMSG("could not save theme settings file `%1`: %2")
             .arg(json_path, json_file.errorString()));
@@ -58,7 +64,7 @@ void save_map_maybe(const QVariantMap& map, const QString& settings_dir, const Q
     }
 
     const auto json_doc = QJsonDocument::fromVariant(map);
-    if (json_file.write(json_doc.toJson(QJsonDocument::Compact)) < 0) {
+    if (json_file.write(json_doc.toJson(QJsonDocument::Compact)) < 0 || !json_file.commit()) {
         Log::warning(LOGMSG("failed to write theme settings file `%1`: %2")
             .arg(json_path, json_file.errorString()));
     }
@@ -101,11 +107,51 @@ Memory::Memory(QObject* parent)
 Memory::Memory(QString settings_dir, QObject* parent)
     : QObject(parent)
     , m_settings_dir(std::move(settings_dir))
-{}
+    , m_save_needed(false)
+{
+    m_save_timer.setSingleShot(true);
+    m_save_timer.setInterval(SAVE_DELAY_MS);
+    connect(&m_save_timer, &QTimer::timeout, this, &Memory::startSave);
+}
+
+Memory::~Memory()
+{
+    flush();
+}
+
+void Memory::scheduleSave()
+{
+    m_save_needed = true;
+
+    // not restarted on every change, so frequent changes are also saved
+    if (!m_save_timer.isActive())
+        m_save_timer.start();
+}
+
+void Memory::startSave()
+{
+    if (!m_save_needed)
+        return;
+
+    // the previous save is still running, try again later
+    if (m_save_future.isRunning()) {
+        m_save_timer.start();
+        return;
+    }
+
+    m_save_needed = false;
+    m_save_future = QtConcurrent::run(save_map_maybe, m_data, m_settings_dir, m_current_theme);
+}
 
-void Memory::flush() const
+void Memory::flush()
 {
-    save_map_maybe(m_data, m_settings_dir, m_current_theme);
+    m_save_timer.stop();
+    m_save_future.waitForFinished();
+
+    if (m_save_needed) {
+        m_save_needed = false;
+        save_map_maybe(m_data, m_settings_dir, m_current_theme);
+    }
 }
 
 QVariant Memory::get(const QString& key) const
@@ -132,7 +178,7 @@ void Memory::set(const QString& key, QVariant value)
     m_data[key] = std::move(value);
     emit dataChanged();
 
-    flush();
+    scheduleSave();
 }
 
 void Memory::unset(const QString& key)
@@ -140,7 +186,7 @@ void Memory::unset(const QString& key)
     m_data.remove(key);
     emit dataChanged();
 
-    flush();
+    scheduleSave();
 }
 
 void Memory::changeTheme(const QString& theme_root_dir)
@@ -149,6 +195,10 @@ void Memory::changeTheme(const QString& theme_root_dir)
     const int dir_name_start = theme_root_dir.lastIndexOf('/', -2) + 1;
     const int dir_name_len = theme_root_dir.length() - dir_name_start - 1;
     Q_ASSERT(dir_name_len > 0);
+
+    // the changes belong to the previous theme
+    flush();
+
     m_current_theme = theme_root_dir.mid(dir_name_start, dir_name_len);
 
     m_data = load_map_maybe(m_settings_dir, m_current_theme);
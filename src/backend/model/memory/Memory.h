@@ -17,17 +17,24 @@
 
 #pragma once
 
+#include <QFuture>
 #include <QObject>
+#include <QTimer>
 #include <QVariantMap>
 
 
 namespace model {
+/// Key-value storage for themes
+///
+/// The changes are saved in the background, after a short delay; multiple
+/// changes during that time are saved together.
 class Memory : public QObject {
     Q_OBJECT
 
 public:
     explicit Memory(QObject* parent = nullptr);
     explicit Memory(QString settings_dir, QObject* parent = nullptr);
+    ~Memory() override;
 
     Q_INVOKABLE QVariant get(const QString&) const;
     Q_INVOKABLE bool has(const QString&) const;
@@ -35,6 +42,8 @@ public:
     Q_INVOKABLE void unset(const QString&);
 
     void changeTheme(const QString&);
+    /// Saves the pending changes now, and waits until they are written
+    void flush();
 
 signals:
     // NOTE: because QVariantMap cannot be changed on the QML side (QTBUG-59474),
@@ -47,6 +56,11 @@ private:
     QString m_current_theme;
     QVariantMap m_data;
 
-    void flush() const;
+    QTimer m_save_timer;
+    QFuture<void> m_save_future;
+    bool m_save_needed;
+
+    void scheduleSave();
+    void startSave();
 };
 } // namespace model
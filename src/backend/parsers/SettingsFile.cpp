@@ -52,6 +52,16 @@ bool store_bool_maybe(const StrBoolConverter& converter, const QString& str, boo
     return success;
 }
 
+bool store_uint_maybe(const QString& str, int& target)
+{
+    bool success = false;
+    const int value = str.toInt(&success);
+    if (success && value >= 0)
+        target = value;
+
+    return success && value >= 0;
+}
+
 } // namespace
 
 
@@ -66,6 +76,11 @@ ConfigEntryMaps::ConfigEntryMaps()
     , str_to_general_opt {
         { QStringLiteral("fullscreen"), GeneralOption::FULLSCREEN },
         { QStringLiteral("input-mouse-support"), GeneralOption::MOUSE_SUPPORT },
+        { QStringLiteral("lazy-asset-loading"), GeneralOption::LAZY_ASSETS },
+        { QStringLiteral("keep-frontend-loaded"), GeneralOption::KEEP_FRONTEND_LOADED },
+        { QStringLiteral("parallel-scripts"), GeneralOption::PARALLEL_SCRIPTS },
+        { QStringLiteral("script-timeout"), GeneralOption::SCRIPT_TIMEOUT },
+        { QStringLiteral("rom-prewarm-mb"), GeneralOption::ROM_PREWARM },
         { QStringLiteral("locale"), GeneralOption::LOCALE },
         { QStringLiteral("theme"), GeneralOption::THEME },
     }
@@ -120,6 +135,11 @@ void LoadContext::log_needs_bool(const size_t lineno, const QString& key) const
     log_error(lineno, LOGMSG("this option (`%1`) must be a boolean (true/false) value").arg(key));
 }
 
+void LoadContext::log_needs_number(const size_t lineno, const QString& key) const
+{
+    log_error(lineno, LOGMSG("this option (`%1`) must be a non-negative integer").arg(key));
+}
+
 void LoadContext::handle_entry(const size_t lineno,
                                const QString& key,
                                const std::vector<QString>& vals) const
@@ -168,6 +188,26 @@ void LoadContext::handle_general_attrib(const size_t lineno, const QString& key,
             if (!store_bool_maybe(strconv, val, AppSettings::general.mouse_support))
                 log_needs_bool(lineno, key);
             break;
+        case ConfigEntryGeneralOption::LAZY_ASSETS:
+            if (!store_bool_maybe(strconv, val, AppSettings::general.lazy_assets))
+                log_needs_bool(lineno, key);
+            break;
+        case ConfigEntryGeneralOption::KEEP_FRONTEND_LOADED:
+            if (!store_bool_maybe(strconv, val, AppSettings::general.keep_frontend_loaded))
+                log_needs_bool(lineno, key);
+            break;
+        case ConfigEntryGeneralOption::PARALLEL_SCRIPTS:
+            if (!store_bool_maybe(strconv, val, AppSettings::general.parallel_scripts))
+                log_needs_bool(lineno, key);
+            break;
+        case ConfigEntryGeneralOption::SCRIPT_TIMEOUT:
+            if (!store_uint_maybe(val, AppSettings::general.script_timeout_secs))
+                log_needs_number(lineno, key);
+            break;
+        case ConfigEntryGeneralOption::ROM_PREWARM:
+            if (!store_uint_maybe(val, AppSettings::general.rom_prewarm_mb))
+                log_needs_number(lineno, key);
+            break;
         case ConfigEntryGeneralOption::LOCALE:
             AppSettings::general.locale = val;
             break;
@@ -297,6 +337,11 @@ void SaveContext::print_general(QTextStream& stream) const
     GeneralStrMap option_values {
         { GeneralOption::FULLSCREEN, AppSettings::general.fullscreen ? STR_TRUE : STR_FALSE },
         { GeneralOption::MOUSE_SUPPORT, AppSettings::general.mouse_support ? STR_TRUE : STR_FALSE },
+        { GeneralOption::LAZY_ASSETS, AppSettings::general.lazy_assets ? STR_TRUE : STR_FALSE },
+        { GeneralOption::KEEP_FRONTEND_LOADED, AppSettings::general.keep_frontend_loaded ? STR_TRUE : STR_FALSE },
+        { GeneralOption::PARALLEL_SCRIPTS, AppSettings::general.parallel_scripts ? STR_TRUE : STR_FALSE },
+        { GeneralOption::SCRIPT_TIMEOUT, QString::number(AppSettings::general.script_timeout_secs) },
+        { GeneralOption::ROM_PREWARM, QString::number(AppSettings::general.rom_prewarm_mb) },
         { GeneralOption::LOCALE, AppSettings::general.locale },
         { GeneralOption::THEME, theme_path },
     };
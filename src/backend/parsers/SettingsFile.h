@@ -38,6 +38,11 @@ enum class ConfigEntryCategory : unsigned char {
 enum class ConfigEntryGeneralOption : unsigned char {
     FULLSCREEN,
     MOUSE_SUPPORT,
+    LAZY_ASSETS,
+    KEEP_FRONTEND_LOADED,
+    PARALLEL_SCRIPTS,
+    SCRIPT_TIMEOUT,
+    ROM_PREWARM,
     LOCALE,
     THEME,
 };
@@ -73,6 +78,7 @@ private:
     void log_error(const size_t lineno, const QString& msg) const;
     void log_unknown_key(const size_t lineno, const QString& key) const;
     void log_needs_bool(const size_t lineno, const QString& key) const;
+    void log_needs_number(const size_t lineno, const QString& key) const;
 
 private:
     void handle_entry(const size_t lineno, const QString& key, const std::vector<QString>& vals) const;
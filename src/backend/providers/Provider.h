@@ -50,7 +50,7 @@ public:
     virtual Provider& run(SearchContext&) { return *this; }
 
     // events
-    virtual void onGameFavoriteChanged(const QVector<model::Game*>&) {}
+    virtual void onGameFavoriteChanged(model::Game* const) {}
     virtual void onGameLaunched(model::GameFile* const) {}
     virtual void onGameFinished(model::GameFile* const) {}
 
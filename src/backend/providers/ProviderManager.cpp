@@ -45,7 +45,7 @@ ProviderManager::ProviderManager(QObject* parent)
     , m_progress_finished(0.f)
     , m_progress_provider_weight(1.f)
     , m_target_collection_list(nullptr)
-    , m_target_game_list(nullptr)
+    , m_target_game_store(nullptr)
 {
     // TODO: Improve detection of receiving signals from already finished providers
     /*for (const auto& provider : AppSettings::providers()) {
@@ -56,12 +56,12 @@ ProviderManager::ProviderManager(QObject* parent)
 
 void ProviderManager::run(
     QVector<model::Collection*>& out_collections,
-    QVector<model::Game*>& out_games)
+    std::shared_ptr<model::GameStore>& out_games)
 {
     Q_ASSERT(!m_future.isRunning());
 
     m_target_collection_list = &out_collections;
-    m_target_game_list = &out_games;
+    m_target_game_store = &out_games;
 
 
     m_future = QtConcurrent::run([this]{
@@ -114,11 +114,13 @@ void ProviderManager::run(
 
         // TODO: C++17
         QVector<model::Collection*> collections;
-        QVector<model::Game*> games;
-        std::tie(collections, games) = sctx.finalize(parent());
+        std::shared_ptr<model::GameStore> games;
+        std::tie(collections, games) = sctx.finalize_store(parent());
 
         std::swap(collections, *m_target_collection_list);
-        std::swap(games, *m_target_game_list);
+        std::swap(games, *m_target_game_store);
+        m_search_index = sctx.search_index();
+        m_facet_index = sctx.facet_index();
 
         Log::info(LOGMSG("Game list post-processing took %1ms").arg(finalize_timer.elapsed()));
         emit finished();
@@ -133,13 +135,13 @@ void ProviderManager::onProviderProgressChanged(float /*percent*/)
 }
 
 
-void ProviderManager::onGameFavoriteChanged(const QVector<model::Game*>& all_games) const
+void ProviderManager::onGameFavoriteChanged(model::Game* const game) const
 {
     if (m_future.isRunning())
         return;
 
     for (const auto& provider : AppSettings::providers())
-        provider->onGameFavoriteChanged(all_games);
+        provider->onGameFavoriteChanged(game);
 }
 
 void ProviderManager::onGameLaunched(model::GameFile* const game) const
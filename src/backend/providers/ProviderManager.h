@@ -19,10 +19,14 @@
 
 #include <QObject>
 #include <QFuture>
+#include <memory>
 
 namespace model { class Collection; }
 namespace model { class Game; }
 namespace model { class GameFile; }
+namespace model { class GameStore; }
+namespace model { class FacetIndex; }
+namespace model { class SearchIndex; }
 
 
 class ProviderManager : public QObject {
@@ -31,11 +35,16 @@ class ProviderManager : public QObject {
 public:
     explicit ProviderManager(QObject* parent);
 
-    void run(QVector<model::Collection*>&, QVector<model::Game*>&);
+    /// Searches for the games in the background; the games are the rows of the
+    /// store, their Game objects are created on demand
+    void run(QVector<model::Collection*>&, std::shared_ptr<model::GameStore>&);
+    /// The search and facet indices of the last run, available after `finished`
+    const std::shared_ptr<const model::SearchIndex>& searchIndex() const { return m_search_index; }
+    const std::shared_ptr<model::FacetIndex>& facetIndex() const { return m_facet_index; }
 
     void onGameLaunched(model::GameFile* const) const;
     void onGameFinished(model::GameFile* const) const;
-    void onGameFavoriteChanged(const QVector<model::Game*>&) const;
+    void onGameFavoriteChanged(model::Game* const) const;
 
 signals:
     void progressChanged(float, QString);
@@ -50,7 +59,9 @@ private:
     float m_progress_provider_weight;
 
     QVector<model::Collection*>* m_target_collection_list;
-    QVector<model::Game*>* m_target_game_list;
+    std::shared_ptr<model::GameStore>* m_target_game_store;
+    std::shared_ptr<const model::SearchIndex> m_search_index;
+    std::shared_ptr<model::FacetIndex> m_facet_index;
 
     void finalize();
 };
@@ -20,8 +20,11 @@
 #include "AppSettings.h"
 #include "Log.h"
 #include "model/gaming/Collection.h"
+#include "model/gaming/FacetIndex.h"
 #include "model/gaming/Game.h"
 #include "model/gaming/GameFile.h"
+#include "model/gaming/GameStore.h"
+#include "model/gaming/SearchIndex.h"
 #include "utils/DiskCachedNAM.h"
 #include "utils/StdHelpers.h"
 
@@ -30,6 +33,7 @@
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QSslSocket>
+#include <tuple>
 
 
 namespace {
@@ -57,6 +61,7 @@ SearchContext::SearchContext(QObject* parent)
 SearchContext::SearchContext(QStringList game_dirs, QObject* parent)
     : QObject(parent)
     , m_root_game_dirs(std::move(game_dirs))
+    , m_game_store(std::make_shared<model::GameStore>())
     , m_netman(nullptr)
     , m_pending_downloads(0)
 {}
@@ -81,7 +86,7 @@ model::Collection* SearchContext::get_or_create_collection(const QString& name)
 
 model::Game* SearchContext::create_game_for(model::Collection& collection)
 {
-    auto* const game_ptr = new model::Game();
+    auto* const game_ptr = new model::Game(m_game_store);
     (*game_ptr)
         .setLaunchCmd(collection.commonLaunchCmd())
         .setLaunchWorkdir(collection.commonLaunchWorkdir())
@@ -93,7 +98,7 @@ model::Game* SearchContext::create_game_for(model::Collection& collection)
 
 model::Game* SearchContext::create_game()
 {
-    auto* const game_ptr = new model::Game();
+    auto* const game_ptr = new model::Game(m_game_store);
     m_parentless_games.emplace_back(game_ptr);
     return game_ptr;
 }
@@ -207,14 +212,16 @@ void SearchContext::finalize_cleanup_collections()
     }
 }
 
-void SearchContext::finalize_apply_lists()
+void SearchContext::finalize_apply_files()
 {
-    // Apply game entries
     for (auto& pair : m_game_entries) {
         Q_ASSERT(!pair.second.empty());
         pair.first->setFiles(std::move(pair.second));
     }
+}
 
+void SearchContext::finalize_apply_lists()
+{
     // Apply collections to games
     HashMap<model::Game*, std::vector<model::Collection*>> game_collections;
     for (const auto& pair : m_collection_games) {
@@ -231,32 +238,73 @@ void SearchContext::finalize_apply_lists()
     }
 }
 
-std::pair<QVector<model::Collection*>, QVector<model::Game*>> SearchContext::finalize(QObject* const qparent)
+std::shared_ptr<model::GameStore> SearchContext::finalize_compact_store(const QVector<model::Game*>& sorted_games)
+{
+    // The scan store may contain the rows of removed games; copy the rest
+    // to a new store, in the final order, so the row of a game is also its
+    // index in the list of all games
+    const auto final_store = std::make_shared<model::GameStore>();
+    final_store->reserve(static_cast<size_t>(sorted_games.size()));
+
+    for (model::Game* const game_ptr : sorted_games)
+        game_ptr->moveToStore(final_store);
+
+    return final_store;
+}
+
+void SearchContext::finalize_release_games(const QVector<model::Game*>& games, QObject* const qparent)
+{
+    // The store keeps the files and the assets of the games, and the lists
+    // refer to the store rows, so the Game objects are not needed anymore;
+    // they are created again on demand, for the games the UI actually uses
+    const auto move_to_parent = [qparent](QObject* const obj){
+        obj->setParent(nullptr);
+        obj->moveToThread(qparent->thread());
+        obj->setParent(qparent);
+    };
+
+    for (model::Game* const game_ptr : games) {
+        for (model::GameFile* const gamefile : game_ptr->filesConst())
+            move_to_parent(gamefile);
+        if (game_ptr->hasAssets())
+            move_to_parent(game_ptr->assetsPtr());
+
+        delete game_ptr;
+    }
+}
+
+std::pair<QVector<model::Collection*>, std::shared_ptr<model::GameStore>> SearchContext::finalize_store(QObject* const qparent)
 {
     // TODO: C++17
 
     finalize_cleanup_games();
     finalize_cleanup_collections();
-    finalize_apply_lists();
 
 
     QVector<model::Game*> games;
     games.reserve(m_game_entries.size());
+    for (const auto& pair : m_game_entries)
+        games.append(pair.first);
 
-    for (const auto& pair : m_game_entries) {
-        model::Game& game = *pair.first;
+    // the files are moved together with the rows, but the lists of the
+    // collections refer to the store rows, so those are created after
+    std::sort(games.begin(), games.end(), model::sort_games);
+    finalize_apply_files();
+    const std::shared_ptr<model::GameStore> store = finalize_compact_store(games);
+    finalize_apply_lists();
+
+    for (model::Game* const game_ptr : qAsConst(games)) {
+        model::Game& game = *game_ptr;
 
         game.developerList().removeDuplicates();
         game.publisherList().removeDuplicates();
         game.genreList().removeDuplicates();
         game.tagList().removeDuplicates();
-
-        game.moveToThread(qparent->thread());
-        game.setParent(qparent);
-
-        games.append(pair.first);
     }
 
+    finalize_release_games(games, qparent);
+    store->set_object_parent(qparent);
+
 
     QVector<model::Collection*> collections;
     collections.reserve(m_collections.size());
@@ -271,8 +319,29 @@ std::pair<QVector<model::Collection*>, QVector<model::Game*>> SearchContext::fin
     }
 
 
+    std::vector<model::GameRowRef> refs;
+    refs.reserve(store->size());
+    for (size_t row = 0; row < store->size(); row++)
+        refs.push_back(model::GameRowRef { store.get(), row });
+
     std::sort(collections.begin(), collections.end(), model::sort_collections);
-    std::sort(games.begin(), games.end(), model::sort_games);
+    m_search_index = std::make_shared<model::SearchIndex>(refs);
+    m_facet_index = std::make_shared<model::FacetIndex>(refs);
+
+    return std::make_pair(std::move(collections), store);
+}
+
+std::pair<QVector<model::Collection*>, QVector<model::Game*>> SearchContext::finalize(QObject* const qparent)
+{
+    // TODO: C++17
+    QVector<model::Collection*> collections;
+    std::shared_ptr<model::GameStore> store;
+    std::tie(collections, store) = finalize_store(qparent);
+
+    QVector<model::Game*> games;
+    games.reserve(static_cast<int>(store->size()));
+    for (size_t row = 0; row < store->size(); row++)
+        games.append(store->game(row));
 
     return std::make_pair(std::move(collections), std::move(games));
 }
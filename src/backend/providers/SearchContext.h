@@ -22,9 +22,13 @@
 
 #include <QObject>
 #include <QStringList>
+#include <memory>
 #include <vector>
 
 namespace model { class Game; }
+namespace model { class GameStore; }
+namespace model { class FacetIndex; }
+namespace model { class SearchIndex; }
 namespace model { class GameFile; }
 namespace model { class Collection; }
 class QNetworkAccessManager;
@@ -64,7 +68,16 @@ public:
     bool has_pending_downloads() const;
 
     const HashMap<QString, model::GameFile*>& current_filepath_to_entry_map() const { return m_filepath_to_gamefile; }
+    /// Finishes the scan; the games are the rows of the returned store, in their
+    /// final order. The Game objects used during the scan are deleted, the other
+    /// objects are moved to the thread of the parent, and parented to it.
+    std::pair<QVector<model::Collection*>, std::shared_ptr<model::GameStore>> finalize_store(QObject* const);
+    /// Like finalize_store(), but also returns the Game objects of every game,
+    /// created again in the thread of the parent
     std::pair<QVector<model::Collection*>, QVector<model::Game*>> finalize(QObject* const);
+    /// The full text index of the games, created by finalize()
+    const std::shared_ptr<const model::SearchIndex>& search_index() const { return m_search_index; }
+    const std::shared_ptr<model::FacetIndex>& facet_index() const { return m_facet_index; }
 
 signals:
     void downloadScheduled();
@@ -72,6 +85,7 @@ signals:
 
 private:
     const QStringList m_root_game_dirs;
+    const std::shared_ptr<model::GameStore> m_game_store;
     QStringList m_pegasus_game_dirs;
 
     QNetworkAccessManager* m_netman;
@@ -85,8 +99,14 @@ private:
 
     std::vector<model::Game*> m_parentless_games;
 
+    std::shared_ptr<const model::SearchIndex> m_search_index;
+    std::shared_ptr<model::FacetIndex> m_facet_index;
+
     void finalize_cleanup_games();
     void finalize_cleanup_collections();
+    void finalize_apply_files();
     void finalize_apply_lists();
+    std::shared_ptr<model::GameStore> finalize_compact_store(const QVector<model::Game*>&);
+    void finalize_release_games(const QVector<model::Game*>&, QObject* const);
 };
 } // namespace providers
@@ -172,7 +172,7 @@ void Metadata::process_gamelist_xml(const QDir& xml_dir, QXmlStreamReader& xml,
 
         const QString shell_filepath = xml_props[MetaType::PATH];
         if (shell_filepath.isEmpty()) {
-            Log::warning(m_log_tag, LOGMSG("The `<game>` node in `%1` at line %2 has no valid `<path>` entry")
+            LOG_WARNING(m_log_tag, LOGMSG("The `<game>` node in `%1` at line %2 has no valid `<path>` entry")
                 .arg(static_cast<QFile*>(xml.device())->fileName(), QString::number(linenum)));
             continue;
         }
@@ -190,7 +190,7 @@ void Metadata::process_gamelist_xml(const QDir& xml_dir, QXmlStreamReader& xml,
         apply_metadata(*entry_ptr, xml_dir, xml_props);
     }
     if (xml.error()) {
-        Log::warning(m_log_tag, xml.errorString());
+        LOG_WARNING(m_log_tag, xml.errorString());
         return;
     }
 }
@@ -202,17 +202,17 @@ void Metadata::find_metadata_for(const SystemEntry& sysentry, const providers::S
 
 
     if (sysentry.shortname == QLatin1String("steam")) {
-        Log::info(m_log_tag, LOGMSG("Ignoring the `steam` system in favor of the built-in Steam support"));
+        LOG_INFO(m_log_tag, LOGMSG("Ignoring the `steam` system in favor of the built-in Steam support"));
         return;
     }
 
     const QDir xml_dir(sysentry.path);
     const QString gamelist_path = find_gamelist_xml(m_config_dirs, xml_dir, sysentry.shortname);
     if (gamelist_path.isEmpty()) {
-        Log::warning(m_log_tag, LOGMSG("No gamelist file found for system `%1`").arg(sysentry.shortname));
+        LOG_WARNING(m_log_tag, LOGMSG("No gamelist file found for system `%1`").arg(sysentry.shortname));
         return;
     }
-    Log::info(m_log_tag, LOGMSG("Found `%1`").arg(gamelist_path));
+    LOG_INFO(m_log_tag, LOGMSG("Found `%1`").arg(gamelist_path));
 
     QFile xml_file(gamelist_path);
     if (!xml_file.open(QIODevice::ReadOnly)) {
@@ -202,7 +202,7 @@ GamelistXml::GamelistXml(QString log_tag, QDir lb_root)
 
 void GamelistXml::log_xml_warning(const QString& xml_path, const size_t linenum, const QString& msg) const
 {
-    Log::warning(m_log_tag, LOGMSG("In `%1` at line %2: %3")
+    LOG_WARNING(m_log_tag, LOGMSG("In `%1` at line %2: %3")
         .arg(QDir::toNativeSeparators(xml_path), QString::number(linenum), msg));
 }
 
@@ -425,7 +425,7 @@ std::vector<model::Game*> GamelistXml::find_games_for(
         const auto it = gameid_map.find(game_id);
         if (it == gameid_map.cend()) {
             const QString app_id = fields.at(AppField::ID);
-            Log::warning(m_log_tag, LOGMSG("In `%1` additional application entry `%2` refers to missing or invalid game `%3`, entry ignored")
+            LOG_WARNING(m_log_tag, LOGMSG("In `%1` additional application entry `%2` refers to missing or invalid game `%3`, entry ignored")
                 .arg(QDir::toNativeSeparators(xml_path), app_id, game_id));
             continue;
         }
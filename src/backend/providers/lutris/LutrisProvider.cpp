@@ -112,7 +112,8 @@ Provider& LutrisProvider::run(SearchContext& sctx)
     if (!channel.hasTable(QStringLiteral("games")))
         return *this;
 
-    QSqlQuery query;
+    QSqlQuery query = channel.query();
+    query.setForwardOnly(true);
     query.prepare(QLatin1String("SELECT id, slug, name, playtime FROM games"));
     if (!query.exec()) {
         Log::warning(display_name(), query.lastError().text());
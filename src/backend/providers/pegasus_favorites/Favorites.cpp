@@ -26,15 +26,69 @@
 
 #include <QFile>
 #include <QFileInfo>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QtConcurrent/QtConcurrent>
+#include <algorithm>
 
 
 namespace {
+// the journal is compacted when it has this many times more records than favorites
+constexpr int COMPACTION_RATIO = 2;
+// but small journals are left alone
+constexpr int COMPACTION_MIN_RECORDS = 256;
+
+const QChar RECORD_ADD('+');
+const QChar RECORD_REMOVE('-');
+
 QString default_db_path()
 {
     return paths::writableConfigDir() + QStringLiteral("/favorites.txt");
 }
+
+QString file_header()
+{
+    return QStringLiteral("# List of favorites, one path per line, with + or - for additions and removals");
+}
+
+// Applies the records of the journal in order; lines without a prefix are
+// from the earlier format, and are additions. Returns the number of records.
+int read_records(QTextStream& stream, QSet<QString>& favorites)
+{
+    int record_count = 0;
+
+    QString line;
+    while (stream.readLineInto(&line)) {
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        record_count++;
+        if (line.startsWith(RECORD_REMOVE))
+            favorites.remove(line.mid(1));
+        else if (line.startsWith(RECORD_ADD))
+            favorites.insert(line.mid(1));
+        else
+            favorites.insert(line);
+    }
+
+    return record_count;
+}
+
+// The paths are stored as canonical paths (or relative to them in portable
+// mode), so they can be found without touching the disk, except when the
+// files were moved since they were written
+model::Game* resolve_game(const providers::SearchContext& sctx, const QDir& base_dir, const QString& path)
+{
+    const QString clean_path = QDir::cleanPath(base_dir.absoluteFilePath(path));
+    model::Game* const game_ptr = sctx.game_by_filepath(clean_path);
+    if (game_ptr)
+        return game_ptr;
+
+    const QString can_path = QFileInfo(clean_path).canonicalFilePath();
+    return (!can_path.isEmpty() && can_path != clean_path)
+        ? sctx.game_by_filepath(can_path)
+        : nullptr;
+}
 } // namespace
 
 
@@ -48,8 +102,14 @@ Favorites::Favorites(QObject* parent)
 Favorites::Favorites(QString db_path, QObject* parent)
     : Provider(QLatin1String("pegasus_favorites"), QStringLiteral("Favorites"), PROVIDER_FLAG_INTERNAL, parent)
     , m_db_path(std::move(db_path))
+    , m_written_records(-1)
 {}
 
+Favorites::~Favorites()
+{
+    m_write_future.waitForFinished();
+}
+
 Provider& Favorites::run(SearchContext& sctx)
 {
     if (!QFileInfo::exists(m_db_path))
@@ -61,16 +121,13 @@ Provider& Favorites::run(SearchContext& sctx)
         return *this;
     }
 
-    const QDir base_dir = QFileInfo(m_db_path).dir();
-
+    QSet<QString> favorites;
     QTextStream db_stream(&db_file);
-    QString line;
-    while (db_stream.readLineInto(&line)) {
-        if (line.startsWith('#'))
-            continue;
+    read_records(db_stream, favorites);
 
-        const QString path = QFileInfo(base_dir, line).canonicalFilePath();
-        model::Game* const game_ptr = sctx.game_by_filepath(path);
+    const QDir base_dir = QFileInfo(m_db_path).dir();
+    for (const QString& path : qAsConst(favorites)) {
+        model::Game* const game_ptr = resolve_game(sctx, base_dir, path);
         if (game_ptr)
             game_ptr->setFavorite(true);
     }
@@ -78,27 +135,24 @@ Provider& Favorites::run(SearchContext& sctx)
     return *this;
 }
 
-void Favorites::onGameFavoriteChanged(const QVector<model::Game*>& game_list)
+void Favorites::onGameFavoriteChanged(model::Game* const game)
 {
+    Q_ASSERT(game);
+
     const QMutexLocker lock(&m_task_guard);
     const QDir config_dir(paths::writableConfigDir());
+    const QChar record_type = game->isFavorite() ? RECORD_ADD : RECORD_REMOVE;
 
-    m_pending_task.clear();
-    m_pending_task << QStringLiteral("# List of favorites, one path per line");
-    for (const model::Game* const game : game_list) {
-        if (game->isFavorite()) {
-            for (const model::GameFile* const file : game->filesConst()) {
-                const QString full_path = file->fileinfo().canonicalFilePath();
-                const QString written_path = AppSettings::general.portable
-                    ? config_dir.relativeFilePath(full_path)
-                    : full_path;
-                if (Q_LIKELY(!written_path.isEmpty()))
-                    m_pending_task << written_path;
-            }
-        }
+    for (const model::GameFile* const file : game->filesConst()) {
+        const QString full_path = file->fileinfo().canonicalFilePath();
+        const QString written_path = AppSettings::general.portable
+            ? config_dir.relativeFilePath(full_path)
+            : full_path;
+        if (Q_LIKELY(!written_path.isEmpty()))
+            m_pending_task << record_type + written_path;
     }
 
-    if (m_active_task.isEmpty())
+    if (m_active_task.isEmpty() && !m_pending_task.isEmpty())
         start_processing();
 }
 
@@ -107,20 +161,11 @@ void Favorites::start_processing()
     m_active_task = m_pending_task;
     m_pending_task.clear();
 
-    QtConcurrent::run([this]{
+    m_write_future = QtConcurrent::run([this]{
         emit startedWriting();
 
         while (true) {
-            QFile db_file(m_db_path);
-            if (!db_file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-                Log::error(display_name(), LOGMSG("Could not open `%1` for writing, favorites are not saved")
-                    .arg(m_db_path));
-                break;
-            }
-
-            QTextStream db_stream(&db_file);
-            for (const QString& fav : qAsConst(m_active_task))
-                db_stream << fav << endl;
+            write_records(m_active_task);
 
             QMutexLocker lock(&m_task_guard);
             m_active_task.clear();
@@ -135,5 +180,78 @@ void Favorites::start_processing()
     });
 }
 
+bool Favorites::write_records(const QStringList& records)
+{
+    // the current contents are read once, so the journal can be compacted later
+    if (m_written_records < 0) {
+        m_written_records = 0;
+
+        QFile db_file(m_db_path);
+        if (db_file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            QTextStream db_stream(&db_file);
+            m_written_records = read_records(db_stream, m_written_favorites);
+        }
+    }
+
+    for (const QString& record : records) {
+        if (record.startsWith(RECORD_ADD))
+            m_written_favorites.insert(record.mid(1));
+        else
+            m_written_favorites.remove(record.mid(1));
+    }
+
+    const int record_count = m_written_records + records.count();
+    const int compaction_limit = std::max(COMPACTION_MIN_RECORDS, COMPACTION_RATIO * m_written_favorites.count());
+    if (compaction_limit < record_count)
+        return compact();
+
+    QFile db_file(m_db_path);
+    if (!db_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        Log::error(display_name(), LOGMSG("Could not open `%1` for writing, favorites are not saved")
+            .arg(m_db_path));
+        return false;
+    }
+
+    QTextStream db_stream(&db_file);
+    if (db_file.size() == 0)
+        db_stream << file_header() << endl;
+    for (const QString& record : records)
+        db_stream << record << endl;
+
+    m_written_records = record_count;
+    return true;
+}
+
+bool Favorites::compact()
+{
+    QStringList favorites = m_written_favorites.values();
+    std::sort(favorites.begin(), favorites.end());
+
+    // the file is replaced only after the new one is fully written
+    QSaveFile db_file(m_db_path);
+    if (!db_file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        Log::error(display_name(), LOGMSG("Could not open `%1` for writing, favorites are not saved")
+            .arg(m_db_path));
+        return false;
+    }
+
+    QTextStream db_stream(&db_file);
+    db_stream << file_header() << endl;
+    for (const QString& path : qAsConst(favorites))
+        db_stream << RECORD_ADD << path << endl;
+    db_stream.flush();
+
+    if (!db_file.commit()) {
+        Log::error(display_name(), LOGMSG("Failed to write `%1`, favorites are not saved").arg(m_db_path));
+        // the file may be in any state now, so read it again next time
+        m_written_favorites.clear();
+        m_written_records = -1;
+        return false;
+    }
+
+    m_written_records = favorites.count();
+    return true;
+}
+
 } // namespace favorites
 } // namespace providers
@@ -19,22 +19,27 @@
 
 #include "providers/Provider.h"
 
+#include <QFuture>
 #include <QMutex>
+#include <QSet>
 
 
 namespace providers {
 namespace favorites {
 
+// The favorites are stored as a journal: every change appends an add or
+// remove record to the end of the file, which is compacted from time to time.
 class Favorites : public Provider {
     Q_OBJECT
 
 public:
     explicit Favorites(QString db_path, QObject* parent = nullptr);
     explicit Favorites(QObject* parent = nullptr);
+    ~Favorites() override;
 
     Provider& run(SearchContext&) final;
 
-    void onGameFavoriteChanged(const QVector<model::Game*>&) final;
+    void onGameFavoriteChanged(model::Game* const) final;
 
 signals:
     void startedWriting();
@@ -46,8 +51,15 @@ private:
     QStringList m_pending_task;
     QStringList m_active_task;
     QMutex m_task_guard;
+    QFuture<void> m_write_future;
+
+    // the state of the file, only used by the writer
+    QSet<QString> m_written_favorites;
+    int m_written_records;
 
     void start_processing();
+    bool write_records(const QStringList&);
+    bool compact();
 };
 
 } // namespace favorites
@@ -17,6 +17,7 @@
 
 #include "MediaProvider.h"
 
+#include "AppSettings.h"
 #include "PegasusAssets.h"
 #include "model/gaming/Assets.h"
 #include "model/gaming/Game.h"
@@ -31,15 +32,6 @@
 
 
 namespace {
-AssetType detect_asset_type(const QString& basename, const QString& ext)
-{
-    const AssetType type = pegasus_assets::str_to_type(basename);
-    if (pegasus_assets::allowed_asset_exts(type).contains(ext))
-        return type;
-
-    return AssetType::UNKNOWN;
-}
-
 HashMap<QString, model::Game*> create_lookup_map(const HashMap<QString, model::GameFile*>& games)
 {
     HashMap<QString, model::Game*> out;
@@ -59,6 +51,37 @@ HashMap<QString, model::Game*> create_lookup_map(const HashMap<QString, model::G
 
     return out;
 }
+
+void register_lazy_dirs(const QStringList& dir_bases, const HashMap<QString, model::GameFile*>& games)
+{
+    // NOTE: the keys are canonical paths already, so no file system access is necessary here
+    for (const auto& pair : games) {
+        const QString& file_path = pair.first;
+        const int file_dir_len = file_path.lastIndexOf(QChar('/'));
+        if (file_dir_len < 0)
+            continue;
+
+        model::Game* const game_ptr = pair.second->parentGame();
+        const QString basename = QFileInfo(file_path).completeBaseName();
+
+        for (const QString& dir_base : dir_bases) {
+            const bool is_inside = file_dir_len >= dir_base.length()
+                && file_path.startsWith(dir_base)
+                && file_path.at(dir_base.length()) == QChar('/');
+            if (!is_inside)
+                continue;
+
+            const QString media_dir = dir_base
+                % QLatin1String("/media")
+                % file_path.midRef(dir_base.length(), file_dir_len - dir_base.length())
+                % QChar('/');
+
+            game_ptr->assetsMut()
+                .add_lazy_dir(media_dir + basename)
+                .add_lazy_dir(media_dir + game_ptr->title());
+        }
+    }
+}
 } // namespace
 
 
@@ -75,6 +98,11 @@ Provider& MediaProvider::run(SearchContext& sctx)
     constexpr auto dir_flags = QDirIterator::Subdirectories | QDirIterator::FollowSymlinks;
     constexpr int media_len = 6; // length of `/media`
 
+    if (AppSettings::general.lazy_assets) {
+        register_lazy_dirs(sctx.pegasus_game_dirs(), sctx.current_filepath_to_entry_map());
+        return *this;
+    }
+
     const HashMap<QString, model::Game*> lookup_map = create_lookup_map(sctx.current_filepath_to_entry_map());
 
     for (const QString& dir_base : sctx.pegasus_game_dirs()) {
@@ -90,7 +118,7 @@ Provider& MediaProvider::run(SearchContext& sctx)
             if (lookup_it == lookup_map.cend())
                 continue;
 
-            const AssetType asset_type = detect_asset_type(fileinfo.completeBaseName(), fileinfo.suffix());
+            const AssetType asset_type = pegasus_assets::detect_media_type(fileinfo.completeBaseName(), fileinfo.suffix());
             if (asset_type == AssetType::UNKNOWN)
                 continue;
 
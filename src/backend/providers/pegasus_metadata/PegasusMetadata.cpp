@@ -179,7 +179,7 @@ void Metadata::print_error(const ParserState& ps, const metafile::Error& err) co
 
 void Metadata::print_warning(const ParserState& ps, const metafile::Entry& entry, const QString& msg) const
 {
-    Log::warning(m_log_tag, LOGMSG("`%1`, line %2: %3")
+    LOG_WARNING(m_log_tag, LOGMSG("`%1`, line %2: %3")
         .arg(QDir::toNativeSeparators(ps.path), QString::number(entry.line), msg));
 }
 
@@ -28,7 +28,6 @@
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
-#include <QtConcurrent/QtConcurrent>
 
 
 namespace {
@@ -50,24 +49,30 @@ void on_create_table_fail(const QString& log_tag, QSqlQuery& query)
     print_query_error(log_tag, query);
 }
 
+bool exec_schema_query(const QString& log_tag, SqliteDb& channel, const QString& query_str)
+{
+    QSqlQuery query = channel.query();
+    if (!query.exec(query_str)) {
+        on_create_table_fail(log_tag, query);
+        return false;
+    }
+    return true;
+}
+
 bool create_missing_tables(const QString& log_tag, SqliteDb& channel)
 {
     if (!channel.hasTable(QStringLiteral("paths"))) {
-        QSqlQuery query;
-        query.prepare(QStringLiteral(
+        const bool success = exec_schema_query(log_tag, channel, QStringLiteral(
             "CREATE TABLE paths"
               "(" "id INTEGER PRIMARY KEY"
               "," "path TEXT UNIQUE NOT NULL"
             ");"
         ));
-        if (!query.exec()) {
-            on_create_table_fail(log_tag, query);
+        if (!success)
             return false;
-        }
     }
     if (!channel.hasTable(QStringLiteral("plays"))) {
-        QSqlQuery query;
-        query.prepare(QStringLiteral(
+        const bool success = exec_schema_query(log_tag, channel, QStringLiteral(
             "CREATE TABLE plays"
               "(" "id INTEGER PRIMARY KEY"
               "," "path_id INTEGER NOT NULL REFERENCES plays(id)"
@@ -75,63 +80,129 @@ bool create_missing_tables(const QString& log_tag, SqliteDb& channel)
               "," "duration INTEGER NOT NULL"
             ");"
         ));
-        if (!query.exec()) {
-            on_create_table_fail(log_tag, query);
+        if (!success)
             return false;
-        }
     }
 
     return true;
 }
 
-int get_path_id(const QString& log_tag, const QString& game_key)
+int schema_version(const QString& log_tag, SqliteDb& channel)
 {
-    {
-        QSqlQuery query;
-        query.prepare(QStringLiteral("SELECT id FROM paths WHERE path = ?;"));
-        query.addBindValue(game_key);
-        if (!query.exec()) {
-            print_query_error(log_tag, query);
-            return -1;
-        }
-        if (query.next())
-            return query.value(0).toInt();
+    QSqlQuery query = channel.query();
+    if (!query.exec(QStringLiteral("PRAGMA user_version;"))) {
+        print_query_error(log_tag, query);
+        return -1;
     }
-    // no hit -> insert
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+// Version 1: an index on the path ids of the plays, and a per-path summary
+// of the plays, kept up to date by a trigger. This way only one row has to
+// be read per game on startup, no matter how many times it was played.
+bool upgrade_to_v1(const QString& log_tag, SqliteDb& channel)
+{
+    const QString queries[] {
+        QStringLiteral(
+            "CREATE INDEX IF NOT EXISTS plays_path_id ON plays(path_id);"),
+        QStringLiteral(
+            "CREATE TABLE IF NOT EXISTS path_stats"
+              "(" "path_id INTEGER PRIMARY KEY REFERENCES paths(id)"
+              "," "play_count INTEGER NOT NULL"
+              "," "play_time INTEGER NOT NULL"
+              "," "last_played INTEGER NOT NULL"
+            ");"),
+        QStringLiteral(
+            "INSERT OR REPLACE INTO path_stats"
+            " SELECT path_id, COUNT(*), SUM(MAX(duration, 0)), MAX(start_time + duration)"
+            " FROM plays"
+            " GROUP BY path_id;"),
+        QStringLiteral(
+            "CREATE TRIGGER IF NOT EXISTS plays_summary AFTER INSERT ON plays"
+            " BEGIN"
+              " INSERT OR IGNORE INTO path_stats VALUES(NEW.path_id, 0, 0, 0);"
+              " UPDATE path_stats SET"
+                " play_count = play_count + 1"
+                "," "play_time = play_time + MAX(NEW.duration, 0)"
+                "," "last_played = MAX(last_played, NEW.start_time + NEW.duration)"
+              " WHERE path_id = NEW.path_id;"
+            " END;"),
+        QStringLiteral(
+            "PRAGMA user_version = 1;"),
+    };
+
+    for (const QString& query : queries) {
+        if (!exec_schema_query(log_tag, channel, query))
+            return false;
+    }
+    return true;
+}
+
+bool upgrade_schema(const QString& log_tag, SqliteDb& channel)
+{
+    const int version = schema_version(log_tag, channel);
+    if (version < 0)
+        return false;
+
+    if (version < 1) {
+        Log::info(log_tag, LOGMSG("Upgrading the play time database, this may take a while"));
+        if (!upgrade_to_v1(log_tag, channel))
+            return false;
+    }
+
+    return true;
+}
+
+bool prepare_schema(const QString& log_tag, SqliteDb& channel)
+{
+    channel.startTransaction();
+
+    const bool success = create_missing_tables(log_tag, channel) && upgrade_schema(log_tag, channel);
+    if (success)
+        channel.commit();
+    else
+        channel.rollback();
+
+    return success;
+}
+
+int get_path_id(const QString& log_tag, SqliteDb& channel, const QString& game_key)
+{
     {
-        QSqlQuery query;
-        query.prepare(QStringLiteral("INSERT INTO paths VALUES(null, ?);"));
-        query.addBindValue(game_key);
+        QSqlQuery& query = channel.prepared(QStringLiteral("INSERT OR IGNORE INTO paths VALUES(null, ?);"));
+        query.bindValue(0, game_key);
         if (!query.exec()) {
             print_query_error(log_tag, query);
             return -1;
         }
+        if (query.numRowsAffected() > 0)
+            return query.lastInsertId().toInt();
     }
+    // already existed
     {
-        QSqlQuery query;
-        query.prepare(QStringLiteral("SELECT last_insert_rowid() FROM paths;"));
+        QSqlQuery& query = channel.prepared(QStringLiteral("SELECT id FROM paths WHERE path = ?;"));
+        query.bindValue(0, game_key);
         if (!query.exec()) {
             print_query_error(log_tag, query);
             return -1;
         }
-        if (query.next())
-            return query.value(0).toInt();
-    }
 
-    return -1;
+        const int path_id = query.next() ? query.value(0).toInt() : -1;
+        query.finish();
+        return path_id;
+    }
 }
 
-void save_play_entry(const QString& log_tag, const int path_id, const QDateTime& start_time, const qint64 duration)
+void save_play_entry(const QString& log_tag, SqliteDb& channel, const int path_id, const QDateTime& start_time, const qint64 duration)
 {
     Q_ASSERT(path_id != -1);
     Q_ASSERT(start_time.isValid());
     Q_ASSERT(0 <= duration);
 
-    QSqlQuery query;
-    query.prepare(QStringLiteral("INSERT INTO plays VALUES(null, ?, ?, ?);"));
-    query.addBindValue(path_id);
-    query.addBindValue(start_time.toSecsSinceEpoch());
-    query.addBindValue(duration);
+    QSqlQuery& query = channel.prepared(QStringLiteral("INSERT INTO plays VALUES(null, ?, ?, ?);"));
+    query.bindValue(0, path_id);
+    query.bindValue(1, start_time.toSecsSinceEpoch());
+    query.bindValue(2, duration);
     if (!query.exec())
         print_query_error(log_tag, query);
 }
@@ -155,7 +226,14 @@ PlaytimeStats::PlaytimeStats(QObject* parent)
 PlaytimeStats::PlaytimeStats(QString db_path, QObject* parent)
     : Provider(QLatin1String("pegasus_playtime"), QStringLiteral("Playtime"), PROVIDER_FLAG_INTERNAL, parent)
     , m_db_path(std::move(db_path))
-{}
+    , m_writer(display_name(), m_db_path,
+        [this](SqliteDb& channel){ return prepare_schema(display_name(), channel); })
+{
+    connect(&m_writer, &SqliteWorker::started,
+            this, &PlaytimeStats::startedWriting);
+    connect(&m_writer, &SqliteWorker::finished,
+            this, &PlaytimeStats::finishedWriting);
+}
 
 Provider& PlaytimeStats::run(SearchContext& sctx)
 {
@@ -173,46 +251,40 @@ Provider& PlaytimeStats::run(SearchContext& sctx)
         return *this;
 
 
-    QSqlQuery query;
-    query.prepare(QStringLiteral(
-        "SELECT paths.path, plays.start_time, plays.duration"
-        " FROM plays"
-        " INNER JOIN paths ON plays.path_id=paths.id;"
-    ));
+    // If the database can't be upgraded (eg. it's read-only), the plays
+    // are aggregated on the fly
+    const bool has_summary = prepare_schema(display_name(), channel);
+    if (!has_summary)
+        Log::warning(display_name(), LOGMSG("Could not upgrade `%1`, loading play times may be slow").arg(m_db_path));
+
+    QSqlQuery query = channel.query();
+    query.setForwardOnly(true);
+    query.prepare(has_summary
+        ? QStringLiteral(
+            "SELECT paths.path, path_stats.play_count, path_stats.play_time, path_stats.last_played"
+            " FROM path_stats"
+            " INNER JOIN paths ON path_stats.path_id=paths.id;")
+        : QStringLiteral(
+            "SELECT paths.path, COUNT(*), SUM(MAX(plays.duration, 0)), MAX(plays.start_time + plays.duration)"
+            " FROM plays"
+            " INNER JOIN paths ON plays.path_id=paths.id"
+            " GROUP BY plays.path_id;"));
     if (!query.exec()) {
         print_query_error(display_name(), query);
         return *this;
     }
 
-
-    struct Stats {
-        int playcount { 0 };
-        qint64 playtime { 0 };
-        QDateTime last_played;
-    };
-    HashMap<model::GameFile*, Stats> stat_map;
-
+    // one row per path, so every file is updated only once
     while (query.next()) {
         const QString path = query.value(0).toString();
         model::GameFile* const game_ptr = sctx.gamefile_by_filepath(path); // TODO: URI support
         if (!game_ptr)
             continue;
 
-        const qint64 start_epoch = query.value(1).toLongLong();
-        const qint64 duration = query.value(2).toLongLong();
-
-        Stats& stats = stat_map[game_ptr];
-        stats.last_played = QDateTime::fromSecsSinceEpoch(start_epoch + duration);
-        stats.playtime += std::max(static_cast<qint64>(0), duration);
-        stats.playcount++;
-    }
-
-    // trigger update only once
-    // TODO: C++17
-    for (const auto& pair : stat_map) {
-        model::GameFile* const gamefile = pair.first;
-        const Stats& stats = pair.second;
-        gamefile->update_playstats(stats.playcount, stats.playtime, stats.last_played);
+        const int playcount = query.value(1).toInt();
+        const qint64 playtime = query.value(2).toLongLong();
+        const QDateTime last_played = QDateTime::fromSecsSinceEpoch(query.value(3).toLongLong());
+        game_ptr->update_playstats(playcount, playtime, last_played);
     }
 
     return *this;
@@ -229,64 +301,21 @@ void PlaytimeStats::onGameFinished(model::GameFile* const gamefile)
     Q_ASSERT(gamefile);
     Q_ASSERT(m_last_launch_time.isValid());
 
-    QMutexLocker lock(&m_queue_guard);
-
-    const auto now = QDateTime::currentDateTimeUtc();
-    const auto duration = m_last_launch_time.secsTo(now);
-
-    m_pending_tasks.emplace_back(
-        gamefile,
-        m_last_launch_time,
-        duration
-    );
-
-    if (m_active_tasks.empty())
-        start_processing();
-}
-
-void PlaytimeStats::start_processing()
-{
-    Q_ASSERT(m_active_tasks.empty());
-
-    m_active_tasks.swap(m_pending_tasks);
-
-    QtConcurrent::run([this]{
-        emit startedWriting();
-
-        while (!m_active_tasks.empty()) {
-            for (const QueueEntry& entry : m_active_tasks)
-                update_modelgame(entry.gamefile, entry.launch_time, entry.duration);
-
-            SqliteDb channel(m_db_path);
-            if (!channel.open()) {
-                Log::warning(display_name(), LOGMSG("Could not open or create `%1`, play time will not be saved")
-                    .arg(m_db_path));
-                break;
-            }
-
-            channel.startTransaction();
-
-            if (!create_missing_tables(display_name(), channel)) {
-                channel.rollback();
-                break;
-            }
-
-            for (const QueueEntry& entry : m_active_tasks) {
-                const QString path = entry.gamefile->fileinfo().canonicalFilePath();
-                const int path_id = get_path_id(display_name(), path);
-                if (path_id >= 0)
-                    save_play_entry(display_name(), path_id, entry.launch_time, entry.duration);
-            }
-
-            channel.commit();
-
-            // pick up new tasks
-            QMutexLocker lock(&m_queue_guard);
-            m_active_tasks.clear();
-            m_active_tasks.swap(m_pending_tasks);
+    const QDateTime launch_time = m_last_launch_time;
+    const qint64 duration = launch_time.secsTo(QDateTime::currentDateTimeUtc());
+    update_modelgame(gamefile, launch_time, duration);
+
+    const QString path = gamefile->fileinfo().canonicalFilePath();
+    m_writer.post([this, path, launch_time, duration](SqliteDb& channel){
+        // only used on the writer thread
+        auto it = m_path_ids.find(path);
+        if (it == m_path_ids.end()) {
+            const int path_id = get_path_id(display_name(), channel, path);
+            if (path_id < 0)
+                return;
+            it = m_path_ids.emplace(path, path_id).first;
         }
-
-        emit finishedWriting();
+        save_play_entry(display_name(), channel, it->second, launch_time, duration);
     });
 }
 
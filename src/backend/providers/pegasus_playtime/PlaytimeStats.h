@@ -18,9 +18,10 @@
 #pragma once
 
 #include "providers/Provider.h"
+#include "utils/HashMap.h"
+#include "utils/SqliteWorker.h"
 
 #include <QDateTime>
-#include <QMutex>
 
 
 namespace providers {
@@ -47,22 +48,9 @@ private:
 
     QDateTime m_last_launch_time;
 
-    struct QueueEntry {
-        model::GameFile* const gamefile;
-        const QDateTime launch_time;
-        const qint64 duration;
-
-        QueueEntry(model::GameFile* const gamefile, QDateTime launch_time, qint64 duration)
-            : gamefile(std::move(gamefile))
-            , launch_time(std::move(launch_time))
-            , duration(std::move(duration))
-        {}
-    };
-    std::vector<QueueEntry> m_pending_tasks;
-    std::vector<QueueEntry> m_active_tasks;
-    QMutex m_queue_guard;
-
-    void start_processing();
+    // the path ids are only used by the writer, and have to outlive it
+    HashMap<QString, int> m_path_ids;
+    SqliteWorker m_writer;
 };
 
 } // namespace playtime
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 enum class AssetType : unsigned char {
     UNKNOWN,
 
@@ -43,3 +45,5 @@ enum class AssetType : unsigned char {
     SCREENSHOT,
     VIDEO,
 };
+
+constexpr size_t ASSET_TYPE_COUNT = static_cast<size_t>(AssetType::VIDEO) + 1;
@@ -0,0 +1,126 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "Bitset.h"
+
+#include <QtAlgorithms>
+#include <algorithm>
+
+
+namespace {
+// The number of bits set in both word arrays; counting a single array
+// passes it twice, as `x & x == x`
+using CountFunc = size_t(*)(const quint64*, const quint64*, size_t);
+
+size_t count_and_portable(const quint64* a, const quint64* b, size_t len)
+{
+    size_t sum = 0;
+    for (size_t i = 0; i < len; i++)
+        sum += qPopulationCount(a[i] & b[i]);
+    return sum;
+}
+
+// NOTE: The baseline x86-64 target has no POPCNT instruction, so without
+//       eg. `-mpopcnt` the compiler generates a slow bit twiddling fallback.
+//       Instead, a version built for POPCNT is selected at runtime.
+#if defined(Q_PROCESSOR_X86_64) && defined(Q_CC_GNU) && !defined(__POPCNT__)
+#define BITSET_POPCNT_DISPATCH
+
+__attribute__((target("popcnt")))
+size_t count_and_popcnt(const quint64* a, const quint64* b, size_t len)
+{
+    size_t sum = 0;
+    for (size_t i = 0; i < len; i++)
+        sum += static_cast<size_t>(__builtin_popcountll(a[i] & b[i]));
+    return sum;
+}
+#endif
+
+CountFunc select_count_func()
+{
+#ifdef BITSET_POPCNT_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt"))
+        return count_and_popcnt;
+#endif
+    return count_and_portable;
+}
+
+const CountFunc count_and_words = select_count_func();
+} // namespace
+
+
+namespace utils {
+Bitset::Bitset(size_t size, bool value)
+    : m_words((size + 63) / 64, value ? ~quint64(0) : quint64(0))
+    , m_size(size)
+{
+    clear_padding();
+}
+
+void Bitset::set(size_t idx, bool value)
+{
+    Q_ASSERT(idx < m_size);
+    const quint64 mask = quint64(1) << (idx % 64);
+    if (value)
+        m_words[idx / 64] |= mask;
+    else
+        m_words[idx / 64] &= ~mask;
+}
+
+void Bitset::fill(bool value)
+{
+    std::fill(m_words.begin(), m_words.end(), value ? ~quint64(0) : quint64(0));
+    clear_padding();
+}
+
+void Bitset::clear_padding()
+{
+    // the bits after the end are always zero, so they don't affect the counts
+    const size_t used_bits = m_size % 64;
+    if (used_bits)
+        m_words.back() &= (quint64(1) << used_bits) - 1;
+}
+
+Bitset& Bitset::operator&=(const Bitset& other)
+{
+    Q_ASSERT(m_size == other.m_size);
+    for (size_t i = 0; i < m_words.size(); i++)
+        m_words[i] &= other.m_words[i];
+    return *this;
+}
+
+Bitset& Bitset::operator|=(const Bitset& other)
+{
+    Q_ASSERT(m_size == other.m_size);
+    for (size_t i = 0; i < m_words.size(); i++)
+        m_words[i] |= other.m_words[i];
+    return *this;
+}
+
+size_t Bitset::count() const
+{
+    return count_and_words(m_words.data(), m_words.data(), m_words.size());
+}
+
+size_t Bitset::count_and(const Bitset& a, const Bitset& b)
+{
+    Q_ASSERT(a.m_size == b.m_size);
+    return count_and_words(a.m_words.data(), b.m_words.data(), a.m_words.size());
+}
+} // namespace utils
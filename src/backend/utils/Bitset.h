@@ -0,0 +1,56 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QtGlobal>
+#include <vector>
+
+
+namespace utils {
+/// A fixed size set of bits, stored in 64 bit words
+///
+/// The bitwise operations and the counting work on whole words. Counting
+/// uses the hardware population count instruction where available, on
+/// x86-64 by checking the CPU at runtime; it is not SIMD vectorized.
+class Bitset {
+public:
+    explicit Bitset(size_t size = 0, bool value = false);
+
+    size_t size() const { return m_size; }
+    bool test(size_t idx) const { return m_words[idx / 64] & (quint64(1) << (idx % 64)); }
+    void set(size_t idx, bool value = true);
+    void fill(bool value);
+
+    Bitset& operator&=(const Bitset&);
+    Bitset& operator|=(const Bitset&);
+    bool operator==(const Bitset& other) const { return m_size == other.m_size && m_words == other.m_words; }
+    bool operator!=(const Bitset& other) const { return !(*this == other); }
+
+    /// The number of set bits
+    size_t count() const;
+    /// The number of bits set in both sets, without creating a new one
+    static size_t count_and(const Bitset&, const Bitset&);
+
+private:
+    std::vector<quint64> m_words;
+    size_t m_size;
+
+    void clear_padding();
+};
+} // namespace utils
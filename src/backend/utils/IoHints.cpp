@@ -0,0 +1,91 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "IoHints.h"
+
+#include <QFile>
+#include <QThread>
+#include <algorithm>
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+#if defined(Q_OS_LINUX) && defined(SYS_ioprio_set)
+// from linux/ioprio.h, which is not always installed
+constexpr int IOPRIO_CLASS_IDLE = 3;
+constexpr int IOPRIO_CLASS_SHIFT = 13;
+constexpr int IOPRIO_WHO_PROCESS = 1;
+#endif
+
+constexpr qint64 READ_CHUNK_SIZE = 256 * 1024;
+} // namespace
+
+
+namespace utils {
+
+void lower_thread_priority()
+{
+    // on Linux, only the idle priority has an effect on regular threads
+    QThread::currentThread()->setPriority(QThread::IdlePriority);
+
+#if defined(Q_OS_LINUX) && defined(SYS_ioprio_set)
+    // with a pid of 0, this affects the calling thread only
+    syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT);
+#endif
+}
+
+bool prefetch_file(const QString& path, qint64 length)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    prefetch_range(file, 0, length > 0 ? length : file.size());
+    return true;
+}
+
+bool prefetch_range(QFile& file, qint64 offset, qint64 length)
+{
+    Q_ASSERT(file.isOpen());
+
+#if defined(Q_OS_LINUX)
+    // the readahead is queued by the kernel, and can't be waited for or cancelled
+    if (posix_fadvise(file.handle(), offset, length, POSIX_FADV_WILLNEED) == 0)
+        return false;
+#endif
+
+    if (!file.seek(offset))
+        return false;
+
+    qint64 read_total = 0;
+    QByteArray buffer(static_cast<int>(READ_CHUNK_SIZE), Qt::Uninitialized);
+    while (read_total < length) {
+        const qint64 read_len = file.read(buffer.data(), std::min(READ_CHUNK_SIZE, length - read_total));
+        if (read_len <= 0)
+            break;
+        read_total += read_len;
+    }
+    return read_total == length;
+}
+
+} // namespace utils
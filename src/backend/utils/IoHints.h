@@ -0,0 +1,42 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QtGlobal>
+
+class QFile;
+class QString;
+
+
+namespace utils {
+
+/// Lowers the CPU and disk I/O priority of the calling thread, where supported.
+/// Meant for background threads that should not slow down the UI.
+void lower_thread_priority();
+
+/// Asks the OS to read the beginning of the file (or all of it if the length is 0)
+/// into the page cache in the background. On platforms without readahead hints,
+/// the data is read and discarded. Returns false if the file could not be opened.
+bool prefetch_file(const QString& path, qint64 length = 0);
+/// Same as above, for a part of an already opened file. On Linux this is only a
+/// hint that returns right away, while the kernel reads the data on its own;
+/// elsewhere the data is read before returning. Returns true if it was read.
+bool prefetch_range(QFile& file, qint64 offset, qint64 length);
+
+} // namespace utils
@@ -0,0 +1,88 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "MemoryUsage.h"
+
+#include <QFile>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+
+namespace utils {
+
+qint64 resident_memory_size()
+{
+#if defined(Q_OS_LINUX)
+    // the fields are the total and resident size, in pages
+    QFile file(QStringLiteral("/proc/self/statm"));
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    const QList<QByteArray> fields = file.readLine().split(' ');
+    if (fields.size() < 2)
+        return -1;
+
+    bool ok = false;
+    const qint64 pages = fields.at(1).toLongLong(&ok);
+    return ok
+        ? pages * sysconf(_SC_PAGESIZE)
+        : -1;
+#else
+    return -1;
+#endif
+}
+
+qint64 available_memory_size()
+{
+#if defined(Q_OS_LINUX)
+    QFile file(QStringLiteral("/proc/meminfo"));
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    // the line looks like `MemAvailable:    1234567 kB`
+    const QByteArray prefix = QByteArrayLiteral("MemAvailable:");
+    // NOTE: the files in /proc report a zero size, so atEnd() can't be used
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray& line : lines) {
+        if (!line.startsWith(prefix))
+            continue;
+
+        const QList<QByteArray> fields = line.mid(prefix.size()).simplified().split(' ');
+        bool ok = false;
+        const qint64 kbytes = fields.first().toLongLong(&ok);
+        return ok ? kbytes * 1024 : -1;
+    }
+    return -1;
+#else
+    return -1;
+#endif
+}
+
+void trim_heap()
+{
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+} // namespace utils
@@ -0,0 +1,35 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QtGlobal>
+
+
+namespace utils {
+
+/// Returns the resident memory size of the process in bytes, or -1 if not available
+qint64 resident_memory_size();
+
+/// Returns the memory available for new allocations and caches in bytes, or -1 if not available
+qint64 available_memory_size();
+
+/// Returns the free memory of the heap to the OS, where the allocator supports it
+void trim_heap();
+
+} // namespace utils
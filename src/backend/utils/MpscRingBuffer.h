@@ -0,0 +1,120 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+
+namespace utils {
+/// A fixed size, lock-free queue for multiple producers and one consumer
+///
+/// Every slot has a sequence number, which tells whether it's ready to be
+/// written or read in the current round. The producers only compete for the
+/// write position, with a single atomic operation; the consumer doesn't
+/// need any.
+template<typename T>
+class MpscRingBuffer {
+public:
+    /// The capacity must be a power of two
+    explicit MpscRingBuffer(size_t capacity)
+        : m_cells(new Cell[capacity])
+        , m_mask(capacity - 1)
+        , m_write()
+        , m_read()
+    {
+        Q_ASSERT(capacity >= 2 && (capacity & m_mask) == 0);
+        m_write.value.store(0, std::memory_order_relaxed);
+        m_read.value = 0;
+        for (size_t i = 0; i < capacity; i++)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /// Moves the item into the queue, unless it's full; can be called from any thread
+    bool try_push(T& item)
+    {
+        Cell* cell = nullptr;
+        size_t pos = m_write.value.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<qintptr>(seq) - static_cast<qintptr>(pos);
+            if (diff == 0) {
+                if (m_write.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = m_write.value.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Takes the oldest item, if there's any; only the consumer thread may call it
+    bool try_pop(T& out)
+    {
+        Cell& cell = m_cells[m_read.value & m_mask];
+        const size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq != m_read.value + 1)
+            return false;
+
+        out = std::move(cell.data);
+        cell.sequence.store(m_read.value + m_mask + 1, std::memory_order_release);
+        m_read.value++;
+        return true;
+    }
+
+    /// Whether there's nothing to pop; only the consumer thread may call it
+    bool empty() const
+    {
+        const Cell& cell = m_cells[m_read.value & m_mask];
+        return cell.sequence.load(std::memory_order_acquire) != m_read.value + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    // NOTE: The write position is used by the producers, the read position
+    //       by the consumer, so they are kept on separate cache lines. This
+    //       is done with padding instead of `alignas`, as before C++17 `new`
+    //       does not respect the alignment of over-aligned types.
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    template<typename V>
+    struct Padded {
+        char padding[CACHE_LINE_SIZE];
+        V value;
+    };
+
+    const std::unique_ptr<Cell[]> m_cells;
+    const size_t m_mask;
+    Padded<std::atomic<size_t>> m_write;
+    Padded<size_t> m_read;
+};
+} // namespace utils
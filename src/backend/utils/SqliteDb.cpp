@@ -17,21 +17,35 @@
 
 #include "SqliteDb.h"
 
+#include <QAtomicInt>
 #include <QStringList>
 
 
+namespace {
+QString unique_connection_name()
+{
+    static QAtomicInt counter;
+    return QStringLiteral("sqlite_%1").arg(counter.fetchAndAddRelaxed(1));
+}
+} // namespace
+
+
 SqliteDb::SqliteDb(const QString& db_path)
-    : m_db(QSqlDatabase::addDatabase(QStringLiteral("QSQLITE")))
+    : m_db(QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), unique_connection_name()))
 {
     m_db.setDatabaseName(db_path);
 }
 
 SqliteDb::~SqliteDb()
 {
-    if (!m_db.isOpen())
+    if (!m_db.isValid())
         return;
 
-    m_db.rollback();
+    // the queries have to be freed before the connection
+    m_statements.clear();
+
+    if (m_db.isOpen())
+        m_db.rollback();
 
     const auto connection = m_db.connectionName();
     m_db = QSqlDatabase();
@@ -42,3 +56,20 @@ bool SqliteDb::hasTable(const QString& table_name)
 {
     return m_db.tables().contains(table_name);
 }
+
+bool SqliteDb::enableWal()
+{
+    QSqlQuery query(m_db);
+    return query.exec(QStringLiteral("PRAGMA journal_mode=WAL;"))
+        && query.exec(QStringLiteral("PRAGMA synchronous=NORMAL;"));
+}
+
+QSqlQuery& SqliteDb::prepared(const QString& sql)
+{
+    auto it = m_statements.find(sql);
+    if (it == m_statements.end()) {
+        it = m_statements.insert(sql, QSqlQuery(m_db));
+        it->prepare(sql);
+    }
+    return *it;
+}
@@ -19,11 +19,16 @@
 
 #include "MoveOnly.h"
 
+#include <QHash>
 #include <QString>
 #include <QSqlDatabase>
+#include <QSqlQuery>
 
 
 // Wrapper above Qt for auto-closing and freeing the connection
+//
+// Every instance has its own connection, so they can be used on multiple
+// threads at the same time (but each of them only on the thread that created it).
 class SqliteDb {
 public:
     explicit SqliteDb(const QString& db_path);
@@ -37,7 +42,16 @@ public:
     bool commit() { return m_db.commit(); }
 
     bool hasTable(const QString& table_name);
+    /// Turns on write-ahead logging, which is faster for frequent small
+    /// writes and doesn't block readers; this setting is stored in the file
+    bool enableWal();
+
+    /// A new query on this connection
+    QSqlQuery query() const { return QSqlQuery(m_db); }
+    /// A query on this connection, prepared once and reused later
+    QSqlQuery& prepared(const QString& sql);
 
 private:
     QSqlDatabase m_db;
+    QHash<QString, QSqlQuery> m_statements;
 };
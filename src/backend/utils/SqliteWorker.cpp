@@ -0,0 +1,116 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "SqliteWorker.h"
+
+#include "Log.h"
+#include "utils/SqliteDb.h"
+
+#include <QtConcurrent/QtConcurrent>
+
+
+SqliteWorker::SqliteWorker(QString log_tag, QString db_path, OpenHook on_open, QObject* parent)
+    : QObject(parent)
+    , m_log_tag(std::move(log_tag))
+    , m_db_path(std::move(db_path))
+    , m_on_open(std::move(on_open))
+    , m_running(false)
+{
+    m_thread.setMaxThreadCount(1);
+    m_thread.setExpiryTimeout(-1);
+}
+
+SqliteWorker::~SqliteWorker()
+{
+    waitForDone();
+
+    // the connection has to be closed on the thread that opened it
+    QtConcurrent::run(&m_thread, [this]{ m_db.reset(); });
+    m_thread.waitForDone();
+}
+
+void SqliteWorker::post(Task task)
+{
+    Q_ASSERT(task);
+    QMutexLocker lock(&m_queue_guard);
+
+    m_pending_tasks.emplace_back(std::move(task));
+    if (m_running)
+        return;
+
+    m_running = true;
+    QtConcurrent::run(&m_thread, [this]{ process(); });
+}
+
+void SqliteWorker::waitForDone()
+{
+    // NOTE: QThreadPool::waitForDone would also stop the thread
+    QMutexLocker lock(&m_queue_guard);
+    while (m_running)
+        m_idle.wait(&m_queue_guard);
+}
+
+bool SqliteWorker::ensure_open()
+{
+    if (m_db)
+        return true;
+
+    std::unique_ptr<SqliteDb> db(new SqliteDb(m_db_path));
+    if (!db->open()) {
+        Log::warning(m_log_tag, LOGMSG("Could not open or create `%1`, changes will not be saved")
+            .arg(m_db_path));
+        return false;
+    }
+    if (!db->enableWal())
+        Log::warning(m_log_tag, LOGMSG("Could not enable write-ahead logging for `%1`").arg(m_db_path));
+
+    if (m_on_open && !m_on_open(*db))
+        return false;
+
+    m_db = std::move(db);
+    return true;
+}
+
+void SqliteWorker::process()
+{
+    emit started();
+
+    std::vector<Task> tasks;
+    while (true) {
+        {
+            QMutexLocker lock(&m_queue_guard);
+            tasks.clear();
+            tasks.swap(m_pending_tasks);
+            if (tasks.empty()) {
+                m_running = false;
+                m_idle.wakeAll();
+                break;
+            }
+        }
+
+        if (!ensure_open())
+            continue;
+
+        m_db->startTransaction();
+        for (const Task& task : tasks)
+            task(*m_db);
+        m_db->commit();
+    }
+
+    emit finished();
+}
@@ -0,0 +1,77 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class SqliteDb;
+
+
+// A long-lived database connection on a dedicated thread
+//
+// The connection is opened when the first task arrives, and is kept (along
+// with its prepared statements) until the worker is destroyed. Tasks are
+// executed in the order they were posted; the tasks posted while the worker
+// is busy are collected and executed together in a single transaction.
+class SqliteWorker : public QObject {
+    Q_OBJECT
+
+public:
+    using Task = std::function<void(SqliteDb&)>;
+    using OpenHook = std::function<bool(SqliteDb&)>;
+
+    /// The open hook is called after connecting, and can be used to set up
+    /// the schema; if it fails, the connection is closed and the pending
+    /// tasks are dropped
+    explicit SqliteWorker(QString log_tag, QString db_path, OpenHook on_open = nullptr, QObject* parent = nullptr);
+    ~SqliteWorker() override;
+
+    void post(Task);
+    /// Blocks until all posted tasks are finished
+    void waitForDone();
+
+signals:
+    // emitted on the worker thread, when it starts or stops working
+    void started();
+    void finished();
+
+private:
+    const QString m_log_tag;
+    const QString m_db_path;
+    const OpenHook m_on_open;
+
+    // a single thread that doesn't expire, as the connection belongs to it
+    QThreadPool m_thread;
+    std::unique_ptr<SqliteDb> m_db;
+
+    QMutex m_queue_guard;
+    QWaitCondition m_idle;
+    std::vector<Task> m_pending_tasks;
+    bool m_running;
+
+    void process();
+    bool ensure_open();
+};
@@ -1,26 +1,35 @@
 HEADERS += \
+    $$PWD/Bitset.h \
     $$PWD/CommandTokenizer.h \
     $$PWD/DiskCachedNAM.h \
     $$PWD/FakeQKeyEvent.h \
     $$PWD/FolderListModel.h \
     $$PWD/HashMap.h \
+    $$PWD/IoHints.h \
     $$PWD/KeySequenceTools.h \
+    $$PWD/MemoryUsage.h \
     $$PWD/MoveOnly.h \
+    $$PWD/MpscRingBuffer.h \
     $$PWD/NoCopyNoMove.h \
     $$PWD/PathCheck.h \
     $$PWD/QmlHelpers.h \
     $$PWD/SqliteDb.h \
+    $$PWD/SqliteWorker.h \
     $$PWD/StdHelpers.h \
     $$PWD/StdStringHelpers.h \
     $$PWD/StrBoolConverter.h \
 
 SOURCES += \
+    $$PWD/Bitset.cpp \
     $$PWD/CommandTokenizer.cpp \
     $$PWD/DiskCachedNAM.cpp \
     $$PWD/FakeQKeyEvent.cpp \
     $$PWD/FolderListModel.cpp \
+    $$PWD/IoHints.cpp \
     $$PWD/KeySequenceTools.cpp \
+    $$PWD/MemoryUsage.cpp \
     $$PWD/PathCheck.cpp \
     $$PWD/SqliteDb.cpp \
+    $$PWD/SqliteWorker.cpp \
     $$PWD/StdStringHelpers.cpp \
     $$PWD/StrBoolConverter.cpp \
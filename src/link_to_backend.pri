@@ -12,6 +12,8 @@ win32:CONFIG(release, debug|release): LIBS += "-L$${TOP_BUILDDIR}/src/backend/re
 else:win32:CONFIG(debug, debug|release): LIBS += "-L$${TOP_BUILDDIR}/src/backend/debug/" -lbackend
 else:unix: LIBS += "-L$${TOP_BUILDDIR}/src/backend/" -lbackend
 
+!isEmpty(LOG_MIN_LEVEL): DEFINES *= PEGASUS_LOG_MIN_LEVEL=$${LOG_MIN_LEVEL}
+
 INCLUDEPATH += "$${TOP_SRCDIR}/src" "$${TOP_SRCDIR}/src/backend" "$${TOP_SRCDIR}/thirdparty"
 DEPENDPATH += "$${TOP_SRCDIR}/src/backend" "$${TOP_SRCDIR}/thirdparty"
 
@@ -38,5 +38,9 @@ unix:!macx {
 else: message("Using Qt gamepad backend")
 
 
+# Log messages removed at compile time
+!isEmpty(LOG_MIN_LEVEL): message("Minimum log level: $${LOG_MIN_LEVEL} (0: info, 1: warning, 2: error)")
+
+
 # Print Git revision
 message("Git revision: '$${GIT_REVISION}'")
@@ -3,6 +3,8 @@ TEMPLATE = subdirs
 SUBDIRS += \
     api \
     configfile \
+    imggen \
+    log \
     model \
     processlauncher \
     providers \
@@ -0,0 +1,127 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "Log.h"
+#include "imggen/BlurhashEncoder.h"
+#include "imggen/BlurhashGenerator.h"
+#include "imggen/BlurhashProvider.h"
+#include "model/gaming/Assets.h"
+#include "model/gaming/Game.h"
+#include "types/AssetType.h"
+
+
+class test_Blurhash : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {
+        Log::init_qttest();
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+    void encode_solid();
+    void encode_invalid();
+    void generate();
+};
+
+void test_Blurhash::encode_solid()
+{
+    QImage image(16, 16, QImage::Format_RGB888);
+    image.fill(QColor(200, 100, 50));
+
+    const QString hash = imggen::encode_blurhash(image, 4, 3);
+    QCOMPARE(hash.length(), 4 + 2 * 4 * 3);
+
+    BlurhashProvider provider;
+    const QImage decoded = provider.requestImage(hash, nullptr, QSize(8, 8));
+    QCOMPARE(decoded.size(), QSize(8, 8));
+
+    for (int y = 0; y < decoded.height(); y++) {
+        for (int x = 0; x < decoded.width(); x++) {
+            const QColor color = decoded.pixelColor(x, y);
+            QVERIFY(qAbs(color.red() - 200) <= 2);
+            QVERIFY(qAbs(color.green() - 100) <= 2);
+            QVERIFY(qAbs(color.blue() - 50) <= 2);
+        }
+    }
+}
+
+void test_Blurhash::encode_invalid()
+{
+    QCOMPARE(imggen::encode_blurhash(QImage(), 4, 3), QString());
+
+    QImage image(4, 4, QImage::Format_RGB888);
+    image.fill(Qt::black);
+    QCOMPARE(imggen::encode_blurhash(image, 0, 3), QString());
+    QCOMPARE(imggen::encode_blurhash(image, 4, 10), QString());
+}
+
+void test_Blurhash::generate()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    QVERIFY(QDir(tmp_dir.path()).mkdir(QStringLiteral("media")));
+
+    QImage image(64, 48, QImage::Format_RGB888);
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++)
+            image.setPixelColor(x, y, QColor(x * 4, y * 5, 128));
+    }
+    const QString image_path = tmp_dir.filePath(QStringLiteral("image.png"));
+    const QString lazy_image_path = tmp_dir.filePath(QStringLiteral("media/boxFront.png"));
+    QVERIFY(image.save(image_path));
+    QVERIFY(image.save(lazy_image_path));
+
+    model::Game direct_game(QStringLiteral("direct"));
+    direct_game.assetsMut().add_file(AssetType::BOX_FRONT, image_path);
+    model::Game lazy_game(QStringLiteral("lazy"));
+    lazy_game.assetsMut().add_lazy_dir(tmp_dir.filePath(QStringLiteral("media")));
+    model::Game empty_game(QStringLiteral("empty"));
+
+    const QVector<model::Game*> games { &direct_game, &lazy_game, &empty_game };
+
+    QString first_hash;
+    for (int run = 0; run < 2; run++) {
+        BlurhashGenerator generator;
+        QSignalSpy finished(&generator, &BlurhashGenerator::finished);
+        QSignalSpy changed(&direct_game.assetsMut(), &model::Assets::blurhashChanged);
+        QVERIFY(finished.isValid() && changed.isValid());
+
+        generator.start(games);
+        QVERIFY(finished.wait());
+
+        const QString hash = direct_game.assets().boxFrontBlurhash();
+        QCOMPARE(hash.length(), 4 + 2 * 4 * 3);
+        QCOMPARE(lazy_game.assets().boxFrontBlurhash(), hash);
+        QVERIFY(!empty_game.hasAssets());
+
+        // the second run reads the cache, and gives the same result
+        if (run == 0) {
+            QCOMPARE(changed.count(), 1);
+            first_hash = hash;
+            direct_game.assetsMut().set_box_front_blurhash(QString());
+        }
+        QCOMPARE(hash, first_hash);
+    }
+}
+
+
+QTEST_MAIN(test_Blurhash)
+#include "test_Blurhash.moc"
@@ -0,0 +1,146 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "Log.h"
+#include "imggen/ThumbnailCache.h"
+
+#include <QDirIterator>
+
+
+namespace {
+int count_files(const QString& dir_path)
+{
+    int count = 0;
+    QDirIterator dir_it(dir_path, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (dir_it.hasNext()) {
+        dir_it.next();
+        count++;
+    }
+    return count;
+}
+} // namespace
+
+
+class test_ThumbnailCache : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void scaled();
+    void scaled_data();
+    void from_disk();
+    void missing_file();
+    void prune();
+
+private:
+    QTemporaryDir m_tmp_dir;
+    QString m_image_path;
+    QString cache_dir() const { return m_tmp_dir.filePath(QStringLiteral("cache")); }
+};
+
+void test_ThumbnailCache::initTestCase()
+{
+    Log::init_qttest();
+
+    QVERIFY(m_tmp_dir.isValid());
+    m_image_path = m_tmp_dir.filePath(QStringLiteral("image.png"));
+
+    QImage image(400, 200, QImage::Format_RGB888);
+    image.fill(QColor(10, 20, 30));
+    QVERIFY(image.save(m_image_path));
+}
+
+void test_ThumbnailCache::scaled_data()
+{
+    QTest::addColumn<QSize>("requested");
+    QTest::addColumn<QSize>("expected");
+
+    QTest::newRow("fit") << QSize(100, 100) << QSize(100, 50);
+    QTest::newRow("width only") << QSize(50, 0) << QSize(50, 25);
+    QTest::newRow("height only") << QSize(0, 20) << QSize(40, 20);
+    QTest::newRow("no size") << QSize() << QSize(400, 200);
+    QTest::newRow("no upscale") << QSize(800, 800) << QSize(400, 200);
+}
+
+void test_ThumbnailCache::scaled()
+{
+    QFETCH(QSize, requested);
+    QFETCH(QSize, expected);
+
+    ThumbnailCache cache(cache_dir());
+    const QImage image = cache.get(m_image_path, requested);
+    QCOMPARE(image.size(), expected);
+
+    // repeated requests are served from memory
+    QCOMPARE(cache.get(m_image_path, requested).cacheKey(), image.cacheKey());
+}
+
+void test_ThumbnailCache::from_disk()
+{
+    const QString disk_dir = m_tmp_dir.filePath(QStringLiteral("from_disk"));
+    const QSize requested(64, 64);
+    {
+        ThumbnailCache cache(disk_dir);
+        QCOMPARE(cache.get(m_image_path, requested).size(), QSize(64, 32));
+    }
+
+    QDirIterator dir_it(disk_dir, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    QVERIFY(dir_it.hasNext());
+    const QString thumb_path = dir_it.next();
+    QVERIFY(!dir_it.hasNext());
+
+    // replace the stored thumbnail, to see where the result comes from
+    QImage replacement(64, 32, QImage::Format_RGB888);
+    replacement.fill(Qt::red);
+    QVERIFY(replacement.save(thumb_path, "PNG"));
+
+    ThumbnailCache cache(disk_dir);
+    const QImage image = cache.get(m_image_path, requested);
+    QCOMPARE(image.size(), QSize(64, 32));
+    QCOMPARE(image.pixelColor(10, 10), QColor(Qt::red));
+}
+
+void test_ThumbnailCache::missing_file()
+{
+    ThumbnailCache cache(cache_dir());
+
+    QString error;
+    QVERIFY(cache.get(m_tmp_dir.filePath(QStringLiteral("nonexistent.png")), QSize(10, 10), &error).isNull());
+    QVERIFY(!error.isEmpty());
+}
+
+void test_ThumbnailCache::prune()
+{
+    ThumbnailCache cache(cache_dir());
+    QVERIFY(!cache.get(m_image_path, QSize(32, 32)).isNull());
+    QVERIFY(count_files(cache_dir()) > 0);
+
+    cache.prune_disk(1024 * 1024);
+    QVERIFY(count_files(cache_dir()) > 0);
+
+    QTest::ignoreMessage(QtInfoMsg, QRegularExpression("Removed \\d+ old thumbnails from the cache"));
+    cache.prune_disk(0);
+    QCOMPARE(count_files(cache_dir()), 0);
+}
+
+
+QTEST_MAIN(test_ThumbnailCache)
+#include "test_ThumbnailCache.moc"
@@ -0,0 +1,139 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest/QtTest>
+
+#include "Log.h"
+
+
+namespace {
+class CountingSink : public LogSink {
+public:
+    void info(qint64, const QString& msg) override { messages.append(msg); }
+    void warning(qint64, const QString& msg) override { messages.append(msg); }
+    void error(qint64, const QString& msg) override { messages.append(msg); }
+
+    QStringList messages;
+};
+} // namespace
+
+
+class test_Log : public QObject {
+    Q_OBJECT
+
+private:
+    CountingSink* m_sink = nullptr;
+
+private slots:
+    void initTestCase() {
+        Log::init_qttest();
+
+        m_sink = new CountingSink();
+        Log::add_sink(std::unique_ptr<LogSink>(m_sink));
+    }
+    void init() {
+        m_sink->messages.clear();
+    }
+    void cleanup() {
+        Log::setFilter(QString());
+    }
+
+    void default_filter();
+    void global_level();
+    void tag_level();
+    void invalid_rules();
+    void lazy_message();
+};
+
+void test_Log::default_filter()
+{
+    QVERIFY(Log::setFilter(QString()));
+
+    QVERIFY(Log::isEnabled(LogLevel::INFO));
+    QVERIFY(Log::isEnabled(LogLevel::WARNING, QStringLiteral("Test")));
+    QVERIFY(Log::isEnabled(LogLevel::ERR));
+}
+
+void test_Log::global_level()
+{
+    QVERIFY(Log::setFilter(QStringLiteral("warning")));
+
+    QVERIFY(!Log::isEnabled(LogLevel::INFO));
+    QVERIFY(!Log::isEnabled(LogLevel::INFO, QStringLiteral("Test")));
+    QVERIFY(Log::isEnabled(LogLevel::WARNING));
+    QVERIFY(Log::isEnabled(LogLevel::ERR, QStringLiteral("Test")));
+
+    // filtered messages should not reach the sinks
+    Log::info(QStringLiteral("Test"), LOGMSG("dropped"));
+    QTest::ignoreMessage(QtWarningMsg, "Test: kept");
+    Log::warning(QStringLiteral("Test"), LOGMSG("kept"));
+    QCOMPARE(m_sink->messages, QStringList({ QStringLiteral("Test: kept") }));
+}
+
+void test_Log::tag_level()
+{
+    QVERIFY(Log::setFilter(QStringLiteral(" error , Pegasus=info,Logiqx = warning")));
+
+    QVERIFY(!Log::isEnabled(LogLevel::WARNING));
+    QVERIFY(!Log::isEnabled(LogLevel::WARNING, QStringLiteral("Other")));
+    QVERIFY(Log::isEnabled(LogLevel::INFO, QStringLiteral("Pegasus")));
+    QVERIFY(Log::isEnabled(LogLevel::INFO, QStringLiteral("pegasus")));
+    QVERIFY(!Log::isEnabled(LogLevel::INFO, QStringLiteral("Logiqx")));
+    QVERIFY(Log::isEnabled(LogLevel::WARNING, QStringLiteral("Logiqx")));
+}
+
+void test_Log::invalid_rules()
+{
+    QTest::ignoreMessage(QtWarningMsg, "Invalid log filter rule `verbose`, ignored");
+    QTest::ignoreMessage(QtWarningMsg, "Invalid log filter rule `=info`, ignored");
+    QVERIFY(!Log::setFilter(QStringLiteral("verbose,warning,=info")));
+
+    QVERIFY(!Log::isEnabled(LogLevel::INFO));
+    QVERIFY(Log::isEnabled(LogLevel::WARNING));
+    QCOMPARE(m_sink->messages.count(), 2);
+
+    // the mistakes are reported even if the new filter would hide them
+    Log::setFilter(QString());
+    m_sink->messages.clear();
+    QTest::ignoreMessage(QtWarningMsg, "Invalid log filter rule `verbose`, ignored");
+    QVERIFY(!Log::setFilter(QStringLiteral("error,verbose")));
+    QCOMPARE(m_sink->messages, QStringList({ QStringLiteral("Invalid log filter rule `verbose`, ignored") }));
+}
+
+void test_Log::lazy_message()
+{
+    int evaluated = 0;
+    const auto make_message = [&evaluated]{
+        evaluated++;
+        return LOGMSG("message");
+    };
+
+    QVERIFY(Log::setFilter(QStringLiteral("info,Quiet=error")));
+
+    LOG_INFO(QStringLiteral("Quiet"), make_message());
+    LOG_WARNING(QStringLiteral("Quiet"), make_message());
+    QCOMPARE(evaluated, 0);
+
+    QTest::ignoreMessage(QtInfoMsg, "Loud: message");
+    LOG_INFO(QStringLiteral("Loud"), make_message());
+    QCOMPARE(evaluated, 1);
+    QCOMPARE(m_sink->messages, QStringList({ QStringLiteral("Loud: message") }));
+}
+
+
+QTEST_MAIN(test_Log)
+#include "test_Log.moc"
@@ -0,0 +1,156 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "model/gaming/AssetPrefetcher.h"
+#include "model/gaming/Assets.h"
+#include "model/gaming/Game.h"
+#include "model/gaming/GameListModel.h"
+
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+Q_DECLARE_METATYPE(std::vector<int>)
+
+
+namespace {
+std::vector<int> range(int first, int last)
+{
+    std::vector<int> out;
+    for (int i = first; i <= last; i++)
+        out.push_back(i);
+    return out;
+}
+
+#ifdef Q_OS_UNIX
+// Opening a FIFO for reading blocks until there is a writer, and a non-blocking
+// writer can only be opened while there is a reader. This makes it possible to
+// tell when the background thread tries to load a file, and to hold it there.
+bool has_reader(const QString& path)
+{
+    const int fd = ::open(QFile::encodeName(path).constData(), O_WRONLY | O_NONBLOCK);
+    if (fd < 0)
+        return false;
+
+    // this also lets the reader continue
+    ::close(fd);
+    return true;
+}
+#endif
+} // namespace
+
+
+class test_AssetPrefetcher : public QObject {
+    Q_OBJECT
+
+private slots:
+    void rowsToLoad_data();
+    void rowsToLoad();
+    void cancelOnFocusChange();
+};
+
+void test_AssetPrefetcher::rowsToLoad_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("index");
+    QTest::addColumn<qreal>("velocity");
+    QTest::addColumn<int>("row_cnt");
+    QTest::addColumn<std::vector<int>>("expected");
+
+    QTest::newRow("idle") << 4 << 5 << 0.0 << 10 << std::vector<int>({ 6, 4, 7, 3 });
+    QTest::newRow("idle, first row") << 4 << 0 << 0.0 << 10 << range(1, 4);
+    QTest::newRow("idle, last row") << 4 << 9 << 0.0 << 10 << std::vector<int>({ 8, 7, 6, 5 });
+    QTest::newRow("idle, short list") << 4 << 1 << 0.0 << 3 << std::vector<int>({ 2, 0 });
+    QTest::newRow("forward") << 4 << 5 << 1.0 << 20 << range(6, 9);
+    QTest::newRow("backward") << 4 << 5 << -1.0 << 20 << std::vector<int>({ 4, 3, 2, 1 });
+    QTest::newRow("fast") << 4 << 0 << 10.0 << 100 << range(1, 10);
+    QTest::newRow("very fast") << 4 << 0 << 1000.0 << 100 << range(1, 16);
+    QTest::newRow("forward, end of list") << 4 << 8 << 1.0 << 10 << std::vector<int>({ 9 });
+    QTest::newRow("backward, start of list") << 4 << 0 << -2.0 << 10 << std::vector<int>();
+    QTest::newRow("single row") << 4 << 0 << 0.0 << 1 << std::vector<int>();
+    QTest::newRow("zero count") << 0 << 5 << 0.0 << 10 << std::vector<int>();
+    QTest::newRow("zero count, moving") << 0 << 5 << 10.0 << 10 << std::vector<int>();
+}
+
+void test_AssetPrefetcher::rowsToLoad()
+{
+    QFETCH(int, count);
+    QFETCH(int, index);
+    QFETCH(qreal, velocity);
+    QFETCH(int, row_cnt);
+    QFETCH(std::vector<int>, expected);
+
+    model::AssetPrefetcher prefetcher;
+    prefetcher.setCount(count);
+    QCOMPARE(prefetcher.rowsToLoad(index, velocity, row_cnt), expected);
+}
+
+void test_AssetPrefetcher::cancelOnFocusChange()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("Requires named pipes");
+#else
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    const QString path_a = tmp_dir.filePath(QStringLiteral("a.png"));
+    const QString path_b = tmp_dir.filePath(QStringLiteral("b.png"));
+    QCOMPARE(::mkfifo(QFile::encodeName(path_a).constData(), 0600), 0);
+    QCOMPARE(::mkfifo(QFile::encodeName(path_b).constData(), 0600), 0);
+
+    model::Game game_0("game 0");
+    model::Game game_a("game a");
+    model::Game game_b("game b");
+    model::Game game_3("game 3");
+    game_a.assetsMut().add_file(AssetType::BOX_FRONT, path_a);
+    game_b.assetsMut().add_file(AssetType::BOX_FRONT, path_b);
+
+    model::GameListModel games;
+    games.append({ &game_0, &game_a, &game_b, &game_3 });
+
+    model::AssetPrefetcher prefetcher;
+    prefetcher.setModel(&games);
+    prefetcher.setCount(2);
+
+    // without a focus change, both files are loaded
+    prefetcher.setFocus(0, 1.0);
+    QTRY_VERIFY(has_reader(path_a));
+    QTRY_VERIFY(has_reader(path_b));
+
+    // moving the focus while the first file is loading;
+    // there is nothing to load after the end of the list
+    prefetcher.setFocus(0, 1.0);
+    QTest::qWait(100);
+    prefetcher.setFocus(3, 1.0);
+
+    for (int i = 0; i < 10; i++) {
+        has_reader(path_a);
+        QTest::qWait(20);
+        QVERIFY(!has_reader(path_b));
+    }
+#endif
+}
+
+
+QTEST_MAIN(test_AssetPrefetcher)
+#include "test_AssetPrefetcher.moc"
@@ -18,7 +18,9 @@
 #include <QtTest/QtTest>
 
 #include "model/gaming/Game.h"
+#include "model/gaming/GameEvents.h"
 #include "model/gaming/GameFile.h"
+#include "model/gaming/GameStore.h"
 
 #include <array>
 
@@ -38,6 +40,10 @@ private slots:
     void launchMulti();
 
     void sorting();
+
+    void sharedStore();
+    void moveToStore();
+    void objectOnDemand();
 };
 
 void testStrAndList(const std::function<void(model::Game&, const QString&)>& fn_add,
@@ -101,9 +107,13 @@ void test_Game::launchSingle()
 
     QSignalSpy spy_launch(game.filesConst().first(), &model::GameFile::launchRequested);
     QVERIFY(spy_launch.isValid());
+    QSignalSpy spy_event(&model::GameEvents::instance(), &model::GameEvents::launchRequested);
+    QVERIFY(spy_event.isValid());
 
     QMetaObject::invokeMethod(&game, "launch");
     QVERIFY(spy_launch.count() == 1 || spy_launch.wait());
+    QCOMPARE(spy_event.count(), 1);
+    QCOMPARE(spy_event.first().first().value<model::GameFile*>(), game.filesConst().first());
 }
 
 void test_Game::launchMulti()
@@ -116,9 +126,13 @@ void test_Game::launchMulti()
 
     QSignalSpy spy_launch(&game, &model::Game::launchFileSelectorRequested);
     QVERIFY(spy_launch.isValid());
+    QSignalSpy spy_event(&model::GameEvents::instance(), &model::GameEvents::fileSelectorRequested);
+    QVERIFY(spy_event.isValid());
 
     QMetaObject::invokeMethod(&game, "launch");
     QVERIFY(spy_launch.count() == 1 || spy_launch.wait());
+    QCOMPARE(spy_event.count(), 1);
+    QCOMPARE(spy_event.first().first().value<model::Game*>(), &game);
 }
 
 void test_Game::sorting()
@@ -147,6 +161,73 @@ void test_Game::sorting()
     QCOMPARE(games.at(3)->title(), QStringLiteral("Game IX"));
 }
 
+void test_Game::sharedStore()
+{
+    const auto store = std::make_shared<model::GameStore>();
+    model::Game game_a(store);
+    model::Game game_b(store);
+    game_a.setTitle("a").setPlayerCount(2);
+    game_b.setTitle("b").setFavorite(true);
+
+    QCOMPARE(store->size(), static_cast<size_t>(2));
+    QCOMPARE(store->games.at(game_a.storeRow()), &game_a);
+    QCOMPARE(store->games.at(game_b.storeRow()), &game_b);
+
+    QCOMPARE(game_a.property("title").toString(), QStringLiteral("a"));
+    QCOMPARE(game_a.property("sortBy").toString(), QStringLiteral("a"));
+    QCOMPARE(game_a.property("players").toInt(), 2);
+    QCOMPARE(game_a.property("favorite").toBool(), false);
+    QCOMPARE(game_b.property("title").toString(), QStringLiteral("b"));
+    QCOMPARE(game_b.property("players").toInt(), 1);
+    QCOMPARE(game_b.property("favorite").toBool(), true);
+}
+
+void test_Game::moveToStore()
+{
+    model::Game game("test");
+    game.developerList().append("dev");
+    game.setFiles({ new model::GameFile(QFileInfo("test"), game) });
+
+    const auto store = std::make_shared<model::GameStore>();
+    store->reserve(1);
+    game.moveToStore(store);
+
+    QCOMPARE(&game.store(), store.get());
+    QCOMPARE(game.storeRow(), static_cast<size_t>(0));
+    QCOMPARE(store->games.front(), &game);
+    QCOMPARE(game.property("title").toString(), QStringLiteral("test"));
+    QCOMPARE(game.property("developer").toString(), QStringLiteral("dev"));
+
+    // the file model is created on demand
+    auto* const files = game.property("files").value<QQmlObjectListModelBase*>();
+    QVERIFY(files);
+    QCOMPARE(files->count(), 1);
+}
+
+void test_Game::objectOnDemand()
+{
+    const auto store = std::make_shared<model::GameStore>();
+    store->set_object_parent(this);
+
+    auto* const game = new model::Game(store);
+    game->setTitle("test");
+    auto* const file = new model::GameFile(QFileInfo("test"), *game);
+    game->setFiles({ file });
+
+    // like at the end of scanning, the file outlives the object of its game
+    file->setParent(this);
+    delete game;
+    QVERIFY(!store->games.front());
+
+    model::Game* const new_game = store->game(0);
+    QVERIFY(new_game);
+    QCOMPARE(new_game->parent(), this);
+    QCOMPARE(store->game(0), new_game);
+    QCOMPARE(new_game->property("title").toString(), QStringLiteral("test"));
+    QCOMPARE(new_game->filesConst().size(), 1);
+    QCOMPARE(file->parentGame(), new_game);
+}
+
 
 QTEST_MAIN(test_Game)
 #include "test_Game.moc"
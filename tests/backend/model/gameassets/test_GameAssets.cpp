@@ -27,6 +27,10 @@ class test_GameAssets : public QObject
 private slots:
     void setSingle();
     void appendMulti();
+    void addFile();
+    void duplicates();
+    void duplicatesFileUri();
+    void lazyDir();
 };
 
 void test_GameAssets::setSingle()
@@ -47,6 +51,78 @@ void test_GameAssets::appendMulti()
     QCOMPARE(assets.property("videoList").toStringList().constLast(), QLatin1String("file:///dummy2"));
 }
 
+void test_GameAssets::addFile()
+{
+    model::Assets assets(this);
+    assets.add_file(AssetType::BOX_FRONT, QStringLiteral("/some dir/dummy.png"));
+    assets.add_file(AssetType::SCREENSHOT, QStringLiteral("/dummy1.png"));
+    assets.add_uri(AssetType::SCREENSHOT, QStringLiteral("http://example.com/dummy2.png"));
+
+    QCOMPARE(assets.property("boxFront").toString(), QLatin1String("file:///some%20dir/dummy.png"));
+    QCOMPARE(assets.property("screenshotList").toStringList(), QStringList({
+        QStringLiteral("file:///dummy1.png"),
+        QStringLiteral("http://example.com/dummy2.png"),
+    }));
+
+    // adding after the first read
+    assets.add_file(AssetType::SCREENSHOT, QStringLiteral("/dummy3.png"));
+    QCOMPARE(assets.property("screenshotList").toStringList().count(), 3);
+    QCOMPARE(assets.property("screenshotList").toStringList().constLast(), QLatin1String("file:///dummy3.png"));
+    QCOMPARE(assets.property("boxFront").toString(), QLatin1String("file:///some%20dir/dummy.png"));
+}
+
+void test_GameAssets::duplicates()
+{
+    model::Assets assets(this);
+    assets.add_file(AssetType::VIDEO, QStringLiteral("/dummy1"));
+    assets.add_file(AssetType::VIDEO, QStringLiteral("/dummy2"));
+    assets.add_file(AssetType::VIDEO, QStringLiteral("/dummy1"));
+    assets.add_file(AssetType::BOX_FRONT, QStringLiteral("/dummy1"));
+
+    QCOMPARE(assets.property("videoList").toStringList().count(), 2);
+    QCOMPARE(assets.property("boxFrontList").toStringList().count(), 1);
+    QCOMPARE(assets.property("logoList").toStringList().count(), 0);
+}
+
+void test_GameAssets::duplicatesFileUri()
+{
+    model::Assets assets(this);
+    assets.add_file(AssetType::BOX_FRONT, QStringLiteral("/some dir/dummy.png"));
+    assets.add_uri(AssetType::BOX_FRONT, QUrl::fromLocalFile(QStringLiteral("/some dir/dummy.png")).toString());
+    assets.add_uri(AssetType::SCREENSHOT, QUrl::fromLocalFile(QStringLiteral("/dummy1.png")).toString());
+    assets.add_file(AssetType::SCREENSHOT, QStringLiteral("/dummy1.png"));
+    assets.add_uri(AssetType::SCREENSHOT, QStringLiteral("dummy2.png"));
+    assets.add_file(AssetType::SCREENSHOT, QStringLiteral("dummy2.png"));
+
+    QCOMPARE(assets.property("boxFrontList").toStringList(), QStringList({
+        QStringLiteral("file:///some%20dir/dummy.png"),
+    }));
+    QCOMPARE(assets.property("screenshotList").toStringList().count(), 3);
+    QCOMPARE(assets.property("screenshotList").toStringList().constFirst(), QLatin1String("file:///dummy1.png"));
+}
+
+void test_GameAssets::lazyDir()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    for (const QString& name : { QStringLiteral("boxFront.png"), QStringLiteral("video.mp4"), QStringLiteral("notes.txt") }) {
+        QFile file(tmp_dir.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    model::Assets assets(this);
+    assets.add_lazy_dir(tmp_dir.path());
+    QSignalSpy spy(&assets, &model::Assets::assetsChanged);
+
+    // the first read triggers the search
+    QCOMPARE(assets.property("boxFront").toString(), QString());
+    QVERIFY(spy.wait());
+
+    QCOMPARE(assets.property("boxFront").toString(), QUrl::fromLocalFile(tmp_dir.filePath("boxFront.png")).toString());
+    QCOMPARE(assets.property("videoList").toStringList().count(), 1);
+    QCOMPARE(spy.count(), 1);
+}
+
 
 QTEST_MAIN(test_GameAssets)
 #include "test_GameAssets.moc"
@@ -0,0 +1,224 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "model/gaming/FacetIndex.h"
+#include "model/gaming/Game.h"
+#include "model/gaming/GameFacetModel.h"
+#include "model/gaming/GameFilterModel.h"
+#include "model/gaming/GameListModel.h"
+
+#include <memory>
+
+
+namespace {
+int find_entry(const model::GameFacetModel& model, const QString& facet, const QString& value)
+{
+    for (int i = 0; i < model.count(); i++) {
+        const QModelIndex idx = model.index(i);
+        if (model.data(idx, model::GameFacetModel::FacetRole).toString() == facet
+            && model.data(idx, model::GameFacetModel::ValueRole).toString() == value)
+            return i;
+    }
+    return -1;
+}
+
+int entry_count(const model::GameFacetModel& model, const QString& facet, const QString& value)
+{
+    const int row = find_entry(model, facet, value);
+    return row >= 0
+        ? model.data(model.index(row), model::GameFacetModel::CountRole).toInt()
+        : -1;
+}
+
+QStringList visible_titles(const model::GameFilterModel& model)
+{
+    QStringList out;
+    for (int i = 0; i < model.count(); i++)
+        out << model.get(i)->property("title").toString();
+    return out;
+}
+} // namespace
+
+
+class test_GameFacetModel : public QObject {
+    Q_OBJECT
+
+private:
+    model::GameListModel* m_source = nullptr;
+
+private slots:
+    void init();
+    void cleanup();
+
+    void values();
+    void selection();
+    void liveUpdate();
+    void indexFromScan();
+    void filtering();
+};
+
+void test_GameFacetModel::init()
+{
+    std::vector<model::Game*> games {
+        new model::Game("Alpha", this),
+        new model::Game("Beta", this),
+        new model::Game("Gamma", this),
+        new model::Game("Delta", this),
+    };
+    games[0]->setReleaseDate(QDate(1995, 1, 1)).setPlayerCount(2);
+    games[1]->setReleaseDate(QDate(2001, 1, 1)).setPlayerCount(1);
+    games[2]->setReleaseDate(QDate(1990, 1, 1)).setPlayerCount(6);
+    games[3]->setReleaseDate(QDate(2010, 1, 1)).setPlayerCount(2);
+    games[0]->genreList().append("Action");
+    games[2]->genreList() << "Action" << "Puzzle";
+    games[3]->genreList().append("Puzzle");
+    games[1]->setFavorite(true);
+
+    m_source = new model::GameListModel(this);
+    m_source->append(QVector<model::Game*>::fromStdVector(games));
+}
+
+void test_GameFacetModel::cleanup()
+{
+    delete m_source;
+    m_source = nullptr;
+}
+
+void test_GameFacetModel::values()
+{
+    model::GameFacetModel model;
+    model.setSourceModel(m_source);
+
+    // the index is created on demand and shared with the source
+    QVERIFY(m_source->facetIndex());
+    QCOMPARE(m_source->facetIndex()->size(), static_cast<size_t>(4));
+
+    // 2 genres, 4 player counts, 3 decades, favorite, played
+    QCOMPARE(model.count(), 11);
+    QCOMPARE(model.matchCount(), 4);
+    QVERIFY(!model.hasSelection());
+
+    QCOMPARE(entry_count(model, "genre", "Action"), 2);
+    QCOMPARE(entry_count(model, "genre", "Puzzle"), 2);
+    QCOMPARE(entry_count(model, "players", "1"), 1);
+    QCOMPARE(entry_count(model, "players", "2"), 2);
+    QCOMPARE(entry_count(model, "players", "3"), 0);
+    QCOMPARE(entry_count(model, "players", "4+"), 1);
+    QCOMPARE(entry_count(model, "decade", "1990s"), 2);
+    QCOMPARE(entry_count(model, "decade", "2000s"), 1);
+    QCOMPARE(entry_count(model, "decade", "2010s"), 1);
+    QCOMPARE(entry_count(model, "favorite", "favorite"), 1);
+    QCOMPARE(entry_count(model, "played", "played"), 0);
+}
+
+void test_GameFacetModel::selection()
+{
+    model::GameFacetModel model;
+    model.setSourceModel(m_source);
+
+    model.toggle(find_entry(model, "genre", "Action"));
+    QVERIFY(model.hasSelection());
+    QCOMPARE(model.matchCount(), 2);
+    QVERIFY(model.accepts(0));
+    QVERIFY(!model.accepts(1));
+    // values of the same facet are counted without the facet's own selection
+    QCOMPARE(entry_count(model, "genre", "Puzzle"), 2);
+    QCOMPARE(entry_count(model, "players", "1"), 0);
+    QCOMPARE(entry_count(model, "players", "2"), 1);
+    QCOMPARE(entry_count(model, "decade", "2000s"), 0);
+
+    // values of the same facet are OR-ed
+    QVERIFY(model.setData(model.index(find_entry(model, "genre", "Puzzle")), true, model::GameFacetModel::SelectedRole));
+    QCOMPARE(model.matchCount(), 3);
+
+    // different facets are AND-ed
+    model.toggle(find_entry(model, "decade", "1990s"));
+    QCOMPARE(model.matchCount(), 2);
+    QCOMPARE(entry_count(model, "genre", "Action"), 2);
+    QCOMPARE(entry_count(model, "genre", "Puzzle"), 1);
+
+    model.toggle(find_entry(model, "genre", "Action"));
+    QCOMPARE(model.matchCount(), 1);
+
+    model.clearSelection();
+    QVERIFY(!model.hasSelection());
+    QCOMPARE(model.matchCount(), 4);
+    QCOMPARE(model.data(model.index(0), model::GameFacetModel::SelectedRole).toBool(), false);
+}
+
+void test_GameFacetModel::liveUpdate()
+{
+    model::GameFacetModel model;
+    model.setSourceModel(m_source);
+    model.toggle(find_entry(model, "favorite", "favorite"));
+    QCOMPARE(model.matchCount(), 1);
+
+    QSignalSpy spy(&model, &model::GameFacetModel::matchChanged);
+    m_source->at(3)->setFavorite(true);
+    QVERIFY(spy.wait());
+    QCOMPARE(model.matchCount(), 2);
+    QCOMPARE(entry_count(model, "favorite", "favorite"), 2);
+    QCOMPARE(entry_count(model, "genre", "Puzzle"), 1);
+}
+
+void test_GameFacetModel::indexFromScan()
+{
+    // like after a scan: the model is already bound when the games
+    // and their index, built by the providers, arrive
+    model::GameListModel source;
+    model::GameFacetModel model;
+    model.setSourceModel(&source);
+    QCOMPARE(model.count(), 0);
+
+    const auto index = std::make_shared<model::FacetIndex>(m_source->rowRefs());
+    source.append(m_source->asList(), nullptr, index);
+    QVERIFY(source.facetIndex() == index);
+    QCOMPARE(entry_count(model, "favorite", "favorite"), 1);
+    QCOMPARE(entry_count(model, "played", "played"), 0);
+
+    m_source->at(2)->setFavorite(true);
+    QTRY_COMPARE(entry_count(model, "favorite", "favorite"), 2);
+    QCOMPARE(index->values(model::FacetIndex::FAVORITE).front().rows.count(), static_cast<size_t>(2));
+}
+
+void test_GameFacetModel::filtering()
+{
+    model::GameFacetModel facets;
+    facets.setSourceModel(m_source);
+
+    model::GameFilterModel model;
+    model.setSourceModel(m_source);
+    model.setFacets(&facets);
+    QCOMPARE(model.count(), 4);
+
+    facets.toggle(find_entry(facets, "genre", "Action"));
+    QCOMPARE(visible_titles(model), QStringList({ "Alpha", "Gamma" }));
+    model.setMinPlayers(3);
+    QCOMPARE(visible_titles(model), QStringList({ "Gamma" }));
+
+    facets.clearSelection();
+    QCOMPARE(visible_titles(model), QStringList({ "Gamma" }));
+    model.setMinPlayers(0);
+    QCOMPARE(model.count(), 4);
+}
+
+
+QTEST_MAIN(test_GameFacetModel)
+#include "test_GameFacetModel.moc"
@@ -0,0 +1,206 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "model/gaming/Game.h"
+#include "model/gaming/GameFilterModel.h"
+#include "model/gaming/GameListModel.h"
+
+
+namespace {
+QStringList visible_titles(const model::GameFilterModel& model)
+{
+    QStringList out;
+    for (int i = 0; i < model.count(); i++)
+        out << model.get(i)->property("title").toString();
+    return out;
+}
+} // namespace
+
+
+class test_GameFilterModel : public QObject {
+    Q_OBJECT
+
+private:
+    model::GameListModel* m_source = nullptr;
+
+private slots:
+    void init();
+    void cleanup();
+
+    void passthrough();
+    void title();
+    void combined();
+    void sorting();
+    void favoriteChange();
+    void incrementalChanges();
+};
+
+void test_GameFilterModel::init()
+{
+    std::vector<model::Game*> games {
+        new model::Game("Alpha", this),
+        new model::Game("Beta", this),
+        new model::Game("Gamma", this),
+        new model::Game("Delta", this),
+    };
+    games[0]->setReleaseDate(QDate(1995, 1, 1)).setPlayerCount(2).setRating(0.5f);
+    games[1]->setReleaseDate(QDate(2001, 1, 1)).setPlayerCount(1).setRating(0.9f);
+    games[2]->setReleaseDate(QDate(1990, 1, 1)).setPlayerCount(4).setRating(0.1f);
+    games[3]->setReleaseDate(QDate(2010, 1, 1)).setPlayerCount(2).setRating(0.7f);
+    games[0]->genreList().append("Action");
+    games[2]->genreList().append("action");
+    games[3]->genreList().append("Puzzle");
+    games[1]->setFavorite(true);
+
+    m_source = new model::GameListModel(this);
+    m_source->append(QVector<model::Game*>::fromStdVector(games));
+}
+
+void test_GameFilterModel::cleanup()
+{
+    delete m_source;
+    m_source = nullptr;
+}
+
+void test_GameFilterModel::passthrough()
+{
+    model::GameFilterModel model;
+    QCOMPARE(model.count(), 0);
+
+    model.setSourceModel(m_source);
+    QCOMPARE(visible_titles(model), QStringList({ "Alpha", "Beta", "Gamma", "Delta" }));
+    QCOMPARE(model.data(model.index(1), model::GameListModel::TitleRole).toString(), QStringLiteral("Beta"));
+    QCOMPARE(model.roleNames().value(model::GameListModel::TitleRole), QByteArray("title"));
+}
+
+void test_GameFilterModel::title()
+{
+    model::GameFilterModel model;
+    model.setSourceModel(m_source);
+
+    model.setTitleFilter("a");
+    QCOMPARE(model.count(), 4);
+    model.setTitleFilter("ta");
+    QCOMPARE(visible_titles(model), QStringList({ "Beta", "Delta" }));
+    model.setTitleFilter("elta");
+    QCOMPARE(visible_titles(model), QStringList({ "Delta" }));
+
+    // widening the search
+    model.setTitleFilter("MA");
+    QCOMPARE(visible_titles(model), QStringList({ "Gamma" }));
+    model.setTitleFilter(QString());
+    QCOMPARE(model.count(), 4);
+}
+
+void test_GameFilterModel::combined()
+{
+    model::GameFilterModel model;
+    model.setSourceModel(m_source);
+
+    model.setGenreFilter("action");
+    QCOMPARE(visible_titles(model), QStringList({ "Alpha", "Gamma" }));
+    model.setMinPlayers(3);
+    QCOMPARE(visible_titles(model), QStringList({ "Gamma" }));
+    model.setGenreFilter(QString());
+    model.setMinPlayers(0);
+
+    model.setReleaseYearMin(1995);
+    model.setReleaseYearMax(2005);
+    QCOMPARE(visible_titles(model), QStringList({ "Alpha", "Beta" }));
+
+    model.setFavoritesOnly(true);
+    QCOMPARE(visible_titles(model), QStringList({ "Beta" }));
+    QCOMPARE(model.mapToSource(0), 1);
+    QCOMPARE(model.mapFromSource(1), 0);
+    QCOMPARE(model.mapFromSource(0), -1);
+
+    model.setLastPlayedSince(QDateTime::currentDateTime().addDays(-7));
+    QCOMPARE(model.count(), 0);
+}
+
+void test_GameFilterModel::sorting()
+{
+    model::GameFilterModel model;
+    model.setSourceModel(m_source);
+
+    model.setSortKey(model::GameFilterModel::SortByTitle);
+    QCOMPARE(visible_titles(model), QStringList({ "Alpha", "Beta", "Delta", "Gamma" }));
+    model.setSortKey(model::GameFilterModel::SortByRelease);
+    QCOMPARE(visible_titles(model), QStringList({ "Gamma", "Alpha", "Beta", "Delta" }));
+    model.setSortOrder(Qt::DescendingOrder);
+    QCOMPARE(visible_titles(model), QStringList({ "Delta", "Beta", "Alpha", "Gamma" }));
+
+    // filtering keeps the order
+    model.setMinPlayers(2);
+    QCOMPARE(visible_titles(model), QStringList({ "Delta", "Alpha", "Gamma" }));
+
+    model.setSortKey(model::GameFilterModel::SortByRating);
+    model.setSortOrder(Qt::AscendingOrder);
+    QCOMPARE(visible_titles(model), QStringList({ "Gamma", "Alpha", "Delta" }));
+}
+
+void test_GameFilterModel::favoriteChange()
+{
+    model::GameFilterModel model;
+    model.setSourceModel(m_source);
+    model.setFavoritesOnly(true);
+    QCOMPARE(visible_titles(model), QStringList({ "Beta" }));
+
+    QSignalSpy spy(&model, &model::GameFilterModel::countChanged);
+    m_source->at(3)->setFavorite(true);
+    QVERIFY(spy.wait());
+    QCOMPARE(visible_titles(model), QStringList({ "Beta", "Delta" }));
+}
+
+void test_GameFilterModel::incrementalChanges()
+{
+    model::GameFilterModel model;
+    model.setSourceModel(m_source);
+
+    QSignalSpy spy_reset(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy spy_removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy spy_inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy spy_layout(&model, &QAbstractItemModel::layoutChanged);
+
+    // the current item should survive the changes
+    const QPersistentModelIndex delta_index(model.index(3));
+    QCOMPARE(delta_index.data(model::GameListModel::TitleRole).toString(), QStringLiteral("Delta"));
+
+    model.setTitleFilter("ta");
+    QCOMPARE(visible_titles(model), QStringList({ "Beta", "Delta" }));
+    QCOMPARE(spy_removed.count(), 2);
+    QCOMPARE(delta_index.row(), 1);
+
+    model.setSortOrder(Qt::DescendingOrder);
+    QCOMPARE(visible_titles(model), QStringList({ "Delta", "Beta" }));
+    QCOMPARE(spy_layout.count(), 1);
+    QCOMPARE(delta_index.row(), 0);
+
+    model.setTitleFilter("a");
+    QCOMPARE(visible_titles(model), QStringList({ "Delta", "Gamma", "Beta", "Alpha" }));
+    QCOMPARE(spy_inserted.count(), 2);
+    QCOMPARE(delta_index.row(), 0);
+
+    QCOMPARE(spy_reset.count(), 0);
+}
+
+
+QTEST_MAIN(test_GameFilterModel)
+#include "test_GameFilterModel.moc"
@@ -0,0 +1,156 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "model/gaming/Game.h"
+#include "model/gaming/GameListModel.h"
+
+
+class test_GameListModel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roles();
+    void data();
+    void append();
+    void batchedChanges();
+    void storeRows();
+};
+
+void test_GameListModel::roles()
+{
+    model::GameListModel model;
+    const QHash<int, QByteArray> roles = model.roleNames();
+
+    QCOMPARE(roles.value(model::GameListModel::ModelDataRole), QByteArray("modelData"));
+    QCOMPARE(roles.value(model::GameListModel::TitleRole), QByteArray("title"));
+    QCOMPARE(roles.value(model::GameListModel::FavoriteRole), QByteArray("favorite"));
+    QCOMPARE(roles.value(model::GameListModel::CollectionsRole), QByteArray("collections"));
+
+    // every readable game property should have a role
+    const QMetaObject& meta = model::Game::staticMetaObject;
+    for (int i = meta.propertyOffset(); i < meta.propertyCount(); i++)
+        QVERIFY2(roles.key(meta.property(i).name(), -1) >= 0, meta.property(i).name());
+}
+
+void test_GameListModel::data()
+{
+    model::Game game("test");
+    game.setPlayerCount(4).setReleaseDate(QDate(1999, 1, 2));
+    game.genreList().append({ "a", "b" });
+
+    model::GameListModel model;
+    model.append({ &game });
+
+    const QModelIndex idx = model.index(0);
+    QCOMPARE(model.data(idx, model::GameListModel::ModelDataRole).value<QObject*>(), &game);
+    QCOMPARE(model.data(idx, model::GameListModel::TitleRole).toString(), QStringLiteral("test"));
+    QCOMPARE(model.data(idx, model::GameListModel::PlayersRole).toInt(), 4);
+    QCOMPARE(model.data(idx, model::GameListModel::ReleaseYearRole).toInt(), 1999);
+    QCOMPARE(model.data(idx, model::GameListModel::GenreRole).toString(), QStringLiteral("a, b"));
+    QVERIFY(!model.data(idx, Qt::DisplayRole).isValid());
+    QVERIFY(!model.data(model.index(1), model::GameListModel::TitleRole).isValid());
+
+    QVERIFY(model.setData(idx, true, model::GameListModel::FavoriteRole));
+    QCOMPARE(game.isFavorite(), true);
+}
+
+void test_GameListModel::append()
+{
+    model::GameListModel model;
+    QSignalSpy spy_insert(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy spy_count(&model, &model::GameListModel::countChanged);
+
+    model.append({
+        new model::Game("a", this),
+        new model::Game("b", this),
+        new model::Game("c", this),
+    });
+
+    // one insert for the whole batch
+    QCOMPARE(spy_insert.count(), 1);
+    QCOMPARE(spy_insert.first().at(1).toInt(), 0);
+    QCOMPARE(spy_insert.first().at(2).toInt(), 2);
+    QCOMPARE(spy_count.count(), 1);
+
+    QCOMPARE(model.count(), 3);
+    QCOMPARE(model.get(1)->property("title").toString(), QStringLiteral("b"));
+    QCOMPARE(model.indexOf(model.get(2)), 2);
+    QCOMPARE(model.indexOf(this), -1);
+    QCOMPARE(model.toVarArray().count(), 3);
+}
+
+void test_GameListModel::batchedChanges()
+{
+    std::vector<model::Game*> games;
+    for (int i = 0; i < 5; i++)
+        games.emplace_back(new model::Game(QString::number(i), this));
+
+    model::GameListModel model;
+    model.append(QVector<model::Game*>::fromStdVector(games));
+    QSignalSpy spy(&model, &QAbstractItemModel::dataChanged);
+
+    games.at(3)->setFavorite(true);
+    games.at(1)->setFavorite(true);
+    QCOMPARE(spy.count(), 0);
+
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.first().at(0).toModelIndex().row(), 1);
+    QCOMPARE(spy.first().at(1).toModelIndex().row(), 3);
+    QCOMPARE(spy.first().at(2).value<QVector<int>>(), QVector<int>({ model::GameListModel::FavoriteRole }));
+}
+
+void test_GameListModel::storeRows()
+{
+    const auto store = std::make_shared<model::GameStore>();
+    store->set_object_parent(this);
+    {
+        model::Game game_a(store);
+        model::Game game_b(store);
+        game_a.setTitle("a");
+        game_b.setTitle("b");
+    }
+
+    model::GameListModel model;
+    model.append(store);
+    QCOMPARE(model.count(), 2);
+    QCOMPARE(model.data(model.index(1), model::GameListModel::TitleRole).toString(), QStringLiteral("b"));
+
+    // the objects are only created when asked for
+    QVERIFY(!store->games.at(0));
+    QVERIFY(!store->games.at(1));
+
+    auto* const game = qobject_cast<model::Game*>(model.get(1));
+    QVERIFY(game);
+    QCOMPARE(game->title(), QStringLiteral("b"));
+    QCOMPARE(model.data(model.index(1), model::GameListModel::ModelDataRole).value<QObject*>(), game);
+    QCOMPARE(model.indexOf(game), 1);
+    QVERIFY(!store->games.at(0));
+
+    QSignalSpy spy(&model, &QAbstractItemModel::dataChanged);
+    game->setFavorite(true);
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.first().at(0).toModelIndex().row(), 1);
+    QCOMPARE(model.data(model.index(1), model::GameListModel::FavoriteRole).toBool(), true);
+}
+
+
+QTEST_MAIN(test_GameListModel)
+#include "test_GameListModel.moc"
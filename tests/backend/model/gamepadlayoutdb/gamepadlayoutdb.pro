@@ -0,0 +1,5 @@
+TARGET = test_GamepadLayoutDb
+SOURCES = $${TARGET}.cpp
+RESOURCES += data.qrc
+
+include($${TOP_SRCDIR}/tests/cxxtest_common.pri)
@@ -0,0 +1,150 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include <QtTest/QtTest>
+
+#include "model/internal/GamepadLayoutDb.h"
+
+#include <algorithm>
+
+
+namespace {
+QByteArray read_file(const QString& path)
+{
+    QFile file(path);
+    file.open(QFile::ReadOnly);
+    return file.readAll();
+}
+} // namespace
+
+
+class test_GamepadLayoutDb : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void everyLineFound();
+    void everyLineFound_data();
+    void caseInsensitive();
+    void special();
+    void otherPlatform();
+};
+
+void test_GamepadLayoutDb::everyLineFound_data()
+{
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<QByteArray>("platform");
+
+    const QStringList files {
+        QStringLiteral(":/gamecontrollerdb_204.txt"),
+        QStringLiteral(":/gamecontrollerdb_205.txt"),
+        QStringLiteral(":/gamecontrollerdb_209.txt"),
+    };
+    const QList<QByteArray> platforms {
+        QByteArrayLiteral("Linux"),
+        QByteArrayLiteral("Windows"),
+        QByteArrayLiteral("Mac OS X"),
+        QByteArrayLiteral("Android"),
+        QByteArrayLiteral("iOS"),
+    };
+    for (const QString& path : files) {
+        for (const QByteArray& platform : platforms) {
+            const QByteArray row_name = path.toLatin1() + ' ' + platform;
+            QTest::newRow(row_name.constData()) << path << platform;
+        }
+    }
+}
+
+void test_GamepadLayoutDb::everyLineFound()
+{
+    QFETCH(QString, path);
+    QFETCH(QByteArray, platform);
+
+    const QByteArray contents = read_file(path);
+    QVERIFY(!contents.isEmpty());
+
+    const model::GamepadLayoutDb db(contents, platform);
+    const std::vector<QByteArray> special = db.specialMappings();
+
+    // the expected result is the last line of the GUID, with the GUID in lower case
+    const QByteArray platform_field = QByteArrayLiteral("platform:") + platform + ',';
+    QList<QByteArray> guid_lines;
+    QHash<QByteArray, QByteArray> last_lines;
+    for (const QByteArray& line : contents.split('\n')) {
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+        if (line.contains("platform:") && !line.contains(platform_field))
+            continue;
+
+        const QByteArray name = line.left(line.indexOf(','));
+        if (name.length() != 32) {
+            QVERIFY2(std::find(special.cbegin(), special.cend(), line) != special.cend(), line.constData());
+            continue;
+        }
+
+        guid_lines.append(line);
+        last_lines[name.toLower()] = name.toLower() + line.mid(name.length());
+    }
+
+    for (const QByteArray& line : qAsConst(guid_lines)) {
+        const QByteArray guid = line.left(32);
+        QCOMPARE(db.find(guid), last_lines.value(guid.toLower()));
+    }
+}
+
+void test_GamepadLayoutDb::caseInsensitive()
+{
+    const model::GamepadLayoutDb db(
+        QByteArrayLiteral("AD1B00000000000001F9000000000000,Upper,a:b0,\n"
+                          "0300000000f000000300000000010000,Lower,a:b1,\n"),
+        QByteArrayLiteral("Linux"));
+
+    QCOMPARE(db.find(QByteArrayLiteral("ad1b00000000000001f9000000000000")),
+             QByteArrayLiteral("ad1b00000000000001f9000000000000,Upper,a:b0,"));
+    QCOMPARE(db.find(QByteArrayLiteral("0300000000F000000300000000010000")),
+             QByteArrayLiteral("0300000000f000000300000000010000,Lower,a:b1,"));
+    QVERIFY(db.find(QByteArrayLiteral("0300000000f000000300000000020000")).isNull());
+}
+
+void test_GamepadLayoutDb::special()
+{
+    const model::GamepadLayoutDb db(
+        QByteArrayLiteral("# comment, with a comma\n"
+                          "xinput,XInput Controller,a:b0,\r\n"
+                          "0300000000f000000300000000010000,Pad,a:b1,\r\n"),
+        QByteArrayLiteral("Windows"));
+
+    const std::vector<QByteArray> special = db.specialMappings();
+    QCOMPARE(special.size(), static_cast<size_t>(1));
+    QCOMPARE(special.front(), QByteArrayLiteral("xinput,XInput Controller,a:b0,"));
+    QCOMPARE(db.find(QByteArrayLiteral("0300000000f000000300000000010000")),
+             QByteArrayLiteral("0300000000f000000300000000010000,Pad,a:b1,"));
+}
+
+void test_GamepadLayoutDb::otherPlatform()
+{
+    const model::GamepadLayoutDb db(
+        QByteArrayLiteral("0300000000f000000300000000010000,Pad,a:b1,platform:Windows,\n"
+                          "xinput,XInput Controller,a:b0,platform:Windows,\n"),
+        QByteArrayLiteral("Linux"));
+
+    QVERIFY(db.find(QByteArrayLiteral("0300000000f000000300000000010000")).isNull());
+    QVERIFY(db.specialMappings().empty());
+}
+
+
+QTEST_MAIN(test_GamepadLayoutDb)
+#include "test_GamepadLayoutDb.moc"
@@ -39,6 +39,7 @@ private slots:
     void json_data();
 
     void settings_file();
+    void delayed_save();
 };
 
 void test_Memory::set_new()
@@ -188,6 +189,38 @@ void test_Memory::settings_file()
     json_file.remove();
 }
 
+void test_Memory::delayed_save()
+{
+    QString temp_path = QDir::tempPath();
+    if (!temp_path.endsWith('/'))
+        temp_path += '/';
+
+    const QString json_path = temp_path + "QtAutoTestC.json";
+    QFile(json_path).remove();
+
+    Container c(temp_path);
+    c.memory()->changeTheme("/path/to/QtAutoTestC/");
+
+    // multiple changes are saved together, later
+    c.memory()->set("a", 1);
+    c.memory()->set("b", 2);
+    QCOMPARE(QFileInfo::exists(json_path), false);
+    QTRY_VERIFY_WITH_TIMEOUT(QFileInfo::exists(json_path), 5000);
+
+    QFile json_file(json_path);
+    QVERIFY(json_file.open(QFile::ReadOnly));
+    QCOMPARE(json_file.readAll(), QByteArrayLiteral(R"({"a":1,"b":2})"));
+    json_file.close();
+
+    // flushing saves immediately
+    c.memory()->unset("a");
+    c.memory()->flush();
+    QVERIFY(json_file.open(QFile::ReadOnly));
+    QCOMPARE(json_file.readAll(), QByteArrayLiteral(R"({"b":2})"));
+
+    json_file.remove();
+}
+
 
 QTEST_MAIN(test_Memory)
 #include "test_Memory.moc"
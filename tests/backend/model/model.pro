@@ -1,11 +1,17 @@
 TEMPLATE = subdirs
 
 SUBDIRS += \
+    assetprefetcher \
     collection \
     game \
     gameassets \
+    gamefacetmodel \
+    gamefiltermodel \
+    gamepadlayoutdb \
+    gamelistmodel \
     locales \
     memory \
+    searchindex \
     system \
     themes \
 
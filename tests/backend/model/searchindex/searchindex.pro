@@ -0,0 +1,4 @@
+TARGET = test_SearchIndex
+SOURCES = $${TARGET}.cpp
+
+include($${TOP_SRCDIR}/tests/cxxtest_common.pri)
@@ -0,0 +1,141 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "model/gaming/Game.h"
+#include "model/gaming/GameListModel.h"
+#include "model/gaming/GameSearchModel.h"
+#include "model/gaming/SearchIndex.h"
+
+
+class test_SearchIndex : public QObject {
+    Q_OBJECT
+
+private:
+    QVector<model::Game*> m_games;
+    std::vector<model::GameRowRef> m_rows;
+
+    QStringList titles(const std::vector<int>& rows) const;
+
+private slots:
+    void initTestCase();
+
+    void exact();
+    void typo();
+    void accents();
+    void otherFields();
+    void shortQuery();
+    void limit();
+    void resultModel();
+};
+
+void test_SearchIndex::initTestCase()
+{
+    for (const char* title : { "Super Mario Bros.", "Mario Kart", "Pokémon Red", "Sonic the Hedgehog", "Tetris" })
+        m_games.append(new model::Game(QString::fromUtf8(title), this));
+
+    m_games[3]->developerList().append("Sega");
+    m_games[4]->genreList().append("Puzzle");
+    m_games[4]->setSummary("A tile-matching game with falling blocks");
+
+    for (const model::Game* const game : qAsConst(m_games))
+        m_rows.push_back(game->rowRef());
+}
+
+QStringList test_SearchIndex::titles(const std::vector<int>& rows) const
+{
+    QStringList out;
+    for (const int row : rows)
+        out << m_games.at(row)->title();
+    return out;
+}
+
+void test_SearchIndex::exact()
+{
+    const model::SearchIndex index(m_rows);
+    QCOMPARE(index.size(), static_cast<size_t>(5));
+
+    // title prefix matches come first
+    QCOMPARE(titles(index.find("mario")), QStringList({ "Mario Kart", "Super Mario Bros." }));
+    QCOMPARE(titles(index.find("HEDGEHOG")), QStringList({ "Sonic the Hedgehog" }));
+    QVERIFY(index.find("zelda").empty());
+    QVERIFY(index.find("  ").empty());
+}
+
+void test_SearchIndex::typo()
+{
+    const model::SearchIndex index(m_rows);
+    QCOMPARE(titles(index.find("hedgehgo")).value(0), QStringLiteral("Sonic the Hedgehog"));
+    QCOMPARE(titles(index.find("mraio kart")).value(0), QStringLiteral("Mario Kart"));
+}
+
+void test_SearchIndex::accents()
+{
+    const model::SearchIndex index(m_rows);
+    QCOMPARE(titles(index.find("pokemon")), QStringList({ QString::fromUtf8("Pokémon Red") }));
+}
+
+void test_SearchIndex::otherFields()
+{
+    const model::SearchIndex index(m_rows);
+    QCOMPARE(titles(index.find("sega")), QStringList({ "Sonic the Hedgehog" }));
+    QCOMPARE(titles(index.find("puzzle")), QStringList({ "Tetris" }));
+    QCOMPARE(titles(index.find("falling blocks")), QStringList({ "Tetris" }));
+}
+
+void test_SearchIndex::shortQuery()
+{
+    const model::SearchIndex index(m_rows);
+    QCOMPARE(titles(index.find("m")), QStringList({ "Mario Kart", "Super Mario Bros." }));
+    QCOMPARE(titles(index.find("te")), QStringList({ "Tetris" }));
+}
+
+void test_SearchIndex::limit()
+{
+    const model::SearchIndex index(m_rows);
+    QCOMPARE(titles(index.find("mario", 1)), QStringList({ "Mario Kart" }));
+}
+
+void test_SearchIndex::resultModel()
+{
+    model::GameListModel source;
+    source.append(m_games);
+
+    model::GameSearchModel results;
+    QSignalSpy spy(&results, &model::GameSearchModel::runningChanged);
+    results.setSourceModel(&source);
+    results.setQuery("mario");
+
+    // start and finish
+    QTRY_COMPARE(spy.count(), 2);
+    QCOMPARE(results.running(), false);
+    QCOMPARE(results.count(), 2);
+    QCOMPARE(results.get(0), static_cast<QObject*>(m_games.at(1)));
+    QCOMPARE(results.data(results.index(1), model::GameListModel::TitleRole).toString(), QStringLiteral("Super Mario Bros."));
+
+    // the index created for the search is kept
+    QVERIFY(source.searchIndex());
+
+    results.setQuery(QString());
+    QTRY_COMPARE(results.count(), 0);
+}
+
+
+QTEST_MAIN(test_SearchIndex)
+#include "test_SearchIndex.moc"
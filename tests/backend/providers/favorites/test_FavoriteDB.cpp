@@ -38,6 +38,49 @@ void create_dummy_data(providers::SearchContext& sctx)
     model::Game& game_c = *sctx.create_game_for(collection_b);
     sctx.game_add_filepath(game_c, QStringLiteral(":/x/y/z/coll2dummy1"));
 }
+
+QString create_tmp_path()
+{
+    QTemporaryFile tmp_file;
+    tmp_file.setAutoRemove(false);
+    if (!tmp_file.open())
+        return QString();
+
+    const QString db_path = tmp_file.fileName();
+    tmp_file.close();
+    return db_path;
+}
+
+QStringList read_lines(const QString& db_path)
+{
+    QFile db_file(db_path);
+    if (!db_file.open(QFile::ReadOnly | QFile::Text))
+        return {};
+
+    QTextStream db_stream(&db_file);
+    QStringList found_items;
+    QString line;
+    while (db_stream.readLineInto(&line)) {
+        if (!line.startsWith('#'))
+            found_items << line;
+    }
+    return found_items;
+}
+
+std::vector<bool> read_favorites(const QString& db_path)
+{
+    providers::SearchContext sctx;
+    create_dummy_data(sctx);
+    providers::favorites::Favorites(db_path).run(sctx);
+    const auto [collections, games] = sctx.finalize(QThread::currentThread());
+
+    std::vector<bool> out;
+    for (const model::Game* const game : games)
+        out.push_back(game->isFavorite());
+    qDeleteAll(games);
+    qDeleteAll(collections);
+    return out;
+}
 } // namespace
 
 
@@ -46,8 +89,10 @@ class test_FavoriteDB : public QObject {
 
 private slots:
     void write();
-    void rewrite_empty();
+    void write_remove();
+    void compaction();
     void read();
+    void read_journal();
 };
 
 
@@ -59,87 +104,90 @@ void test_FavoriteDB::write()
     sctx.game_by_filepath(QStringLiteral(":/x/y/z/coll2dummy1"))->setFavorite(true);
     const auto [collections, games] = sctx.finalize(this->thread());
 
-    QTemporaryFile tmp_file;
-    tmp_file.setAutoRemove(false);
-    QVERIFY(tmp_file.open());
-
-    const QString db_path = tmp_file.fileName();
-    tmp_file.close();
+    const QString db_path = create_tmp_path();
+    QVERIFY(!db_path.isEmpty());
 
+    {
+        providers::favorites::Favorites favorite_db(db_path);
 
-    providers::favorites::Favorites favorite_db(db_path);
-
-    QSignalSpy spy_start(&favorite_db, &providers::favorites::Favorites::startedWriting);
-    QSignalSpy spy_end(&favorite_db, &providers::favorites::Favorites::finishedWriting);
-    QVERIFY(spy_start.isValid());
-    QVERIFY(spy_end.isValid());
-
-    favorite_db.onGameFavoriteChanged(games);
-
-    QVERIFY(spy_start.count() || spy_start.wait());
-    QVERIFY(spy_end.count() || spy_end.wait());
-    QCOMPARE(spy_start.count(), 1);
-    QCOMPARE(spy_end.count(), 1);
+        QSignalSpy spy_start(&favorite_db, &providers::favorites::Favorites::startedWriting);
+        QSignalSpy spy_end(&favorite_db, &providers::favorites::Favorites::finishedWriting);
+        QVERIFY(spy_start.isValid());
+        QVERIFY(spy_end.isValid());
 
+        // only the changed games are written
+        favorite_db.onGameFavoriteChanged(games.at(1));
 
-    QFile db_file(db_path);
-    QVERIFY(db_file.open(QFile::ReadOnly | QFile::Text));
+        QVERIFY(spy_start.count() || spy_start.wait());
+        QVERIFY(spy_end.count() || spy_end.wait());
+        QCOMPARE(spy_start.count(), 1);
+        QCOMPARE(spy_end.count(), 1);
 
-    QTextStream db_stream(&db_file);
-    QStringList found_items;
-    QString line;
-    while (db_stream.readLineInto(&line)) {
-        if (!line.startsWith('#'))
-            found_items << line;
+        favorite_db.onGameFavoriteChanged(games.at(2));
     }
-    QFile::remove(db_path);
 
-    QCOMPARE(found_items.count(), 2);
-    QVERIFY(found_items.contains(":/coll1dummy2"));
-    QVERIFY(found_items.contains(":/x/y/z/coll2dummy1"));
+    const QStringList found_items = read_lines(db_path);
+    QFile::remove(db_path);
 
+    QCOMPARE(found_items, QStringList({ "+:/coll1dummy2", "+:/x/y/z/coll2dummy1" }));
 }
 
-void test_FavoriteDB::rewrite_empty()
+void test_FavoriteDB::write_remove()
 {
     providers::SearchContext sctx;
     create_dummy_data(sctx);
     const auto [collections, games] = sctx.finalize(this->thread());
 
-    QTemporaryFile tmp_file;
-    tmp_file.setAutoRemove(false);
-    QVERIFY(tmp_file.open());
+    const QString db_path = create_tmp_path();
+    QVERIFY(!db_path.isEmpty());
 
-    const QString db_path = tmp_file.fileName();
-    tmp_file.close();
+    {
+        providers::favorites::Favorites favorite_db(db_path);
 
+        games.at(1)->setFavorite(true);
+        favorite_db.onGameFavoriteChanged(games.at(1));
 
-    providers::favorites::Favorites favorite_db(db_path);
-    QSignalSpy spy_end(&favorite_db, &providers::favorites::Favorites::finishedWriting);
-    QVERIFY(spy_end.isValid());
+        games.at(1)->setFavorite(false);
+        favorite_db.onGameFavoriteChanged(games.at(1));
+    }
 
-    games.at(1)->setFavorite(true);
-    favorite_db.onGameFavoriteChanged(games);
+    const QStringList found_items = read_lines(db_path);
+    const std::vector<bool> favorites = read_favorites(db_path);
+    QFile::remove(db_path);
 
-    games.at(1)->setFavorite(false);
-    favorite_db.onGameFavoriteChanged(games);
+    QCOMPARE(found_items, QStringList({ "+:/coll1dummy2", "-:/coll1dummy2" }));
+    QCOMPARE(favorites, std::vector<bool>({ false, false, false }));
+}
 
-    QVERIFY(spy_end.count() == 2 || spy_end.wait());
+void test_FavoriteDB::compaction()
+{
+    providers::SearchContext sctx;
+    create_dummy_data(sctx);
+    const auto [collections, games] = sctx.finalize(this->thread());
 
+    const QString db_path = create_tmp_path();
+    QVERIFY(!db_path.isEmpty());
 
-    QFile db_file(db_path);
-    QVERIFY(db_file.open(QFile::ReadOnly | QFile::Text));
+    constexpr int TOGGLE_CNT = 1001;
+    {
+        providers::favorites::Favorites favorite_db(db_path);
 
-    QTextStream db_stream(&db_file);
-    QStringList found_items;
-    QString line;
-    while (db_stream.readLineInto(&line)) {
-        if (!line.startsWith('#'))
-            found_items << line;
+        games.at(0)->setFavorite(true);
+        favorite_db.onGameFavoriteChanged(games.at(0));
+
+        for (int i = 0; i < TOGGLE_CNT; i++) {
+            games.at(2)->setFavorite(!games.at(2)->isFavorite());
+            favorite_db.onGameFavoriteChanged(games.at(2));
+        }
     }
+
+    const QStringList found_items = read_lines(db_path);
+    const std::vector<bool> favorites = read_favorites(db_path);
     QFile::remove(db_path);
 
-    QCOMPARE(found_items.count(), 0);
+    // without compaction, there would be one record for every change
+    QVERIFY(found_items.count() < TOGGLE_CNT / 3);
+    QCOMPARE(favorites, std::vector<bool>({ true, false, true }));
 }
 
 void test_FavoriteDB::read()
@@ -169,6 +217,28 @@ void test_FavoriteDB::read()
     QCOMPARE(games[2]->isFavorite(), true);
 }
 
+void test_FavoriteDB::read_journal()
+{
+    QTemporaryFile tmp_file;
+    tmp_file.setAutoRemove(false);
+    QVERIFY(tmp_file.open());
+    {
+        QTextStream tmp_stream(&tmp_file);
+        tmp_stream << QStringLiteral("# Favorite reader test") << endl;
+        tmp_stream << QStringLiteral("+:/x/y/z/coll2dummy1") << endl;
+        tmp_stream << QStringLiteral("+:/coll1dummy2") << endl;
+        tmp_stream << QStringLiteral("-:/x/y/z/coll2dummy1") << endl;
+        tmp_stream << QStringLiteral("-:/somethingfake") << endl;
+    }
+    const QString db_path = tmp_file.fileName();
+    tmp_file.close();
+
+    const std::vector<bool> favorites = read_favorites(db_path);
+    QFile::remove(db_path);
+
+    QCOMPARE(favorites, std::vector<bool>({ false, true, false }));
+}
+
 
 QTEST_MAIN(test_FavoriteDB)
 #include "test_FavoriteDB.moc"
@@ -48,8 +48,10 @@ class test_Playtime : public QObject {
 
 private slots:
     void read();
+    void read_upgraded();
     void write();
     void write_queue();
+    void write_read();
 };
 
 void test_Playtime::read()
@@ -73,6 +75,40 @@ void test_Playtime::read()
     QCOMPARE(game.property("lastPlayed").toDateTime(), QDateTime::fromSecsSinceEpoch(1531755039));
 }
 
+void test_Playtime::read_upgraded()
+{
+    const QString db_path = QDir::tempPath() + QStringLiteral("/data_upgraded.db");
+    QFile::remove(db_path);
+    QFile::copy(QStringLiteral(":/data.db"), db_path);
+    QFile::setPermissions(db_path, QFile::ReadOwner | QFile::WriteOwner);
+
+    // the first run upgrades the database, the second reads the summary table
+    for (int i = 0; i < 2; i++) {
+        providers::SearchContext sctx;
+        create_dummy_data(sctx);
+        providers::playtime::PlaytimeStats(db_path).run(sctx);
+        const auto [collections, games] = sctx.finalize(this);
+
+        const auto it = std::find_if(games.cbegin(), games.cend(),
+            [](const model::Game* const game){ return game->title() == QLatin1String("dummy1"); });
+        QVERIFY(it != games.cend());
+        const model::Game& game = **it;
+
+        QCOMPARE(game.property("playCount").toInt(), 4);
+        QCOMPARE(game.property("playTime").toInt(), 35 /*sec*/);
+        QCOMPARE(game.property("lastPlayed").toDateTime(), QDateTime::fromSecsSinceEpoch(1531755039));
+    }
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("check"));
+        db.setDatabaseName(db_path);
+        QVERIFY(db.open());
+        QVERIFY(db.tables().contains(QStringLiteral("path_stats")));
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(QStringLiteral("check"));
+}
+
 void test_Playtime::write()
 {
     QTemporaryFile db_file;
@@ -134,6 +170,40 @@ void test_Playtime::write_queue()
 #endif
 }
 
+void test_Playtime::write_read()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    const QString db_path = tmp_dir.filePath(QStringLiteral("stats.db"));
+    const QString rom_path = tmp_dir.filePath(QStringLiteral("game.rom"));
+    QVERIFY(QFile(rom_path).open(QIODevice::WriteOnly));
+
+    const auto create_game = [&rom_path](providers::SearchContext& sctx){
+        model::Collection& collection = *sctx.get_or_create_collection(QStringLiteral("coll"));
+        model::Game& game = *sctx.create_game_for(collection);
+        sctx.game_add_filepath(game, rom_path);
+    };
+
+    {
+        providers::SearchContext sctx;
+        create_game(sctx);
+        const auto [collections, games] = sctx.finalize(this);
+
+        // the pending writes are finished on destruction
+        providers::playtime::PlaytimeStats playtime(db_path);
+        for (int i = 0; i < 2; i++) {
+            playtime.onGameLaunched(games.at(0)->filesConst().first());
+            playtime.onGameFinished(games.at(0)->filesConst().first());
+        }
+    }
+
+    providers::SearchContext sctx;
+    create_game(sctx);
+    providers::playtime::PlaytimeStats(db_path).run(sctx);
+    const auto [collections, games] = sctx.finalize(this);
+
+    QCOMPARE(games.at(0)->property("playCount").toInt(), 2);
+}
 
 QTEST_MAIN(test_Playtime)
 #include "test_Playtime.moc"
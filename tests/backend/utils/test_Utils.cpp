@@ -17,10 +17,16 @@
 
 #include <QtTest/QtTest>
 
+#include "utils/Bitset.h"
 #include "utils/CommandTokenizer.h"
+#include "utils/IoHints.h"
+#include "utils/MpscRingBuffer.h"
 #include "utils/PathCheck.h"
 #include "utils/StdStringHelpers.h"
 
+#include <thread>
+#include <vector>
+
 
 class test_Utils : public QObject
 {
@@ -38,6 +44,12 @@ private slots:
 
     void trimmed_str();
     void trimmed_str_data();
+
+    void bitset();
+    void ring_buffer();
+    void ring_buffer_threads();
+
+    void prefetch_file();
 };
 
 void test_Utils::validExtPath_data()
@@ -127,6 +139,113 @@ void test_Utils::trimmed_str_data()
     QTest::newRow("none") << "test" << "test";
 }
 
+void test_Utils::bitset()
+{
+    utils::Bitset a(130);
+    QCOMPARE(a.size(), static_cast<size_t>(130));
+    QCOMPARE(a.count(), static_cast<size_t>(0));
+
+    a.set(0);
+    a.set(64);
+    a.set(129);
+    QVERIFY(a.test(64));
+    QVERIFY(!a.test(65));
+    QCOMPARE(a.count(), static_cast<size_t>(3));
+
+    // the bits past the size are not counted
+    utils::Bitset b(130, true);
+    QCOMPARE(b.count(), static_cast<size_t>(130));
+    QCOMPARE(utils::Bitset::count_and(a, b), static_cast<size_t>(3));
+
+    b.set(64, false);
+    QCOMPARE(utils::Bitset::count_and(a, b), static_cast<size_t>(2));
+    b &= a;
+    QCOMPARE(b.count(), static_cast<size_t>(2));
+    b |= a;
+    QVERIFY(b == a);
+
+    b.fill(false);
+    QCOMPARE(b.count(), static_cast<size_t>(0));
+}
+
+void test_Utils::ring_buffer()
+{
+    utils::MpscRingBuffer<QString> queue(4);
+    QVERIFY(queue.empty());
+
+    QString value;
+    QVERIFY(!queue.try_pop(value));
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 4; i++) {
+            QString item = QString::number(i);
+            QVERIFY(queue.try_push(item));
+        }
+        QString extra = QStringLiteral("extra");
+        QVERIFY(!queue.try_push(extra));
+        QCOMPARE(extra, QStringLiteral("extra"));
+
+        for (int i = 0; i < 4; i++) {
+            QVERIFY(queue.try_pop(value));
+            QCOMPARE(value, QString::number(i));
+        }
+        QVERIFY(queue.empty());
+    }
+}
+
+void test_Utils::ring_buffer_threads()
+{
+    constexpr int PRODUCER_CNT = 4;
+    constexpr int ITEM_CNT = 10000;
+    utils::MpscRingBuffer<int> queue(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCER_CNT; p++) {
+        producers.emplace_back([&queue, p]{
+            for (int i = 0; i < ITEM_CNT; i++) {
+                int item = p * ITEM_CNT + i;
+                while (!queue.try_push(item))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // every item arrives once, and the items of a producer stay in order
+    std::vector<int> last_seen(PRODUCER_CNT, -1);
+    bool ordered = true;
+    int received = 0;
+    while (received < PRODUCER_CNT * ITEM_CNT) {
+        int item = 0;
+        if (!queue.try_pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const int producer = item / ITEM_CNT;
+        ordered &= last_seen[producer] < item % ITEM_CNT;
+        last_seen[producer] = item % ITEM_CNT;
+        received++;
+    }
+
+    for (std::thread& producer : producers)
+        producer.join();
+
+    QVERIFY(ordered);
+    QVERIFY(queue.empty());
+}
+
+void test_Utils::prefetch_file()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(QByteArray(1024 * 1024, 'x'));
+    file.flush();
+
+    QVERIFY(utils::prefetch_file(file.fileName()));
+    QVERIFY(utils::prefetch_file(file.fileName(), 4096));
+    QVERIFY(!utils::prefetch_file(file.fileName() + QStringLiteral(".missing")));
+}
+
 
 QTEST_MAIN(test_Utils)
 #include "test_Utils.moc"
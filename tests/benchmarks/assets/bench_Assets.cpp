@@ -0,0 +1,128 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest/QtTest>
+
+#include "model/gaming/Assets.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+
+namespace {
+constexpr int GAME_CNT = 50000;
+
+constexpr std::array<AssetType, 7> ASSET_TYPES {
+    AssetType::BOX_FRONT,
+    AssetType::BOX_BACK,
+    AssetType::LOGO,
+    AssetType::ARCADE_MARQUEE,
+    AssetType::SCREENSHOT,
+    AssetType::SCREENSHOT,
+    AssetType::VIDEO,
+};
+
+std::vector<QString> create_paths()
+{
+    std::vector<QString> out;
+    out.reserve(GAME_CNT * ASSET_TYPES.size());
+    for (int game = 0; game < GAME_CNT; game++) {
+        for (size_t i = 0; i < ASSET_TYPES.size(); i++) {
+            out.emplace_back(QStringLiteral("/home/user/games/some system/media/Game Title %1/asset %2.png")
+                .arg(QString::number(game), QString::number(i)));
+        }
+    }
+    return out;
+}
+
+std::vector<std::unique_ptr<model::Assets>> fill_assets(const std::vector<QString>& paths)
+{
+    std::vector<std::unique_ptr<model::Assets>> out;
+    out.reserve(GAME_CNT);
+    for (int game = 0; game < GAME_CNT; game++) {
+        out.emplace_back(new model::Assets(nullptr));
+        for (size_t i = 0; i < ASSET_TYPES.size(); i++)
+            out.back()->add_file(ASSET_TYPES[i], paths[game * ASSET_TYPES.size() + i]);
+    }
+    return out;
+}
+
+size_t heap_in_use()
+{
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#endif
+#endif
+    return 0;
+}
+} // namespace
+
+
+class bench_Assets : public QObject {
+    Q_OBJECT
+
+private slots:
+    void scan();
+    void scan_memory();
+    void first_read();
+};
+
+void bench_Assets::scan()
+{
+    const std::vector<QString> paths = create_paths();
+
+    QBENCHMARK {
+        fill_assets(paths);
+    }
+}
+
+void bench_Assets::scan_memory()
+{
+    if (heap_in_use() == 0)
+        QSKIP("Heap statistics are not available on this platform");
+
+    const std::vector<QString> paths = create_paths();
+
+    const size_t heap_before = heap_in_use();
+    const auto assets = fill_assets(paths);
+    const size_t heap_after = heap_in_use();
+
+    QTest::setBenchmarkResult(heap_after - heap_before, QTest::BytesAllocated);
+}
+
+void bench_Assets::first_read()
+{
+    const std::vector<QString> paths = create_paths();
+
+    QBENCHMARK_ONCE {
+        const auto assets = fill_assets(paths);
+        for (const auto& asset_ptr : assets) {
+            asset_ptr->property("boxFront");
+            asset_ptr->property("screenshotList");
+        }
+    }
+}
+
+
+QTEST_MAIN(bench_Assets)
+#include "bench_Assets.moc"
@@ -1,5 +1,10 @@
 TEMPLATE = subdirs
 
 SUBDIRS += \
+    assets \
+    blurhash \
     configfile \
+    gamefilter \
     pegasus_provider \
+    playtime \
+    search \
@@ -0,0 +1,78 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest/QtTest>
+
+#include "imggen/BlurhashProvider.h"
+
+
+namespace {
+const QString HASH = QStringLiteral("LEHV6nWB2yk8pyoJadR*.7kCMdnj");
+} // namespace
+
+
+class bench_Blurhash : public QObject {
+    Q_OBJECT
+
+private slots:
+    void decode();
+    void decode_data();
+    void cached();
+    void cached_data();
+};
+
+void bench_Blurhash::decode_data()
+{
+    QTest::addColumn<QSize>("size");
+
+    QTest::newRow("24x24") << QSize(24, 24);
+    QTest::newRow("320x240") << QSize(320, 240);
+    QTest::newRow("1280x720") << QSize(1280, 720);
+}
+
+void bench_Blurhash::decode()
+{
+    QFETCH(QSize, size);
+
+    // no caching
+    BlurhashProvider provider(0);
+
+    QBENCHMARK {
+        provider.requestImage(HASH, nullptr, size);
+    }
+}
+
+void bench_Blurhash::cached_data()
+{
+    decode_data();
+}
+
+void bench_Blurhash::cached()
+{
+    QFETCH(QSize, size);
+
+    BlurhashProvider provider;
+    QVERIFY(!provider.requestImage(HASH, nullptr, size).isNull());
+
+    QBENCHMARK {
+        provider.requestImage(HASH, nullptr, size);
+    }
+}
+
+
+QTEST_MAIN(bench_Blurhash)
+#include "bench_Blurhash.moc"
@@ -0,0 +1,108 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "model/gaming/Game.h"
+#include "model/gaming/GameFilterModel.h"
+#include "model/gaming/GameListModel.h"
+#include "model/gaming/GameStore.h"
+
+
+namespace {
+constexpr int GAME_CNT = 50000;
+} // namespace
+
+
+class bench_GameFilter : public QObject {
+    Q_OBJECT
+
+private:
+    model::GameListModel* m_source = nullptr;
+
+private slots:
+    void initTestCase();
+
+    void title_typing();
+    void genre_toggle();
+    void sort_switch();
+};
+
+void bench_GameFilter::initTestCase()
+{
+    const auto store = std::make_shared<model::GameStore>();
+    store->reserve(GAME_CNT);
+
+    QVector<model::Game*> games;
+    games.reserve(GAME_CNT);
+    for (int i = 0; i < GAME_CNT; i++) {
+        auto* const game = new model::Game(store, this);
+        game->setTitle(QStringLiteral("Some Game Title %1").arg(i))
+            .setReleaseDate(QDate(1980 + i % 40, 1, 1))
+            .setPlayerCount(1 + i % 4)
+            .setRating((i % 100) / 100.f);
+        game->genreList().append(i % 3 ? QStringLiteral("Action") : QStringLiteral("Puzzle"));
+        games.append(game);
+    }
+
+    m_source = new model::GameListModel(this);
+    m_source->append(std::move(games));
+}
+
+void bench_GameFilter::title_typing()
+{
+    model::GameFilterModel model;
+    model.setSourceModel(m_source);
+
+    const QString query = QStringLiteral("title 123");
+    QBENCHMARK {
+        for (int len = 1; len <= query.length(); len++)
+            model.setTitleFilter(query.left(len));
+        model.setTitleFilter(QString());
+    }
+}
+
+void bench_GameFilter::genre_toggle()
+{
+    model::GameFilterModel model;
+    model.setSourceModel(m_source);
+    model.setTitleFilter(QStringLiteral("1"));
+
+    QBENCHMARK {
+        model.setGenreFilter(QStringLiteral("puzzle"));
+        model.setGenreFilter(QString());
+    }
+}
+
+void bench_GameFilter::sort_switch()
+{
+    model::GameFilterModel model;
+    model.setSourceModel(m_source);
+    model.setMinPlayers(2);
+
+    // the first round calculates the orders, the rest should reuse them
+    QBENCHMARK {
+        model.setSortKey(model::GameFilterModel::SortByTitle);
+        model.setSortKey(model::GameFilterModel::SortByRelease);
+        model.setSortKey(model::GameFilterModel::SortByRating);
+    }
+}
+
+
+QTEST_MAIN(bench_GameFilter)
+#include "bench_GameFilter.moc"
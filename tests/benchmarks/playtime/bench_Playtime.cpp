@@ -0,0 +1,154 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "model/gaming/Collection.h"
+#include "model/gaming/Game.h"
+#include "providers/SearchContext.h"
+#include "providers/pegasus_playtime/PlaytimeStats.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+
+namespace {
+constexpr int PATH_CNT = 1000;
+// about 10 years of plays, from the start of 2012
+constexpr qint64 FIRST_PLAY_EPOCH = 1325376000;
+constexpr qint64 PLAY_INTERVAL_SECS = 300;
+
+QString rom_path(int idx)
+{
+    return QStringLiteral("/roms/game%1.bin").arg(idx);
+}
+
+// Creates a database with the original schema and the given amount of plays
+bool create_synthetic_db(const QString& db_path, int play_count)
+{
+    QFile::remove(db_path);
+
+    bool success = true;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("synthetic"));
+        db.setDatabaseName(db_path);
+        success = db.open() && db.transaction();
+
+        QSqlQuery query(db);
+        success = success
+            && query.exec(QStringLiteral(
+                "CREATE TABLE paths(id INTEGER PRIMARY KEY, path TEXT UNIQUE NOT NULL);"))
+            && query.exec(QStringLiteral(
+                "CREATE TABLE plays(id INTEGER PRIMARY KEY, path_id INTEGER NOT NULL REFERENCES plays(id),"
+                " start_time INTEGER NOT NULL, duration INTEGER NOT NULL);"));
+
+        query.prepare(QStringLiteral("INSERT INTO paths VALUES(?, ?);"));
+        for (int i = 0; success && i < PATH_CNT; i++) {
+            query.addBindValue(i + 1);
+            query.addBindValue(rom_path(i));
+            success = query.exec();
+        }
+
+        query.prepare(QStringLiteral(
+            "WITH RECURSIVE seq(n) AS (SELECT 0 UNION ALL SELECT n + 1 FROM seq WHERE n + 1 < ?)"
+            " INSERT INTO plays"
+            " SELECT null, 1 + (n * 7919) % ?, ? + n * ?, 60 + (n * 31) % 3600 FROM seq;"));
+        query.addBindValue(play_count);
+        query.addBindValue(PATH_CNT);
+        query.addBindValue(FIRST_PLAY_EPOCH);
+        query.addBindValue(PLAY_INTERVAL_SECS);
+        success = success && query.exec() && db.commit();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(QStringLiteral("synthetic"));
+    return success;
+}
+
+void load_stats(const QString& db_path, QObject* parent)
+{
+    providers::SearchContext sctx;
+    model::Collection& collection = *sctx.get_or_create_collection(QStringLiteral("coll"));
+    for (int i = 0; i < PATH_CNT; i++) {
+        model::Game& game = *sctx.create_game_for(collection);
+        sctx.game_add_filepath(game, rom_path(i));
+    }
+
+    providers::playtime::PlaytimeStats(db_path).run(sctx);
+    const auto result = sctx.finalize(parent);
+    qDeleteAll(result.first);
+    qDeleteAll(result.second);
+}
+} // namespace
+
+
+class bench_Playtime : public QObject {
+    Q_OBJECT
+
+private:
+    QTemporaryDir m_tmpdir;
+
+private slots:
+    void upgrade_data();
+    void upgrade();
+    void load_data();
+    void load();
+};
+
+void bench_Playtime::upgrade_data()
+{
+    QTest::addColumn<int>("play_count");
+
+    QTest::newRow("10k plays") << 10000;
+    QTest::newRow("100k plays") << 100000;
+    QTest::newRow("1M plays") << 1000000;
+}
+
+void bench_Playtime::upgrade()
+{
+    // the one-time cost of creating the index and summary of an old database
+    QFETCH(int, play_count);
+    const QString db_path = m_tmpdir.filePath(QStringLiteral("upgrade.db"));
+
+    QVERIFY(create_synthetic_db(db_path, play_count));
+
+    QBENCHMARK_ONCE {
+        load_stats(db_path, this);
+    }
+}
+
+void bench_Playtime::load_data()
+{
+    upgrade_data();
+}
+
+void bench_Playtime::load()
+{
+    // the regular startup cost, which should not depend on the number of plays
+    QFETCH(int, play_count);
+    const QString db_path = m_tmpdir.filePath(QStringLiteral("load.db"));
+    QVERIFY(create_synthetic_db(db_path, play_count));
+    load_stats(db_path, this);
+
+    QBENCHMARK {
+        load_stats(db_path, this);
+    }
+}
+
+
+QTEST_MAIN(bench_Playtime)
+#include "bench_Playtime.moc"
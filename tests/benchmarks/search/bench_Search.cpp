@@ -0,0 +1,115 @@
+// Pegasus Frontend
+// Copyright (C) 2017-2021  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "model/gaming/Game.h"
+#include "model/gaming/GameStore.h"
+#include "model/gaming/SearchIndex.h"
+
+#include <array>
+#include <memory>
+
+
+namespace {
+constexpr int GAME_CNT = 100000;
+
+const std::array<const char*, 8> WORDS {{
+    "super", "world", "legend", "fighter", "racing", "quest", "dragon", "puzzle",
+}};
+
+QVector<model::Game*> create_games(QObject* parent)
+{
+    const auto store = std::make_shared<model::GameStore>();
+    store->reserve(GAME_CNT);
+
+    QVector<model::Game*> out;
+    out.reserve(GAME_CNT);
+    for (int i = 0; i < GAME_CNT; i++) {
+        auto* const game = new model::Game(store, parent);
+        game->setTitle(QStringLiteral("%1 %2 %3")
+            .arg(QLatin1String(WORDS[i % WORDS.size()]))
+            .arg(QLatin1String(WORDS[(i / 8) % WORDS.size()]))
+            .arg(i));
+        game->developerList().append(QStringLiteral("Developer %1").arg(i % 500));
+        game->genreList().append(QLatin1String(WORDS[(i / 64) % WORDS.size()]));
+        game->setSummary(QStringLiteral("A short description of game number %1, with some filler text.").arg(i));
+        out.append(game);
+    }
+    return out;
+}
+} // namespace
+
+
+class bench_Search : public QObject {
+    Q_OBJECT
+
+private:
+    QVector<model::Game*> m_games;
+    std::vector<model::GameRowRef> m_rows;
+
+private slots:
+    void initTestCase();
+
+    void build();
+    void query_exact();
+    void query_typo();
+    void query_short();
+};
+
+void bench_Search::initTestCase()
+{
+    m_games = create_games(this);
+    for (const model::Game* const game : qAsConst(m_games))
+        m_rows.push_back(game->rowRef());
+}
+
+void bench_Search::build()
+{
+    QBENCHMARK {
+        model::SearchIndex index(m_rows);
+    }
+}
+
+void bench_Search::query_exact()
+{
+    const model::SearchIndex index(m_rows);
+    QBENCHMARK {
+        index.find(QStringLiteral("dragon quest 4242"));
+    }
+}
+
+void bench_Search::query_typo()
+{
+    const model::SearchIndex index(m_rows);
+    QBENCHMARK {
+        index.find(QStringLiteral("legnd fihgter"), 100);
+    }
+}
+
+void bench_Search::query_short()
+{
+    const model::SearchIndex index(m_rows);
+    QBENCHMARK {
+        index.find(QStringLiteral("wo"), 100);
+    }
+}
+
+
+QTEST_MAIN(bench_Search)
+#include "bench_Search.moc"